@@ -1,4 +1,6 @@
 #include "lob/order_book.hpp"
+#include "lob/pipeline.hpp"
+#include "lob/telemetry.hpp"
 #include <iostream>
 #include <iomanip>
 #include <chrono>
@@ -7,6 +9,8 @@
 #include <random>
 #include <numeric>
 #include <cmath>
+#include <string>
+#include <thread>
 
 using namespace lob;
 using Clock = std::chrono::high_resolution_clock;
@@ -64,10 +68,24 @@ void print_separator() {
     std::cout << std::string(130, '-') << "\n";
 }
 
+// Book for a benchmark run; ladder band covers every price the scenarios use
+BookConfig make_config(std::size_t capacity, LevelStorage storage) {
+    BookConfig config;
+    config.pool.capacity = capacity;
+    config.level_storage = storage;
+    config.ladder = LadderRange{9000, 11000, 1};
+    config.warm_up = true;  // keep page faults out of the measured loops
+    return config;
+}
+
+std::string label(const std::string& name, LevelStorage storage) {
+    return storage == LevelStorage::Ladder ? name + " [ladder]" : name;
+}
+
 // --- Benchmarks ---
 
-void bench_add_limit_orders(std::size_t n) {
-    OrderBook book(n + 1000);
+void bench_add_limit_orders(std::size_t n, LevelStorage storage) {
+    OrderBook book(make_config(n + 1000, storage));
     std::mt19937 rng(42);
     std::uniform_int_distribution<Price> price_dist(9000, 11000);  // $90.00 - $110.00
     std::uniform_int_distribution<Quantity> qty_dist(1, 1000);
@@ -92,12 +110,12 @@ void bench_add_limit_orders(std::size_t n) {
         );
     }
 
-    auto stats = compute_stats("Add (no match)", latencies);
+    auto stats = compute_stats(label("Add (no match)", storage), latencies);
     print_stats(stats);
 }
 
-void bench_cancel_orders(std::size_t n) {
-    OrderBook book(n + 1000);
+void bench_cancel_orders(std::size_t n, LevelStorage storage) {
+    OrderBook book(make_config(n + 1000, storage));
     std::mt19937 rng(42);
     std::uniform_int_distribution<Price> price_dist(9000, 11000);
     std::uniform_int_distribution<Quantity> qty_dist(1, 1000);
@@ -130,12 +148,12 @@ void bench_cancel_orders(std::size_t n) {
         );
     }
 
-    auto stats = compute_stats("Cancel", latencies);
+    auto stats = compute_stats(label("Cancel", storage), latencies);
     print_stats(stats);
 }
 
-void bench_matching(std::size_t n) {
-    OrderBook book(n * 2 + 1000);
+void bench_matching(std::size_t n, LevelStorage storage) {
+    OrderBook book(make_config(n * 2 + 1000, storage));
     std::mt19937 rng(42);
     std::uniform_int_distribution<Quantity> qty_dist(1, 100);
 
@@ -164,13 +182,13 @@ void bench_matching(std::size_t n) {
         );
     }
 
-    auto stats = compute_stats("Match (aggressive buy)", latencies);
+    auto stats = compute_stats(label("Match (aggressive buy)", storage), latencies);
     print_stats(stats);
 }
 
-void bench_mixed_workload(std::size_t n) {
+void bench_mixed_workload(std::size_t n, LevelStorage storage) {
     // Realistic workload: ~60% add, ~30% cancel, ~10% aggressive match
-    OrderBook book(n * 2 + 1000);
+    OrderBook book(make_config(n * 2 + 1000, storage));
     std::mt19937 rng(42);
     std::uniform_int_distribution<int> action_dist(0, 99);
     std::uniform_int_distribution<Price> price_dist(9900, 10100);
@@ -217,10 +235,151 @@ void bench_mixed_workload(std::size_t n) {
         );
     }
 
-    auto stats = compute_stats("Mixed workload", latencies);
+    auto stats = compute_stats(label("Mixed workload", storage), latencies);
+    print_stats(stats);
+}
+
+void bench_mixed_packets(std::size_t n, LevelStorage storage) {
+    // Same mix as bench_mixed_workload, delivered as gateway packets: each
+    // packet's adds go through one add_orders call and its cancels through
+    // one cancel_orders call. Latency is per packet.
+    constexpr std::size_t PACKET = 32;
+    OrderBook book(make_config(n * 2 + 1000, storage));
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> action_dist(0, 99);
+    std::uniform_int_distribution<Price> price_dist(9900, 10100);
+    std::uniform_int_distribution<Quantity> qty_dist(1, 500);
+
+    std::vector<OrderId> active_ids;
+    active_ids.reserve(n);
+    std::vector<OrderRequest> requests;
+    std::vector<OrderAck> acks(PACKET);
+    std::vector<OrderId> cancels;
+    std::vector<Trade> trade_storage(PACKET * 64);
+    TradeBuffer trades(trade_storage.data(), trade_storage.size());
+
+    std::vector<double> latencies;
+    latencies.reserve(n / PACKET);
+
+    for (std::size_t sent = 0; sent < n; sent += PACKET) {
+        requests.clear();
+        cancels.clear();
+        for (std::size_t m = 0; m < PACKET; ++m) {
+            int action = action_dist(rng);
+            Side side = (rng() % 2 == 0) ? Side::Buy : Side::Sell;
+            if (action < 60 || active_ids.empty()) {
+                Price price = price_dist(rng);
+                if (side == Side::Buy) price = std::min(price, Price(9999));
+                else price = std::max(price, Price(10001));
+                requests.push_back({side, OrderType::Limit, price, qty_dist(rng)});
+            } else if (action < 90) {
+                std::uniform_int_distribution<std::size_t> idx_dist(0, active_ids.size() - 1);
+                std::size_t idx = idx_dist(rng);
+                cancels.push_back(active_ids[idx]);
+                active_ids[idx] = active_ids.back();
+                active_ids.pop_back();
+            } else {
+                Price price = (side == Side::Buy) ? Price(10100) : Price(9900);
+                requests.push_back({side, OrderType::Limit, price, qty_dist(rng)});
+            }
+        }
+        trades.clear();
+
+        auto start = Clock::now();
+        book.add_orders(requests.data(), requests.size(), acks.data(), trades);
+        book.cancel_orders(cancels.data(), cancels.size());
+        auto end = Clock::now();
+        latencies.push_back(
+            static_cast<double>(std::chrono::duration_cast<Nanoseconds>(end - start).count())
+        );
+
+        for (std::size_t k = 0; k < requests.size(); ++k) {
+            if (acks[k].status == OrderStatus::Active) active_ids.push_back(acks[k].order_id);
+        }
+    }
+
+    auto stats = compute_stats(label("Mixed packets (32 msg)", storage), latencies);
     print_stats(stats);
 }
 
+void bench_pipeline_round_trip(std::size_t n, LevelStorage storage) {
+    // Add-then-cancel of a resting order, timed as a direct call and as a
+    // submit -> ack round trip through the matching thread
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<Price> price_dist(9000, 9999);
+    std::vector<Price> prices(n);
+    for (Price& p : prices) p = price_dist(rng);
+
+    std::vector<double> direct;
+    direct.reserve(n);
+    {
+        OrderBook book(make_config(1000, storage));
+        std::vector<Trade> storage_trades(16);
+        TradeBuffer trades(storage_trades.data(), storage_trades.size());
+        for (std::size_t i = 0; i < n; ++i) {
+            auto start = Clock::now();
+            OrderAck ack = book.add_order(Side::Buy, OrderType::Limit, prices[i], 100, trades);
+            book.cancel_order(ack.order_id);
+            auto end = Clock::now();
+            direct.push_back(static_cast<double>(
+                std::chrono::duration_cast<Nanoseconds>(end - start).count()));
+        }
+    }
+    print_stats(compute_stats(label("Direct add+cancel", storage), direct));
+
+    // Two spinning threads on one core would just fight for it
+    bool multicore = std::thread::hardware_concurrency() > 1;
+    PipelineConfig config;
+    config.core = multicore ? 1 : -1;
+    config.yield_when_idle = !multicore;
+    BookPipeline pipeline(make_config(1000, storage), config);
+    pipeline.start();
+    if (multicore) pin_current_thread(0);
+
+    std::vector<double> round_trip;
+    round_trip.reserve(n);
+    EgressEvent event;
+    auto await_ack = [&] {
+        for (;;) {
+            if (pipeline.poll(event)) {
+                if (event.type == EgressType::Ack) return event.ack;
+            } else if (!multicore) {
+                std::this_thread::yield();
+            }
+        }
+    };
+    for (std::size_t i = 0; i < n; ++i) {
+        auto start = Clock::now();
+        pipeline.submit(OrderCommand::add(i, Side::Buy, OrderType::Limit, prices[i], 100));
+        CommandAck ack = await_ack();
+        pipeline.submit(OrderCommand::cancel(i, ack.order_id));
+        await_ack();
+        auto end = Clock::now();
+        round_trip.push_back(static_cast<double>(
+            std::chrono::duration_cast<Nanoseconds>(end - start).count()));
+    }
+    pipeline.stop();
+    print_stats(compute_stats(label("Pipeline add+cancel", storage), round_trip));
+}
+
+// Per-stage probe histograms summed over every thread (LOB_ENABLE_PROBES builds)
+void print_probes() {
+    ProbeSet total;
+    collect_probes(total);
+    double ns = tsc_ns_per_tick();
+    std::cout << "In-book probes (TSC, inclusive of nested stages):\n";
+    for (std::size_t i = 0; i < PROBE_STAGE_COUNT; ++i) {
+        const LatencyHistogram& h = total.stages[i];
+        auto at = [&](double q) { return static_cast<double>(h.percentile(q)) * ns; };
+        std::cout << std::fixed << std::setprecision(0) << "  " << std::left << std::setw(25)
+                  << probe_stage_name(static_cast<ProbeStage>(i)) << " n=" << std::setw(10)
+                  << h.count() << " p50=" << std::setw(8) << at(0.50) << "ns"
+                  << " p99=" << std::setw(8) << at(0.99) << "ns"
+                  << " p99.9=" << std::setw(8) << at(0.999) << "ns"
+                  << " max=" << static_cast<double>(h.max()) * ns << "ns\n";
+    }
+}
+
 int main() {
     constexpr std::size_t N = 1'000'000;
 
@@ -229,11 +388,19 @@ int main() {
     std::cout << "Operations: " << N << " per test\n";
     print_separator();
 
-    bench_add_limit_orders(N);
-    bench_cancel_orders(N);
-    bench_matching(N);
-    bench_mixed_workload(N);
+    for (LevelStorage storage : {LevelStorage::Map, LevelStorage::Ladder}) {
+        bench_add_limit_orders(N, storage);
+        bench_cancel_orders(N, storage);
+        bench_matching(N, storage);
+        bench_mixed_workload(N, storage);
+        bench_mixed_packets(N, storage);
+        bench_pipeline_round_trip(N / 10, storage);
+    }
 
+#ifdef LOB_ENABLE_PROBES
+    print_separator();
+    print_probes();
+#endif
     print_separator();
     std::cout << "\n";
 
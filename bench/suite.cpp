@@ -0,0 +1,975 @@
+// Throughput benchmark suite: batched TSC timing, parameter sweeps over
+// book shape, journal replay and JSON output.
+//
+// Usage: lob_bench_suite [--filter=SUBSTR] [--batches=N] [--json=FILE|-]
+//                        [--replay=JOURNAL]... [--record=JOURNAL]
+//                        [--feed=CAPTURE]... [--locate=N]
+//
+// Each case times batches of operations between two TSC reads, so the
+// clock is read twice per batch rather than twice per operation. Reported
+// times are ns per operation: the mean over all batches plus the median,
+// p99 and worst batch. --json writes the results in Google Benchmark's
+// JSON layout so existing comparison tooling can diff two runs.
+// --replay times a recorded journal (see lob/journal.hpp) applied to a
+// fresh book; --record writes the synthetic mixed flow as a journal.
+// --feed times a framed ITCH-style capture (see lob/feed.hpp) decoded into
+// a fresh market-by-order book, keeping only stock locate N if given.
+
+#include "lob/order_book.hpp"
+#include "lob/journal.hpp"
+#include "lob/feed.hpp"
+#include "lob/replication.hpp"
+#include "lob/simulation.hpp"
+#include "lob/telemetry.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace lob;
+
+namespace {
+
+struct Options {
+    std::string filter;
+    std::size_t batches = 200;
+    std::string json;
+    std::vector<std::string> replay;
+    std::string record;
+    std::vector<std::string> feed;
+    std::uint16_t locate = 0;
+};
+
+struct Result {
+    std::string name;
+    std::uint64_t iterations = 0;
+    double mean_ns = 0;    // per operation, over every batch
+    double median_ns = 0;  // per operation, median batch
+    double p99_ns = 0;
+    double max_ns = 0;
+};
+
+// Calls prepare() untimed before each batch, then op(i) batch_size times
+// between two TSC reads
+template <typename Prepare, typename Op>
+Result measure(const std::string& name, std::size_t batches, std::size_t batch_size,
+               Prepare&& prepare, Op&& op) {
+    double ns_per_tick = tsc_ns_per_tick();
+    std::vector<double> per_op;
+    per_op.reserve(batches);
+    double total_ns = 0;
+    for (std::size_t b = 0; b < batches; ++b) {
+        prepare();
+        std::uint64_t start = read_tsc();
+        for (std::size_t i = 0; i < batch_size; ++i) op(i);
+        std::uint64_t end = read_tsc();
+        double ns = static_cast<double>(end - start) * ns_per_tick;
+        total_ns += ns;
+        per_op.push_back(ns / static_cast<double>(batch_size));
+    }
+    std::sort(per_op.begin(), per_op.end());
+
+    Result r;
+    r.name = name;
+    r.iterations = static_cast<std::uint64_t>(batches) * batch_size;
+    r.mean_ns = total_ns / static_cast<double>(r.iterations);
+    r.median_ns = per_op[per_op.size() / 2];
+    r.p99_ns = per_op[std::min(per_op.size() - 1, per_op.size() * 99 / 100)];
+    r.max_ns = per_op.back();
+    return r;
+}
+
+// Price grid used by the synthetic cases: bids at 100.00 and below, asks
+// at 100.01 and above, one tick apart
+constexpr Price MID_BID = 10000;
+constexpr Price MID_ASK = 10001;
+
+BookConfig suite_config(std::size_t capacity, LevelStorage storage) {
+    BookConfig config;
+    config.pool.capacity = capacity;
+    config.level_storage = storage;
+    config.ladder = LadderRange{MID_BID - 5000, MID_ASK + 5000, 1};
+    config.warm_up = true;
+    return config;
+}
+
+const char* storage_name(LevelStorage storage) {
+    return storage == LevelStorage::Ladder ? "ladder" : "map";
+}
+
+Price bid_at(std::size_t level) { return MID_BID - static_cast<Price>(level); }
+Price ask_at(std::size_t level) { return MID_ASK + static_cast<Price>(level); }
+
+// levels price levels per side with orders_per_level resting orders each
+void populate(OrderBook& book, std::size_t levels, std::size_t orders_per_level) {
+    TradeBuffer discard;
+    for (std::size_t l = 0; l < levels; ++l) {
+        for (std::size_t k = 0; k < orders_per_level; ++k) {
+            book.add_order(Side::Buy, OrderType::Limit, bid_at(l), 100, discard);
+            book.add_order(Side::Sell, OrderType::Limit, ask_at(l), 100, discard);
+        }
+    }
+}
+
+std::string case_name(const char* kind, LevelStorage storage, std::size_t levels,
+                      std::size_t orders_per_level) {
+    return std::string(kind) + "/" + storage_name(storage) + "/levels:" + std::to_string(levels) +
+           "/orders:" + std::to_string(orders_per_level);
+}
+
+// --- Cases ---
+
+// Passive add at a random existing level; the batch's orders are
+// cancelled untimed before the next batch so the book shape stays fixed
+Result bench_add(const Options& opt, LevelStorage storage, std::size_t levels, std::size_t opl,
+                 std::size_t batch) {
+    OrderBook book(suite_config(levels * opl * 2 + batch + 1024, storage));
+    populate(book, levels, opl);
+    std::mt19937 rng(42);
+    std::vector<Price> prices(batch);
+    std::vector<Side> sides(batch);
+    std::vector<OrderId> added(batch);
+    TradeBuffer discard;
+
+    auto prepare = [&] {
+        for (OrderId id : added) {
+            if (id) book.cancel_order(id);
+        }
+        for (std::size_t i = 0; i < batch; ++i) {
+            sides[i] = rng() % 2 ? Side::Buy : Side::Sell;
+            std::size_t level = rng() % levels;
+            prices[i] = sides[i] == Side::Buy ? bid_at(level) : ask_at(level);
+        }
+    };
+    auto op = [&](std::size_t i) {
+        added[i] = book.add_order(sides[i], OrderType::Limit, prices[i], 100, discard).order_id;
+    };
+    return measure(case_name("add", storage, levels, opl), opt.batches, batch, prepare, op);
+}
+
+// Cancel of a random resting order; the batch's victims are re-added
+// untimed beforehand, so time priority shuffles but the shape holds
+Result bench_cancel(const Options& opt, LevelStorage storage, std::size_t levels,
+                    std::size_t opl, std::size_t batch, bool lazy = false) {
+    BookConfig config = suite_config(levels * opl * 2 + batch + 1024, storage);
+    config.lazy_cancel = lazy;
+    OrderBook book(config);
+    populate(book, levels, opl);
+    std::mt19937 rng(42);
+    std::vector<OrderId> victims(batch);
+    TradeBuffer discard;
+
+    auto prepare = [&] {
+        book.compact();  // lazy mode: the idle-time sweep, untimed
+        for (std::size_t i = 0; i < batch; ++i) {
+            Side side = rng() % 2 ? Side::Buy : Side::Sell;
+            std::size_t level = rng() % levels;
+            Price price = side == Side::Buy ? bid_at(level) : ask_at(level);
+            victims[i] = book.add_order(side, OrderType::Limit, price, 100, discard).order_id;
+        }
+        std::shuffle(victims.begin(), victims.end(), rng);
+    };
+    auto op = [&](std::size_t i) { book.cancel_order(victims[i]); };
+    return measure(case_name(lazy ? "cancel_lazy" : "cancel", storage, levels, opl), opt.batches,
+                   batch, prepare, op);
+}
+
+// Amend of a random resting order to a random level: the market-maker
+// path. The book shape drifts but the level and order counts hold.
+Result bench_replace(const Options& opt, LevelStorage storage, std::size_t levels,
+                     std::size_t opl, std::size_t batch) {
+    OrderBook book(suite_config(levels * opl * 2 + 1024, storage));
+    std::vector<OrderId> bids;
+    std::vector<OrderId> asks;
+    TradeBuffer discard;
+    for (std::size_t l = 0; l < levels; ++l) {
+        for (std::size_t k = 0; k < opl; ++k) {
+            bids.push_back(
+                book.add_order(Side::Buy, OrderType::Limit, bid_at(l), 100, discard).order_id);
+            asks.push_back(
+                book.add_order(Side::Sell, OrderType::Limit, ask_at(l), 100, discard).order_id);
+        }
+    }
+    std::mt19937 rng(42);
+    std::vector<OrderId> ids(batch);
+    std::vector<Price> prices(batch);
+    auto prepare = [&] {
+        for (std::size_t i = 0; i < batch; ++i) {
+            std::size_t level = rng() % levels;
+            if (rng() % 2) {
+                ids[i] = bids[rng() % bids.size()];
+                prices[i] = bid_at(level);
+            } else {
+                ids[i] = asks[rng() % asks.size()];
+                prices[i] = ask_at(level);
+            }
+        }
+    };
+    auto op = [&](std::size_t i) {
+        book.replace_order(ids[i], prices[i], 100 + (i & 1), discard);
+    };
+    return measure(case_name("replace", storage, levels, opl), opt.batches, batch, prepare, op);
+}
+
+// Aggressive order that clears `crossed` ask levels, followed by the
+// refill of those levels; both halves are timed (refill cost is the add
+// case above)
+Result bench_sweep(const Options& opt, LevelStorage storage, std::size_t levels,
+                   std::size_t opl, std::size_t crossed, std::size_t batch) {
+    OrderBook book(suite_config(levels * opl * 2 + 1024, storage));
+    populate(book, levels, opl);
+    std::vector<Trade> trade_storage(crossed * opl + 16);
+    TradeBuffer trades(trade_storage.data(), trade_storage.size());
+    TradeBuffer discard;
+    Quantity sweep_qty = static_cast<Quantity>(crossed * opl * 100);
+
+    auto op = [&](std::size_t) {
+        trades.clear();
+        book.add_order(Side::Buy, OrderType::Limit, ask_at(crossed - 1), sweep_qty, trades);
+        for (std::size_t l = 0; l < crossed; ++l) {
+            for (std::size_t k = 0; k < opl; ++k) {
+                book.add_order(Side::Sell, OrderType::Limit, ask_at(l), 100, discard);
+            }
+        }
+    };
+    std::string name = case_name("sweep_refill", storage, levels, opl) + "/crossed:" +
+                       std::to_string(crossed);
+    return measure(name, opt.batches, batch, [] {}, op);
+}
+
+// An aggressive buy for 150 lots at a level holding one refilled 100-lot
+// ask, so 50 lots are left over: either sent as IOC, or as a limit order
+// whose resting remainder is then cancelled (the client-side emulation).
+// The refill is timed in both.
+Result bench_ioc(const Options& opt, LevelStorage storage, std::size_t levels, std::size_t opl,
+                 bool native, std::size_t batch) {
+    OrderBook book(suite_config(levels * opl * 2 + 1024, storage));
+    populate(book, levels, opl);
+    book.add_order(Side::Buy, OrderType::Market, 0, static_cast<Quantity>(opl * 100));
+    TradeBuffer trades;
+
+    auto op = [&](std::size_t) {
+        book.add_order(Side::Sell, OrderType::Limit, ask_at(0), 100, trades);
+        if (native) {
+            book.add_order(Side::Buy, OrderType::IOC, ask_at(0), 150, trades);
+        } else {
+            OrderAck ack = book.add_order(Side::Buy, OrderType::Limit, ask_at(0), 150, trades);
+            book.cancel_order(ack.order_id);
+        }
+    };
+    std::string name = case_name("ioc_remainder", storage, levels, opl) +
+                       (native ? "/ioc" : "/limit_cancel");
+    return measure(name, opt.batches, batch, [] {}, op);
+}
+
+// A fill-or-kill buy one lot larger than the `crossed` best ask levels
+// hold, limited to the last of them: rejected by the read-only pre-check
+Result bench_fok_reject(const Options& opt, LevelStorage storage, std::size_t levels,
+                        std::size_t opl, std::size_t crossed, std::size_t batch) {
+    OrderBook book(suite_config(levels * opl * 2 + 1024, storage));
+    populate(book, levels, opl);
+    TradeBuffer trades;
+    auto qty = static_cast<Quantity>(crossed * opl * 100 + 1);
+    auto op = [&](std::size_t) {
+        book.add_order(Side::Buy, OrderType::FOK, ask_at(crossed - 1), qty, trades);
+    };
+    std::string name = case_name("fok_reject", storage, levels, opl) + "/crossed:" +
+                       std::to_string(crossed);
+    return measure(name, opt.batches, batch, [] {}, op);
+}
+
+// Sweep of `crossed` deep ask levels plus the egress it causes: each
+// outbound message (sequence number, then payload) is copied into a send
+// buffer, either one per trade or one per conflated level execution with
+// its passive fill list. One sweep per batch; the refill is untimed.
+Result bench_sweep_publish(const Options& opt, LevelStorage storage, std::size_t levels,
+                           std::size_t opl, std::size_t crossed, bool conflate) {
+    OrderBook book(suite_config(levels * opl * 2 + 1024, storage));
+    populate(book, levels, opl);
+    std::vector<Trade> trade_storage(crossed * opl + 16);
+    TradeBuffer trades(trade_storage.data(), trade_storage.size());
+    std::vector<LevelExecution> execution_storage(crossed + 1);
+    std::vector<PassiveFill> fill_storage(crossed * opl + 16);
+    ExecutionBuffer executions(execution_storage.data(), execution_storage.size(),
+                               fill_storage.data(), fill_storage.size());
+    if (conflate) book.set_level_executions(&executions);
+    TradeBuffer discard;
+    Quantity sweep_qty = static_cast<Quantity>(crossed * opl * 100);
+
+    std::vector<char> outbound((crossed * opl + 16) * (sizeof(Trade) + 16));
+    std::uint64_t sequence = 0;
+    auto emit = [&](char*& at, const void* payload, std::size_t size) {
+        ++sequence;
+        std::memcpy(at, &sequence, sizeof(sequence));
+        std::memcpy(at + sizeof(sequence), payload, size);
+        at += sizeof(sequence) + size;
+    };
+
+    bool swept = false;
+    auto prepare = [&] {
+        for (std::size_t l = 0; swept && l < crossed; ++l) {
+            for (std::size_t k = 0; k < opl; ++k) {
+                book.add_order(Side::Sell, OrderType::Limit, ask_at(l), 100, discard);
+            }
+        }
+        swept = true;
+    };
+    auto op = [&](std::size_t) {
+        trades.clear();
+        book.add_order(Side::Buy, OrderType::Limit, ask_at(crossed - 1), sweep_qty, trades);
+        char* at = outbound.data();
+        if (conflate) {
+            for (const LevelExecution& e : executions) {
+                emit(at, &e, offsetof(LevelExecution, fills));
+                std::memcpy(at, e.fills, e.fill_count * sizeof(PassiveFill));
+                at += e.fill_count * sizeof(PassiveFill);
+            }
+        } else {
+            for (const Trade& t : trades) emit(at, &t, sizeof(t));
+        }
+    };
+    std::string name = case_name(conflate ? "sweep_publish_levels" : "sweep_publish_trades",
+                                 storage, levels, opl) +
+                       "/crossed:" + std::to_string(crossed);
+    return measure(name, opt.batches * 10, 1, prepare, op);
+}
+
+// Passive add through a journaled book at a random level of a 100-level
+// book; the batch's orders are cancelled untimed before the next batch,
+// after idle(). Book is a JournaledBook or a ReplicatedBook.
+template <typename Book, typename Idle>
+Result bench_logged_add(const Options& opt, const std::string& name, Book& book, Idle&& idle) {
+    TradeBuffer discard;
+    for (std::size_t l = 0; l < 100; ++l) {
+        book.add_order(Side::Buy, OrderType::Limit, bid_at(l), 100, discard);
+        book.add_order(Side::Sell, OrderType::Limit, ask_at(l), 100, discard);
+    }
+    constexpr std::size_t BATCH = 256;
+    std::mt19937 rng(42);
+    std::vector<Price> prices(BATCH);
+    std::vector<Side> sides(BATCH);
+    std::vector<OrderId> added(BATCH);
+    auto prepare = [&] {
+        idle();
+        for (OrderId id : added) {
+            if (id) book.cancel_order(id);
+        }
+        for (std::size_t i = 0; i < BATCH; ++i) {
+            sides[i] = rng() % 2 ? Side::Buy : Side::Sell;
+            std::size_t level = rng() % 100;
+            prices[i] = sides[i] == Side::Buy ? bid_at(level) : ask_at(level);
+        }
+    };
+    auto op = [&](std::size_t i) {
+        added[i] = book.add_order(sides[i], OrderType::Limit, prices[i], 100, discard).order_id;
+    };
+    return measure(name, opt.batches, BATCH, prepare, op);
+}
+
+// The same adds with every input streamed over loopback UDP to a standby
+// book polled on another thread
+Result bench_replicate(const Options& opt, std::size_t records_per_packet) {
+    std::string path = "/tmp/lob_bench_replicated.journal";
+    BookConfig config = suite_config(1 << 16, LevelStorage::Ladder);
+    std::size_t max_records = opt.batches * 256 * 2 + 1024;
+    if (records_per_packet == 0) {
+        JournaledBook book(path, config, max_records);
+        Result r = bench_logged_add(opt, "replicate/journal_only", book, [] {});
+        std::remove(path.c_str());
+        return r;
+    }
+
+    OrderBook standby_book(config);
+    ReplicationReceiver<OrderBook> standby(standby_book, ReplicationConfig());
+    ReplicationConfig link;
+    link.port = standby.local().port;
+    link.records_per_packet = records_per_packet;
+    ReplicatedBook book(path, config, max_records, link);
+
+    std::atomic<bool> stop{false};
+    std::thread follower([&] {
+        while (!stop.load(std::memory_order_relaxed)) standby.poll();
+    });
+    Result r = bench_logged_add(opt,
+                                "replicate/udp_loopback/records_per_packet:" +
+                                    std::to_string(records_per_packet),
+                                book, [&book] { book.idle(); });
+    book.sender().flush();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (standby.next_sequence() < book.journal().size() &&
+           std::chrono::steady_clock::now() < deadline) {
+        book.idle();
+    }
+    stop = true;
+    follower.join();
+    if (standby.next_sequence() != book.journal().size()) {
+        std::cerr << r.name << ": standby stopped at " << standby.next_sequence() << " of "
+                  << book.journal().size() << "\n";
+    }
+    std::remove(path.c_str());
+    return r;
+}
+
+// A backtest of `scenarios` seeded random days of `inputs` inputs each,
+// per input of wall time for the whole run: the throughput of a
+// SimulationRunner with `threads` workers
+Result bench_simulate(const Options& opt, std::size_t threads, std::size_t scenarios,
+                      std::size_t inputs) {
+    std::vector<Scenario> days;
+    for (std::size_t s = 0; s < scenarios; ++s) {
+        auto seed = static_cast<unsigned>(s + 1);
+        days.push_back([seed, inputs](SimulationContext& context) {
+            std::mt19937 rng(seed);
+            std::vector<OrderId> ids;
+            for (std::size_t i = 0; i < inputs; ++i) {
+                if (rng() % 3 == 0 && !ids.empty()) {
+                    std::size_t victim = rng() % ids.size();
+                    context.cancel_order(ids[victim]);
+                    ids[victim] = ids.back();
+                    ids.pop_back();
+                    continue;
+                }
+                Side side = rng() % 2 ? Side::Buy : Side::Sell;
+                Price price = (side == Side::Buy ? MID_BID : MID_ASK) - 10 +
+                              static_cast<Price>(rng() % 21);
+                auto qty = static_cast<Quantity>(1 + rng() % 200);
+                OrderAck ack = context.add_order(side, OrderType::Limit, price, qty);
+                if (ack.remaining_quantity != 0) ids.push_back(ack.order_id);
+            }
+        });
+    }
+
+    SimulationConfig config;
+    config.threads = threads;
+    config.book = suite_config(inputs + 1024, LevelStorage::Ladder);
+    config.measure_latency = false;
+    SimulationRunner runner(config);
+    runner.run(days);  // untimed: creates and warms the books
+
+    std::size_t repetitions = std::max<std::size_t>(1, opt.batches / 50);
+    std::uint64_t before = runner.stats().inputs;
+    std::vector<double> per_op;
+    double total_ns = 0;
+    for (std::size_t rep = 0; rep < repetitions; ++rep) {
+        std::uint64_t start_inputs = runner.stats().inputs;
+        auto start = std::chrono::steady_clock::now();
+        runner.run(days);
+        auto ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                          std::chrono::steady_clock::now() - start)
+                                          .count());
+        total_ns += ns;
+        per_op.push_back(ns / static_cast<double>(runner.stats().inputs - start_inputs));
+    }
+    std::sort(per_op.begin(), per_op.end());
+
+    Result r;
+    r.name = "simulate/threads:" + std::to_string(runner.threads()) +
+             "/scenarios:" + std::to_string(scenarios) + "/inputs:" + std::to_string(inputs);
+    r.iterations = runner.stats().inputs - before;
+    r.mean_ns = total_ns / static_cast<double>(r.iterations);
+    r.median_ns = per_op[per_op.size() / 2];
+    r.p99_ns = per_op[std::min(per_op.size() - 1, per_op.size() * 99 / 100)];
+    r.max_ns = per_op.back();
+    return r;
+}
+
+// An opening of `orders` crossing limit orders, per order: either matched
+// on arrival, or rested through an auction and uncrossed once at the end
+Result bench_open(const Options& opt, LevelStorage storage, bool auction, std::size_t orders) {
+    std::mt19937 rng(5);
+    std::vector<OrderRequest> flow(orders);
+    for (OrderRequest& r : flow) {
+        r.side = rng() % 2 ? Side::Buy : Side::Sell;
+        // Both sides spread 20 ticks either side of the mid
+        r.price = MID_BID - 20 + static_cast<Price>(rng() % 41);
+        r.quantity = 1 + rng() % 200;
+    }
+    std::unique_ptr<OrderBook> book;
+    std::vector<Trade> trade_storage(orders * 2);
+    TradeBuffer trades(trade_storage.data(), trade_storage.size());
+
+    auto prepare = [&] {
+        book.reset(new OrderBook(suite_config(orders + 1024, storage)));
+        if (auction) book->begin_auction();
+        trades.clear();
+    };
+    auto op = [&](std::size_t i) {
+        const OrderRequest& r = flow[i];
+        book->add_order(r.side, OrderType::Limit, r.price, r.quantity, trades);
+        if (auction && i + 1 == orders) book->uncross(trades);
+    };
+    std::string name = std::string(auction ? "open_auction/" : "open_continuous/") +
+                       storage_name(storage) + "/orders:" + std::to_string(orders);
+    return measure(name, opt.batches, orders, prepare, op);
+}
+
+// Written once per case so the compiler keeps the query results
+volatile std::uint64_t query_sink;
+
+// Pre-trade estimate for a market buy that reaches `crossed` ask levels;
+// the book is never modified
+Result bench_cost_to_fill(const Options& opt, LevelStorage storage, std::size_t levels,
+                          std::size_t crossed, std::size_t batch) {
+    OrderBook book(suite_config(levels * 2 + 1024, storage));
+    populate(book, levels, 1);
+    Quantity qty = static_cast<Quantity>(crossed * 100 - 50);
+    std::uint64_t sink = 0;
+
+    auto op = [&](std::size_t i) { sink += book.cost_to_fill(Side::Buy, qty + i % 2).cost; };
+    std::string name = case_name("cost_to_fill", storage, levels, 1) + "/crossed:" +
+                       std::to_string(crossed);
+    Result r = measure(name, opt.batches, batch, [] {}, op);
+    query_sink = sink;
+    return r;
+}
+
+// Pregenerated 60% add / 30% cancel / 10% aggressive flow around the
+// populated book, applied in batches
+Result bench_mixed(const Options& opt, LevelStorage storage, std::size_t levels,
+                   std::size_t opl, std::size_t batch) {
+    std::size_t total = opt.batches * batch;
+    OrderBook book(suite_config(levels * opl * 2 + total + 1024, storage));
+    populate(book, levels, opl);
+
+    struct Message {
+        int action;
+        Side side;
+        Price price;
+        Quantity qty;
+        std::size_t victim;  // index into live
+    };
+    std::mt19937 rng(7);
+    std::vector<Message> flow(total);
+    for (Message& m : flow) {
+        int roll = static_cast<int>(rng() % 100);
+        m.action = roll < 60 ? 0 : roll < 90 ? 1 : 2;
+        m.side = rng() % 2 ? Side::Buy : Side::Sell;
+        std::size_t level = rng() % levels;
+        m.price = m.action == 2 ? (m.side == Side::Buy ? ask_at(0) : bid_at(0))
+                                : (m.side == Side::Buy ? bid_at(level) : ask_at(level));
+        m.qty = 1 + rng() % 200;
+        m.victim = rng();
+    }
+
+    std::vector<OrderId> live;
+    live.reserve(total);
+    TradeBuffer discard;
+    std::size_t next = 0;
+    auto op = [&](std::size_t) {
+        const Message& m = flow[next++];
+        if (m.action == 1 && !live.empty()) {
+            std::size_t idx = m.victim % live.size();
+            book.cancel_order(live[idx]);
+            live[idx] = live.back();
+            live.pop_back();
+            return;
+        }
+        OrderAck ack = book.add_order(m.side, OrderType::Limit, m.price, m.qty, discard);
+        discard.clear();
+        if (m.action == 0 && ack.remaining_quantity > 0) live.push_back(ack.order_id);
+    };
+    return measure(case_name("mixed", storage, levels, opl), opt.batches, batch, [] {}, op);
+}
+
+// Whole-journal replay into a fresh book per repetition, timed in
+// batches of records
+Result bench_replay(const Options& opt, const std::string& path) {
+    JournalReader reader(path);
+    if (reader.size() == 0) throw std::runtime_error("journal " + path + " is empty");
+    constexpr std::size_t BATCH = 1024;
+    std::size_t batches = (reader.size() + BATCH - 1) / BATCH;
+    std::size_t repetitions = std::max<std::size_t>(1, opt.batches / batches);
+
+    double ns_per_tick = tsc_ns_per_tick();
+    std::vector<double> per_op;
+    double total_ns = 0;
+    for (std::size_t rep = 0; rep < repetitions; ++rep) {
+        std::unique_ptr<OrderBook> book(new OrderBook(book_config_from(reader.header())));
+        book->warm_up();
+        for (const JournalRecord* first = reader.begin(); first < reader.end(); first += BATCH) {
+            const JournalRecord* last = std::min(first + BATCH, reader.end());
+            std::uint64_t start = read_tsc();
+            replay_journal(first, last, *book);
+            std::uint64_t end = read_tsc();
+            double ns = static_cast<double>(end - start) * ns_per_tick;
+            total_ns += ns;
+            per_op.push_back(ns / static_cast<double>(last - first));
+        }
+    }
+    std::sort(per_op.begin(), per_op.end());
+
+    Result r;
+    std::string base = path.substr(path.find_last_of('/') + 1);
+    r.name = "replay/" + base;
+    r.iterations = static_cast<std::uint64_t>(repetitions) * reader.size();
+    r.mean_ns = total_ns / static_cast<double>(r.iterations);
+    r.median_ns = per_op[per_op.size() / 2];
+    r.p99_ns = per_op[std::min(per_op.size() - 1, per_op.size() * 99 / 100)];
+    r.max_ns = per_op.back();
+    return r;
+}
+
+// Feed decode into a fresh book per repetition, timed in chunks of
+// about 1024 frames
+Result bench_feed(const Options& opt, const std::string& name, const char* data,
+                  std::size_t size, const BookConfig& config, const FeedConfig& feed) {
+    constexpr std::size_t BATCH = 1024;
+    std::vector<std::size_t> cuts{0};  // chunk boundaries, on whole frames
+    std::size_t frames = 0;
+    std::size_t at = 0;
+    while (size - at >= 2 && at + 2 + detail::load_be16(data + at) <= size) {
+        at += 2 + detail::load_be16(data + at);
+        if (++frames % BATCH == 0) cuts.push_back(at);
+    }
+    if (frames == 0) throw std::runtime_error("feed " + name + " holds no complete frame");
+    if (frames % BATCH != 0) cuts.push_back(at);
+    std::size_t repetitions = std::max<std::size_t>(1, opt.batches / (cuts.size() - 1));
+
+    double ns_per_tick = tsc_ns_per_tick();
+    std::vector<double> per_op;
+    double total_ns = 0;
+    for (std::size_t rep = 0; rep < repetitions; ++rep) {
+        std::unique_ptr<OrderBook> book(new OrderBook(config));
+        FeedDecoder<OrderBook> decoder(*book, feed);
+        for (std::size_t c = 1; c < cuts.size(); ++c) {
+            std::uint64_t before = decoder.stats().messages;
+            std::uint64_t start = read_tsc();
+            decoder.decode(data + cuts[c - 1], cuts[c] - cuts[c - 1]);
+            std::uint64_t end = read_tsc();
+            double ns = static_cast<double>(end - start) * ns_per_tick;
+            total_ns += ns;
+            per_op.push_back(ns / static_cast<double>(decoder.stats().messages - before));
+        }
+    }
+    std::sort(per_op.begin(), per_op.end());
+
+    Result r;
+    r.name = name;
+    r.iterations = static_cast<std::uint64_t>(repetitions) * frames;
+    r.mean_ns = total_ns / static_cast<double>(r.iterations);
+    r.median_ns = per_op[per_op.size() / 2];
+    r.p99_ns = per_op[std::min(per_op.size() - 1, per_op.size() * 99 / 100)];
+    r.max_ns = per_op.back();
+    return r;
+}
+
+// The mixed flow as an exchange would publish it: adds, deletes,
+// executions and replaces against the resting orders
+std::vector<char> encode_mixed_feed(std::size_t messages) {
+    FeedEncoder feed;
+    std::mt19937 rng(7);
+    std::vector<std::pair<std::uint64_t, Side>> live;
+    std::uint64_t next_ref = 1;
+    auto wire = [](Price price) {
+        return static_cast<std::uint32_t>(price * FEED_PRICE_SCALE / PRICE_MULTIPLIER);
+    };
+    for (std::size_t i = 0; i < messages; ++i) {
+        int roll = static_cast<int>(rng() % 100);
+        Side side = rng() % 2 ? Side::Buy : Side::Sell;
+        std::size_t level = rng() % 100;
+        auto shares = static_cast<std::uint32_t>(1 + rng() % 200);
+        if (roll < 60 || live.empty()) {
+            feed.add_order(next_ref, side, shares,
+                           wire(side == Side::Buy ? bid_at(level) : ask_at(level)));
+            live.emplace_back(next_ref++, side);
+            continue;
+        }
+        std::size_t idx = rng() % live.size();
+        auto [ref, resting] = live[idx];
+        if (roll < 90) {
+            // Sizes are at most 200, so this execution takes the whole order
+            if (roll < 80) {
+                feed.remove(ref);
+            } else {
+                feed.execute(ref, 200);
+            }
+            live[idx] = live.back();
+            live.pop_back();
+        } else {
+            // A replace keeps the order's side
+            feed.replace(ref, next_ref, shares,
+                         wire(resting == Side::Buy ? bid_at(level) : ask_at(level)));
+            live[idx].first = next_ref++;
+        }
+    }
+    return feed.buffer();
+}
+
+// Write the mixed flow, as a JournaledBook would record it, for --replay
+void record_mixed(const std::string& path, std::size_t messages) {
+    BookConfig config = suite_config(messages + 1024, LevelStorage::Ladder);
+    JournaledBook book(path, config, messages);
+    std::mt19937 rng(7);
+    std::vector<OrderId> live;
+    TradeBuffer discard;
+    for (std::size_t i = 0; i < messages; ++i) {
+        int roll = static_cast<int>(rng() % 100);
+        Side side = rng() % 2 ? Side::Buy : Side::Sell;
+        std::size_t level = rng() % 100;
+        Quantity qty = 1 + rng() % 200;
+        if (roll >= 60 && roll < 90 && !live.empty()) {
+            std::size_t idx = rng() % live.size();
+            book.cancel_order(live[idx]);
+            live[idx] = live.back();
+            live.pop_back();
+        } else if (roll >= 90) {
+            book.add_order(side, OrderType::Limit, side == Side::Buy ? ask_at(0) : bid_at(0),
+                           qty, discard);
+        } else {
+            OrderAck ack = book.add_order(
+                side, OrderType::Limit, side == Side::Buy ? bid_at(level) : ask_at(level), qty,
+                discard);
+            if (ack.remaining_quantity > 0) live.push_back(ack.order_id);
+        }
+        discard.clear();
+    }
+    book.journal().sync();
+}
+
+// --- Output ---
+
+void print_header(std::ostream& out) {
+    out << std::left << std::setw(56) << "Benchmark" << std::right << std::setw(12)
+              << "Mean" << std::setw(12) << "Median" << std::setw(12) << "p99 batch"
+              << std::setw(12) << "Max batch" << std::setw(14) << "Iterations" << "\n"
+              << std::string(118, '-') << "\n";
+}
+
+void print_result(std::ostream& out, const Result& r) {
+    out << std::left << std::setw(56) << r.name << std::right << std::fixed
+              << std::setprecision(1) << std::setw(10) << r.mean_ns << "ns" << std::setw(10)
+              << r.median_ns << "ns" << std::setw(10) << r.p99_ns << "ns" << std::setw(10)
+              << r.max_ns << "ns" << std::setw(14) << r.iterations << "\n";
+}
+
+void write_json(std::ostream& out, const std::vector<Result>& results) {
+    char date[64];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\n  \"context\": {\n"
+        << "    \"date\": \"" << date << "\",\n"
+        << "    \"executable\": \"lob_bench_suite\",\n"
+        << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+        << "    \"mhz_per_cpu\": " << static_cast<long>(1000.0 / tsc_ns_per_tick()) << ",\n"
+        << "    \"timer\": \"tsc\",\n"
+#if defined(LOB_ENABLE_PROBES)
+        << "    \"probes\": true,\n"
+#else
+        << "    \"probes\": false,\n"
+#endif
+        << "    \"library_build_type\": \"release\"\n"
+        << "  },\n  \"benchmarks\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << "    {\n"
+            << "      \"name\": \"" << r.name << "\",\n"
+            << "      \"run_type\": \"iteration\",\n"
+            << "      \"iterations\": " << r.iterations << ",\n"
+            << "      \"real_time\": " << r.mean_ns << ",\n"
+            << "      \"cpu_time\": " << r.mean_ns << ",\n"
+            << "      \"time_unit\": \"ns\",\n"
+            << "      \"items_per_second\": " << 1e9 / r.mean_ns << ",\n"
+            << "      \"median_batch_ns\": " << r.median_ns << ",\n"
+            << "      \"p99_batch_ns\": " << r.p99_ns << ",\n"
+            << "      \"max_batch_ns\": " << r.max_ns << "\n"
+            << "    }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+bool parse_args(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&](const char* flag) -> const char* {
+            std::size_t n = std::char_traits<char>::length(flag);
+            return arg.compare(0, n, flag) == 0 ? arg.c_str() + n : nullptr;
+        };
+        if (const char* v = value("--filter=")) {
+            opt.filter = v;
+        } else if (const char* v2 = value("--batches=")) {
+            opt.batches = std::max<std::size_t>(1, std::stoul(v2));
+        } else if (const char* v3 = value("--json=")) {
+            opt.json = v3;
+        } else if (const char* v4 = value("--replay=")) {
+            opt.replay.push_back(v4);
+        } else if (const char* v5 = value("--record=")) {
+            opt.record = v5;
+        } else if (const char* v6 = value("--feed=")) {
+            opt.feed.push_back(v6);
+        } else if (const char* v7 = value("--locate=")) {
+            opt.locate = static_cast<std::uint16_t>(std::stoul(v7));
+        } else {
+            std::cerr << "usage: " << argv[0]
+                      << " [--filter=SUBSTR] [--batches=N] [--json=FILE|-]"
+                         " [--replay=JOURNAL]... [--record=JOURNAL]"
+                         " [--feed=CAPTURE]... [--locate=N]\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parse_args(argc, argv, opt)) return 2;
+
+    try {
+        if (!opt.record.empty()) {
+            record_mixed(opt.record, 1'000'000);
+            std::cerr << "recorded 1000000 messages to " << opt.record << "\n";
+            return 0;
+        }
+
+        // Registered cases; each runs only if its name passes the filter
+        std::vector<std::pair<std::string, std::function<Result()>>> cases;
+        for (LevelStorage storage : {LevelStorage::Map, LevelStorage::Ladder}) {
+            for (std::size_t levels : {10, 100, 1000}) {
+                for (std::size_t opl : {1, 10, 100}) {
+                    if (levels * opl > 20000) continue;
+                    cases.emplace_back(case_name("add", storage, levels, opl),
+                                       [=, &opt] { return bench_add(opt, storage, levels, opl, 256); });
+                    cases.emplace_back(case_name("cancel", storage, levels, opl), [=, &opt] {
+                        return bench_cancel(opt, storage, levels, opl, 256);
+                    });
+                    cases.emplace_back(case_name("cancel_lazy", storage, levels, opl), [=, &opt] {
+                        return bench_cancel(opt, storage, levels, opl, 256, true);
+                    });
+                    cases.emplace_back(case_name("replace", storage, levels, opl), [=, &opt] {
+                        return bench_replace(opt, storage, levels, opl, 256);
+                    });
+                    cases.emplace_back(case_name("mixed", storage, levels, opl), [=, &opt] {
+                        return bench_mixed(opt, storage, levels, opl, 256);
+                    });
+                }
+            }
+            for (std::size_t crossed : {1, 4, 16}) {
+                std::string name = case_name("sweep_refill", storage, 100, 10) + "/crossed:" +
+                                   std::to_string(crossed);
+                cases.emplace_back(name, [=, &opt] {
+                    return bench_sweep(opt, storage, 100, 10, crossed, 32);
+                });
+            }
+            for (bool native : {false, true}) {
+                std::string name = case_name("ioc_remainder", storage, 100, 10) +
+                                   (native ? "/ioc" : "/limit_cancel");
+                cases.emplace_back(name, [=, &opt] {
+                    return bench_ioc(opt, storage, 100, 10, native, 256);
+                });
+            }
+            for (std::size_t crossed : {1, 10}) {
+                std::string name = case_name("fok_reject", storage, 100, 10) + "/crossed:" +
+                                   std::to_string(crossed);
+                cases.emplace_back(name, [=, &opt] {
+                    return bench_fok_reject(opt, storage, 100, 10, crossed, 256);
+                });
+            }
+            for (bool conflate : {false, true}) {
+                std::string name =
+                    case_name(conflate ? "sweep_publish_levels" : "sweep_publish_trades", storage,
+                              100, 100) +
+                    "/crossed:4";
+                cases.emplace_back(name, [=, &opt] {
+                    return bench_sweep_publish(opt, storage, 100, 100, 4, conflate);
+                });
+            }
+            for (std::size_t crossed : {1, 10, 100, 1000}) {
+                std::string name = case_name("cost_to_fill", storage, 1000, 1) + "/crossed:" +
+                                   std::to_string(crossed);
+                cases.emplace_back(name, [=, &opt] {
+                    return bench_cost_to_fill(opt, storage, 1000, crossed, 256);
+                });
+            }
+        }
+        for (LevelStorage storage : {LevelStorage::Map, LevelStorage::Ladder}) {
+            for (bool auction : {false, true}) {
+                std::string name = std::string(auction ? "open_auction/" : "open_continuous/") +
+                                   storage_name(storage) + "/orders:10000";
+                cases.emplace_back(name, [=, &opt] {
+                    return bench_open(opt, storage, auction, 10000);
+                });
+            }
+        }
+        for (std::size_t records_per_packet : {0, 1, 44}) {
+            std::string name = records_per_packet == 0
+                                   ? std::string("replicate/journal_only")
+                                   : "replicate/udp_loopback/records_per_packet:" +
+                                         std::to_string(records_per_packet);
+            cases.emplace_back(name, [=, &opt] { return bench_replicate(opt, records_per_packet); });
+        }
+        std::vector<std::size_t> thread_counts{1};
+        if (std::thread::hardware_concurrency() > 1) {
+            thread_counts.push_back(std::thread::hardware_concurrency());
+        }
+        for (std::size_t threads : thread_counts) {
+            std::string name = "simulate/threads:" + std::to_string(threads) +
+                               "/scenarios:64/inputs:20000";
+            cases.emplace_back(name, [=, &opt] {
+                return bench_simulate(opt, threads, 64, 20000);
+            });
+        }
+        std::vector<char> synthetic_feed;
+        for (LevelStorage storage : {LevelStorage::Map, LevelStorage::Ladder}) {
+            std::string name = std::string("feed/synthetic/") + storage_name(storage);
+            cases.emplace_back(name, [=, &opt, &synthetic_feed] {
+                if (synthetic_feed.empty()) synthetic_feed = encode_mixed_feed(1'000'000);
+                return bench_feed(opt, name, synthetic_feed.data(), synthetic_feed.size(),
+                                  suite_config(1'000'000, storage), FeedConfig());
+            });
+        }
+        for (const std::string& path : opt.feed) {
+            std::string name = "feed/" + path.substr(path.find_last_of('/') + 1);
+            cases.emplace_back(name, [&opt, path, name] {
+                // Real prices need not fit the synthetic ladder band
+                FeedFile file(path);
+                BookConfig config = suite_config(1 << 20, LevelStorage::Map);
+                FeedConfig feed;
+                feed.locate = opt.locate;
+                return bench_feed(opt, name, file.data(), file.size(), config, feed);
+            });
+        }
+        for (const std::string& path : opt.replay) {
+            cases.emplace_back("replay/" + path.substr(path.find_last_of('/') + 1),
+                               [&opt, path] { return bench_replay(opt, path); });
+        }
+
+        // The table moves to stderr when JSON goes to stdout
+        std::ostream& table = opt.json == "-" ? std::cerr : std::cout;
+        std::vector<Result> results;
+        print_header(table);
+        for (auto& [name, run] : cases) {
+            if (!opt.filter.empty() && name.find(opt.filter) == std::string::npos) continue;
+            results.push_back(run());
+            print_result(table, results.back());
+        }
+
+        if (opt.json == "-") {
+            write_json(std::cout, results);
+        } else if (!opt.json.empty()) {
+            std::ofstream out(opt.json);
+            if (!out) throw std::runtime_error("cannot write " + opt.json);
+            write_json(out, results);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "benchmark failed: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,214 @@
+#pragma once
+
+#include "types.hpp"
+#include "order.hpp"
+
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+namespace lob {
+
+// Resting order lifecycle event
+template <typename Traits>
+struct BasicOrderEvent {
+    typename Traits::OrderId order_id;
+    Side side;
+    typename Traits::Price price;
+    typename Traits::Quantity remaining;  // open quantity after the event
+};
+
+using OrderEvent = BasicOrderEvent<DefaultBookTraits>;
+
+// New state of a price level; zero orders means the level was removed
+template <typename Traits>
+struct BasicLevelUpdate {
+    Side side;
+    typename Traits::Price price;
+    typename Traits::Quantity total_quantity;
+    std::uint32_t order_count;
+};
+
+using LevelUpdate = BasicLevelUpdate<DefaultBookTraits>;
+
+// Caller-owned, fixed-capacity list of level changes for one input message.
+// Each (side, price) appears once, holding the level's state at the end of
+// the message, in the order the levels were first touched. Changes beyond
+// capacity are only counted in dropped; a consumer seeing dropped != 0
+// should resynchronise from a depth snapshot.
+template <typename Traits>
+struct BasicLevelDeltaBuffer {
+    using LevelUpdate = BasicLevelUpdate<Traits>;
+
+    LevelUpdate* data = nullptr;
+    std::size_t capacity = 0;
+    std::size_t size = 0;
+    std::size_t dropped = 0;
+
+    BasicLevelDeltaBuffer() = default;
+    BasicLevelDeltaBuffer(LevelUpdate* storage, std::size_t cap) : data(storage), capacity(cap) {}
+
+    // Messages touch few levels, so a backward scan beats any index
+    void record(const LevelUpdate& update) {
+        for (std::size_t i = size; i-- > 0;) {
+            if (data[i].price == update.price && data[i].side == update.side) {
+                data[i] = update;
+                return;
+            }
+        }
+        if (size < capacity) {
+            data[size++] = update;
+        } else {
+            ++dropped;
+        }
+    }
+
+    void clear() {
+        size = 0;
+        dropped = 0;
+    }
+
+    const LevelUpdate* begin() const { return data; }
+    const LevelUpdate* end() const { return data + size; }
+};
+
+using LevelDeltaBuffer = BasicLevelDeltaBuffer<DefaultBookTraits>;
+
+// One passive order's share of a conflated level execution
+template <typename Traits>
+struct BasicPassiveFill {
+    typename Traits::OrderId order_id;
+    typename Traits::Quantity quantity;
+};
+
+// Every fill one aggressor took from one price level, as a single record.
+// fills points at this execution's entries in the buffer's fill storage;
+// fill_count < order_count means that storage ran out part way through.
+template <typename Traits>
+struct BasicLevelExecution {
+    using PassiveFill = BasicPassiveFill<Traits>;
+
+    typename Traits::OrderId aggressor_id;
+    Side aggressor_side;
+    typename Traits::Price price;
+    typename Traits::Quantity quantity;  // total executed at the level
+    std::uint64_t timestamp;
+    std::uint32_t order_count;           // passive orders filled
+    std::uint32_t fill_count;            // entries stored at fills
+    const PassiveFill* fills;
+
+    const PassiveFill* begin() const { return fills; }
+    const PassiveFill* end() const { return fills + fill_count; }
+};
+
+// Caller-owned conflated trade output for one input message: one
+// execution per (aggressor, level), in sweep order, plus the per-order
+// (passive ID, quantity) detail in a second fixed array. Executions beyond
+// capacity are only counted in dropped, fills beyond fill_capacity in
+// fills_dropped (their executions still carry the totals).
+template <typename Traits>
+struct BasicExecutionBuffer {
+    using LevelExecution = BasicLevelExecution<Traits>;
+    using PassiveFill = BasicPassiveFill<Traits>;
+    using OrderId = typename Traits::OrderId;
+    using Price = typename Traits::Price;
+    using Quantity = typename Traits::Quantity;
+
+    LevelExecution* data = nullptr;
+    std::size_t capacity = 0;
+    std::size_t size = 0;
+    std::size_t dropped = 0;
+
+    PassiveFill* fills = nullptr;
+    std::size_t fill_capacity = 0;
+    std::size_t fill_size = 0;
+    std::size_t fills_dropped = 0;
+
+    BasicExecutionBuffer() = default;
+    BasicExecutionBuffer(LevelExecution* storage, std::size_t cap, PassiveFill* fill_storage,
+                         std::size_t fill_cap)
+        : data(storage), capacity(cap), fills(fill_storage), fill_capacity(fill_cap) {}
+
+    // Called by the book around each level of a sweep
+    void open(OrderId aggressor, Side side, Price price, std::uint64_t timestamp) {
+        current_ = LevelExecution{aggressor, side, price, 0, timestamp, 0, 0, fills + fill_size};
+    }
+
+    void add_fill(OrderId passive, Quantity quantity) {
+        current_.quantity += quantity;
+        ++current_.order_count;
+        if (fill_size < fill_capacity) {
+            fills[fill_size++] = PassiveFill{passive, quantity};
+            ++current_.fill_count;
+        } else {
+            ++fills_dropped;
+        }
+    }
+
+    const LevelExecution& close() {
+        if (size < capacity) {
+            data[size++] = current_;
+        } else {
+            ++dropped;
+        }
+        return current_;
+    }
+
+    void clear() {
+        size = 0;
+        dropped = 0;
+        fill_size = 0;
+        fills_dropped = 0;
+    }
+
+    const LevelExecution* begin() const { return data; }
+    const LevelExecution* end() const { return data + size; }
+
+private:
+    LevelExecution current_{};
+};
+
+using PassiveFill = BasicPassiveFill<DefaultBookTraits>;
+using LevelExecution = BasicLevelExecution<DefaultBookTraits>;
+using ExecutionBuffer = BasicExecutionBuffer<DefaultBookTraits>;
+
+// Listener interface for BasicOrderBook. The book calls these members
+// directly, so a listener type resolves every event at compile time and
+// empty handlers compile away. Derive from NullListener to implement a subset.
+// Events carry the book's traits types; NullListener accepts any of them.
+struct NullListener {
+    template <typename Trade> void on_trade(const Trade&) {}
+    template <typename Event> void on_order_added(const Event&) {}
+    template <typename Event> void on_order_cancelled(const Event&) {}
+    template <typename Event> void on_order_modified(const Event&) {}
+    template <typename Update> void on_level_update(const Update&) {}
+    template <typename Execution> void on_level_execution(const Execution&) {}
+};
+
+// Callback types for market data events
+template <typename Traits>
+using BasicTradeCallback = std::function<void(const BasicTrade<Traits>&)>;
+using TradeCallback = BasicTradeCallback<DefaultBookTraits>;
+
+// Runtime adapter behind OrderBook::set_trade_callback
+template <typename Traits>
+class BasicCallbackListener : public NullListener {
+public:
+    using Trade = BasicTrade<Traits>;
+    using TradeCallback = BasicTradeCallback<Traits>;
+
+    void set_trade_callback(TradeCallback cb) { trade_callback_ = std::move(cb); }
+
+    void on_trade(const Trade& trade) {
+        if (trade_callback_) {
+            trade_callback_(trade);
+        }
+    }
+
+private:
+    TradeCallback trade_callback_;
+};
+
+using CallbackListener = BasicCallbackListener<DefaultBookTraits>;
+
+}  // namespace lob
@@ -0,0 +1,218 @@
+#pragma once
+
+#include "types.hpp"
+#include "price_level.hpp"
+#include "price_ladder.hpp"
+
+#include <map>
+#include <algorithm>
+#include <stdexcept>
+#include <iterator>
+#include <cstdint>
+#include <cstddef>
+
+namespace lob {
+
+// Inclusive tick band for ladder-backed books, in the book's price units
+struct LadderRange {
+    Price min_price = 0;
+    Price max_price = 0;
+    Price tick_size = 1;
+};
+
+// All price levels on one side of the book.
+// Map storage handles unbounded prices in O(log M); ladder storage gives
+// O(1) level access for instruments that trade inside a known tick band.
+template <typename Traits>
+class BasicBookSide {
+public:
+    using Price = typename Traits::Price;
+    using PriceLevel = BasicPriceLevel<Traits>;
+    using PriceLadder = BasicPriceLadder<Traits>;
+    using Quantity = typename Traits::Quantity;
+    using FillEstimate = BasicFillEstimate<Traits>;
+
+    // Map-backed side
+    explicit BasicBookSide(Side side) : side_(side), use_ladder_(false) {}
+
+    // Ladder-backed side over the given band; throws std::invalid_argument
+    // if the band does not fit the configuration's price type or is off
+    // its TICK_SIZE grid
+    BasicBookSide(Side side, const LadderRange& range, const PageOptions& pages = PageOptions())
+        : side_(side), use_ladder_(true),
+          ladder_(side, on_tick(narrow(range.min_price)), narrow(range.max_price),
+                  on_tick(narrow(range.tick_size)), pages) {}
+
+    // Whether a resting order at this price can be stored: on the
+    // configuration's tick, and inside the ladder band if there is one
+    bool accepts(Price price) const {
+        return price % Traits::TICK_SIZE == 0 && (!use_ladder_ || ladder_.contains(price));
+    }
+
+    PriceLevel* find(Price price) {
+        if (use_ladder_) return ladder_.find(price);
+        auto it = map_.find(price);
+        return it == map_.end() ? nullptr : &it->second;
+    }
+
+    const PriceLevel* find(Price price) const {
+        return const_cast<BasicBookSide*>(this)->find(price);
+    }
+
+    PriceLevel& get_or_insert(Price price) {
+        if (use_ladder_) return ladder_.get_or_insert(price);
+        return map_.try_emplace(price, price, side_).first->second;
+    }
+
+    // Remove a level once its last order has gone
+    void erase(const PriceLevel& level) {
+        if (use_ladder_) {
+            ladder_.erase(level);
+        } else {
+            map_.erase(level.price);
+        }
+    }
+
+    // Remove the best level (matching path: no search in map mode)
+    void erase_best() {
+        if (use_ladder_) {
+            ladder_.erase(*ladder_.best());
+        } else if (side_ == Side::Buy) {
+            map_.erase(std::prev(map_.end()));
+        } else {
+            map_.erase(map_.begin());
+        }
+    }
+
+    PriceLevel* best() {
+        if (use_ladder_) return ladder_.best();
+        if (map_.empty()) return nullptr;
+        return side_ == Side::Buy ? &map_.rbegin()->second : &map_.begin()->second;
+    }
+
+    const PriceLevel* best() const {
+        return const_cast<BasicBookSide*>(this)->best();
+    }
+
+    // Best live level strictly worse than price, or nullptr
+    const PriceLevel* next_worse(Price price) const {
+        if (use_ladder_) return ladder_.next_worse_level(price);
+        if (side_ == Side::Buy) {
+            auto it = map_.lower_bound(price);
+            return it == map_.begin() ? nullptr : &std::prev(it)->second;
+        }
+        auto it = map_.upper_bound(price);
+        return it == map_.end() ? nullptr : &it->second;
+    }
+
+    // Worst live level strictly better than price, or nullptr
+    const PriceLevel* next_better(Price price) const {
+        if (use_ladder_) return ladder_.next_better_level(price);
+        if (side_ == Side::Sell) {
+            auto it = map_.lower_bound(price);
+            return it == map_.begin() ? nullptr : &std::prev(it)->second;
+        }
+        auto it = map_.upper_bound(price);
+        return it == map_.end() ? nullptr : &it->second;
+    }
+
+    // Visit up to max_levels levels from best to worst
+    template <typename Fn>
+    void for_each_level(std::size_t max_levels, Fn&& fn) const {
+        if (use_ladder_) {
+            ladder_.for_each_level(max_levels, fn);
+            return;
+        }
+        std::size_t count = 0;
+        if (side_ == Side::Buy) {
+            for (auto it = map_.rbegin(); it != map_.rend() && count < max_levels; ++it, ++count) {
+                fn(it->second);
+            }
+        } else {
+            for (auto it = map_.begin(); it != map_.end() && count < max_levels; ++it, ++count) {
+                fn(it->second);
+            }
+        }
+    }
+
+    // Record a change to a level's total quantity (ladder depth scans read
+    // a mirrored copy; map levels are read in place)
+    void sync(const PriceLevel& level) {
+        if (use_ladder_) ladder_.sync(level);
+    }
+
+    // What a market order for qty would take from this side, best level
+    // first, without touching any order
+    FillEstimate estimate_fill(Quantity qty) const {
+        if (use_ladder_) return ladder_.estimate_fill(qty);
+        FillEstimate estimate;
+        if (qty == 0) return estimate;
+        std::uint64_t wanted = qty;
+        auto take = [&](const PriceLevel& level) {
+            std::uint64_t fill = std::min<std::uint64_t>(level.total_quantity, wanted);
+            wanted -= fill;
+            estimate.cost += fill * level.price;
+            estimate.worst_price = level.price;
+            ++estimate.levels;
+            return wanted == 0;
+        };
+        if (side_ == Side::Buy) {
+            for (auto it = map_.rbegin(); it != map_.rend() && !take(it->second); ++it) {}
+        } else {
+            for (auto it = map_.begin(); it != map_.end() && !take(it->second); ++it) {}
+        }
+        estimate.filled = static_cast<Quantity>(qty - wanted);
+        return estimate;
+    }
+
+    // Cache hint for an upcoming access at price (ladder only; map nodes
+    // cannot be located without walking the tree)
+    void prefetch(Price price) const {
+        if (use_ladder_) ladder_.prefetch(price);
+    }
+
+    // Fault in ladder storage; map nodes are allocated as levels appear
+    void warm_up() const noexcept {
+        if (use_ladder_) ladder_.warm_up();
+    }
+
+    std::size_t size() const { return use_ladder_ ? ladder_.size() : map_.size(); }
+    bool empty() const { return size() == 0; }
+
+    // Ladder: the mapped arrays. Map: an estimate of the tree nodes, one
+    // level plus a red-black node header (colour and three links) each,
+    // since std::map does not report its allocations.
+    std::size_t memory_bytes() const {
+        if (use_ladder_) return ladder_.memory_bytes();
+        return map_.size() * (sizeof(typename std::map<Price, PriceLevel>::value_type) +
+                              4 * sizeof(void*));
+    }
+    bool uses_ladder() const { return use_ladder_; }
+    const PriceLadder* ladder() const { return use_ladder_ ? &ladder_ : nullptr; }
+
+private:
+    static Price narrow(lob::Price price) {
+        if (!fits_in<Price>(price)) {
+            throw std::invalid_argument("BookSide: ladder band exceeds price range");
+        }
+        return static_cast<Price>(price);
+    }
+
+    static Price on_tick(Price price) {
+        if (price % Traits::TICK_SIZE != 0) {
+            throw std::invalid_argument("BookSide: ladder band is off the tick size");
+        }
+        return price;
+    }
+
+    Side side_;
+    bool use_ladder_;
+
+    // Price levels: bids best = rbegin, asks best = begin
+    std::map<Price, PriceLevel> map_;
+    PriceLadder ladder_;
+};
+
+using BookSide = BasicBookSide<DefaultBookTraits>;
+
+}  // namespace lob
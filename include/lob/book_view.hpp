@@ -0,0 +1,42 @@
+#pragma once
+
+#include "types.hpp"
+#include "depth_cache.hpp"
+#include "seqlock.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+namespace lob {
+
+// Consistent picture of a book after one input message, as published by
+// BasicOrderBook::set_published_view. Depth arrays hold the best
+// bid_count / ask_count levels, best first.
+template <std::size_t N, typename Traits = DefaultBookTraits>
+struct BookView {
+    using Price = typename Traits::Price;
+
+    std::uint64_t messages = 0;  // input messages applied when published
+    Price best_bid = INVALID_PRICE;
+    Price best_ask = INVALID_PRICE;
+    std::uint64_t total_trades = 0;
+    std::uint64_t total_volume = 0;
+    std::uint32_t bid_count = 0;
+    std::uint32_t ask_count = 0;
+    std::array<BasicDepthLevel<Traits>, N> bids{};
+    std::array<BasicDepthLevel<Traits>, N> asks{};
+
+    // 0 while an auction has the book crossed, as OrderBook::spread()
+    Price spread() const {
+        if (best_bid == INVALID_PRICE || best_ask == INVALID_PRICE) return INVALID_PRICE;
+        return best_ask > best_bid ? best_ask - best_bid : 0;
+    }
+};
+
+// Caller-owned publication slot: the matching thread stores, readers on
+// any thread load()
+template <std::size_t N, typename Traits = DefaultBookTraits>
+using PublishedBookView = SeqLock<BookView<N, Traits>>;
+
+}  // namespace lob
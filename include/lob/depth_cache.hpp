@@ -0,0 +1,106 @@
+#pragma once
+
+#include "types.hpp"
+#include "book_events.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+namespace lob {
+
+// One aggregated price level as seen by depth readers
+template <typename Traits>
+struct BasicDepthLevel {
+    typename Traits::Price price;
+    typename Traits::Quantity quantity;
+    std::uint32_t order_count;
+};
+
+using DepthLevel = BasicDepthLevel<DefaultBookTraits>;
+
+// Best N levels of one side, best first, kept in a fixed array so readers
+// get a contiguous view without touching the level storage. The book feeds
+// it every level change; when a cached level empties and the cache was
+// full, the next level below the cache is pulled in from the book.
+template <std::size_t N, typename Traits = DefaultBookTraits>
+class DepthCache {
+public:
+    using Price = typename Traits::Price;
+    using DepthLevel = BasicDepthLevel<Traits>;
+    using LevelUpdate = BasicLevelUpdate<Traits>;
+
+    explicit DepthCache(Side side = Side::Buy) : side_(side) {}
+
+    // Apply a level change. next_worse(price) must return the best live
+    // PriceLevel strictly worse than price, or nullptr.
+    template <typename NextWorse>
+    void apply(const LevelUpdate& update, NextWorse&& next_worse) {
+        std::size_t i = 0;
+        while (i < size_ && better(levels_[i].price, update.price)) ++i;
+        bool present = i < size_ && levels_[i].price == update.price;
+
+        if (update.order_count == 0) {
+            if (!present) return;
+            bool was_full = size_ == N;
+            for (std::size_t j = i + 1; j < size_; ++j) levels_[j - 1] = levels_[j];
+            --size_;
+            if (was_full) {
+                // Search below whichever is worse: the new last entry or the
+                // removed level (which may still be linked in the book)
+                Price from = i == size_ ? update.price : levels_[size_ - 1].price;
+                if (const auto* next = next_worse(from)) {
+                    levels_[size_++] = DepthLevel{next->price, next->total_quantity,
+                                                  next->order_count};
+                }
+            }
+            return;
+        }
+
+        DepthLevel level{update.price, update.total_quantity, update.order_count};
+        if (present) {
+            levels_[i] = level;
+        } else if (i < N) {
+            std::size_t last = size_ < N ? size_ : N - 1;  // drop the worst if full
+            for (std::size_t j = last; j > i; --j) levels_[j] = levels_[j - 1];
+            levels_[i] = level;
+            if (size_ < N) ++size_;
+        }
+    }
+
+    // Rebuild from scratch (after a restore)
+    void clear() { size_ = 0; }
+    void push_back(const DepthLevel& level) {
+        if (size_ < N) levels_[size_++] = level;
+    }
+
+    // Cached level at price, or nullptr
+    const DepthLevel* find(Price price) const {
+        for (std::size_t i = 0; i < size_; ++i) {
+            if (levels_[i].price == price) return &levels_[i];
+        }
+        return nullptr;
+    }
+
+    // True if find() is authoritative for price: the price is no worse than
+    // the last cached level, or the cache holds every level of the side
+    bool covers(Price price) const {
+        return size_ < N || !better(levels_[size_ - 1].price, price);
+    }
+
+    const DepthLevel* begin() const { return levels_.data(); }
+    const DepthLevel* end() const { return levels_.data() + size_; }
+    const DepthLevel& operator[](std::size_t i) const { return levels_[i]; }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    static constexpr std::size_t capacity() { return N; }
+
+private:
+    bool better(Price a, Price b) const { return side_ == Side::Buy ? a > b : a < b; }
+
+    std::array<DepthLevel, N> levels_{};
+    std::size_t size_ = 0;
+    Side side_;
+};
+
+}  // namespace lob
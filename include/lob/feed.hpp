@@ -0,0 +1,361 @@
+#pragma once
+
+#include "types.hpp"
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+namespace lob {
+
+// Decoder for the order messages of a NASDAQ TotalView-ITCH 5.0 style
+// feed. Messages are fixed-layout, big-endian, and each is framed by a
+// 2-byte big-endian length (the layout of the exchange's capture files
+// and of a TCP replay session). Every field is read in place from the
+// caller's buffer, so a receive buffer or a FeedFile mapping is decoded
+// with no copy, and each message turns into one call on the book's
+// market-by-order API (insert_order / execute_order / reduce_order /
+// cancel_order / reinsert_order) under the exchange's order reference.
+//
+// Only the seven messages that change the order book are decoded; system,
+// directory, trade and imbalance messages are counted as skipped. Prices
+// carry four implied decimals on the wire and are rescaled to the book's
+// PRICE_MULTIPLIER; a price that is zero or finer than one price unit makes
+// its message malformed.
+enum class FeedMessageType : char {
+    AddOrder = 'A',
+    AddOrderAttributed = 'F',  // add with market participant ID
+    OrderExecuted = 'E',
+    OrderExecutedWithPrice = 'C',
+    OrderCancel = 'X',         // partial cancel
+    OrderDelete = 'D',
+    OrderReplace = 'U'
+};
+
+constexpr std::uint32_t FEED_PRICE_SCALE = 10000;  // four implied decimals
+
+// Wire size of each decoded message, or 0 for types the decoder skips
+constexpr std::size_t feed_message_size(char type) {
+    switch (type) {
+    case 'A': return 36;
+    case 'F': return 40;
+    case 'E': return 31;
+    case 'C': return 36;
+    case 'X': return 23;
+    case 'D': return 19;
+    case 'U': return 35;
+    default: return 0;
+    }
+}
+
+namespace detail {
+
+// Field offsets shared by every message: type, stock locate,
+// tracking number, 48-bit nanosecond timestamp, then the body
+constexpr std::size_t FEED_LOCATE = 1;
+constexpr std::size_t FEED_BODY = 11;
+
+inline std::uint16_t load_be16(const char* p) {
+    std::uint16_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return __builtin_bswap16(v);
+}
+
+inline std::uint32_t load_be32(const char* p) {
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return __builtin_bswap32(v);
+}
+
+inline std::uint64_t load_be64(const char* p) {
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return __builtin_bswap64(v);
+}
+
+inline void store_be16(char* p, std::uint16_t v) {
+    v = __builtin_bswap16(v);
+    std::memcpy(p, &v, sizeof(v));
+}
+
+inline void store_be32(char* p, std::uint32_t v) {
+    v = __builtin_bswap32(v);
+    std::memcpy(p, &v, sizeof(v));
+}
+
+inline void store_be64(char* p, std::uint64_t v) {
+    v = __builtin_bswap64(v);
+    std::memcpy(p, &v, sizeof(v));
+}
+
+}  // namespace detail
+
+struct FeedConfig {
+    std::uint16_t locate = 0;  // stock locate to keep; 0 keeps every message
+};
+
+struct FeedStats {
+    std::uint64_t messages = 0;    // frames seen
+    std::uint64_t adds = 0;
+    std::uint64_t executions = 0;
+    std::uint64_t cancels = 0;     // partial cancels and deletes
+    std::uint64_t replaces = 0;
+    std::uint64_t skipped = 0;     // other message types or other symbols
+    std::uint64_t rejected = 0;    // book refused it (unknown or duplicate reference)
+    std::uint64_t malformed = 0;   // frame too short for its type, bad side, or a
+                                   // price finer than one price unit
+};
+
+// Drives one book from framed feed messages. The book must start empty
+// and take no add_order calls of its own (see insert_order).
+template <typename Book>
+class FeedDecoder {
+public:
+    using Price = typename Book::Price;
+    using Quantity = typename Book::Quantity;
+    using OrderId = typename Book::OrderId;
+
+    explicit FeedDecoder(Book& book, const FeedConfig& config = FeedConfig())
+        : book_(book), config_(config) {}
+
+    // Apply every complete frame in [data, data + size) and return the
+    // bytes consumed. A frame cut off at the end of the buffer is left
+    // unconsumed, to be passed again once the rest has arrived.
+    std::size_t decode(const void* data, std::size_t size) {
+        const char* base = static_cast<const char*>(data);
+        std::size_t offset = 0;
+        while (size - offset >= 2) {
+            std::size_t length = detail::load_be16(base + offset);
+            if (size - offset - 2 < length) break;
+            dispatch(base + offset + 2, length);
+            offset += 2 + length;
+        }
+        return offset;
+    }
+
+    // Apply one unframed message of length bytes (e.g. a message block from
+    // a MoldUDP64 packet). False if it was skipped, malformed or rejected.
+    bool dispatch(const char* msg, std::size_t length) {
+        ++stats_.messages;
+        if (length == 0) {
+            ++stats_.malformed;
+            return false;
+        }
+        std::size_t expected = feed_message_size(msg[0]);
+        if (expected == 0) {
+            ++stats_.skipped;
+            return false;
+        }
+        if (length < expected) {
+            ++stats_.malformed;
+            return false;
+        }
+        if (config_.locate != 0 && detail::load_be16(msg + detail::FEED_LOCATE) != config_.locate) {
+            ++stats_.skipped;
+            return false;
+        }
+
+        const char* body = msg + detail::FEED_BODY;
+        OrderId id;
+        if (!reference(detail::load_be64(body), id)) {
+            ++stats_.rejected;
+            return false;
+        }
+        bool ok = false;
+        switch (static_cast<FeedMessageType>(msg[0])) {
+        case FeedMessageType::AddOrder:
+        case FeedMessageType::AddOrderAttributed: {
+            char side = body[8];
+            Price px;
+            if ((side != 'B' && side != 'S') || !price(detail::load_be32(body + 21), px)) {
+                ++stats_.malformed;
+                return false;
+            }
+            ++stats_.adds;
+            auto ack = book_.insert_order(id, side == 'B' ? Side::Buy : Side::Sell, px,
+                                          quantity(detail::load_be32(body + 9)));
+            ok = ack.status != OrderStatus::Rejected;
+            break;
+        }
+        case FeedMessageType::OrderExecuted:
+            ++stats_.executions;
+            ok = book_.execute_order(id, quantity(detail::load_be32(body + 8)));
+            break;
+        case FeedMessageType::OrderExecutedWithPrice: {
+            Price px;
+            if (!price(detail::load_be32(body + 21), px)) {
+                ++stats_.malformed;
+                return false;
+            }
+            ++stats_.executions;
+            ok = book_.execute_order(id, quantity(detail::load_be32(body + 8)), px);
+            break;
+        }
+        case FeedMessageType::OrderCancel:
+            ++stats_.cancels;
+            ok = book_.reduce_order(id, quantity(detail::load_be32(body + 8)));
+            break;
+        case FeedMessageType::OrderDelete:
+            ++stats_.cancels;
+            ok = book_.cancel_order(id);
+            break;
+        case FeedMessageType::OrderReplace: {
+            Price px;
+            if (!price(detail::load_be32(body + 20), px)) {
+                ++stats_.malformed;
+                return false;
+            }
+            ++stats_.replaces;
+            OrderId new_id;
+            if (!reference(detail::load_be64(body + 8), new_id)) break;
+            auto ack = book_.reinsert_order(id, new_id, px,
+                                            quantity(detail::load_be32(body + 16)));
+            ok = ack.status != OrderStatus::Rejected;
+            break;
+        }
+        }
+        if (!ok) ++stats_.rejected;
+        return ok;
+    }
+
+    const FeedStats& stats() const { return stats_; }
+    Book& book() { return book_; }
+
+private:
+    // A reference beyond the book's OrderId width cannot be tracked
+    static bool reference(std::uint64_t ref, OrderId& id) {
+        if (!fits_in<OrderId>(ref)) return false;
+        id = static_cast<OrderId>(ref);
+        return true;
+    }
+
+    // Only whole price units convert: truncating a finer price would trade or rest
+    // at a different one, and zero would read as INVALID_PRICE
+    static bool price(std::uint32_t raw, Price& px) {
+        std::uint64_t scaled = std::uint64_t{raw} * Book::traits_type::PRICE_MULTIPLIER;
+        if (raw == 0 || scaled % FEED_PRICE_SCALE != 0 ||
+            !fits_in<Price>(scaled / FEED_PRICE_SCALE)) {
+            return false;
+        }
+        px = static_cast<Price>(scaled / FEED_PRICE_SCALE);
+        return true;
+    }
+
+    static Quantity quantity(std::uint32_t shares) { return static_cast<Quantity>(shares); }
+
+    Book& book_;
+    FeedConfig config_;
+    FeedStats stats_;
+};
+
+// Decode a whole buffer into book; returns the bytes consumed
+template <typename Book>
+std::size_t decode_feed(const void* data, std::size_t size, Book& book,
+                        const FeedConfig& config = FeedConfig()) {
+    FeedDecoder<Book> decoder(book, config);
+    return decoder.decode(data, size);
+}
+
+// Appends framed order messages to a byte buffer, in the layout
+// FeedDecoder reads. Used to build captures for tests and benchmarks;
+// prices are raw wire prices with four implied decimals.
+class FeedEncoder {
+public:
+    explicit FeedEncoder(std::uint16_t locate = 1) : locate_(locate) {}
+
+    void add_order(std::uint64_t ref, Side side, std::uint32_t shares, std::uint32_t price,
+                   std::uint64_t timestamp = 0) {
+        char* m = begin('A', timestamp);
+        detail::store_be64(m + 11, ref);
+        m[19] = side == Side::Buy ? 'B' : 'S';
+        detail::store_be32(m + 20, shares);
+        std::memcpy(m + 24, "SYMBOL  ", 8);
+        detail::store_be32(m + 32, price);
+    }
+
+    void execute(std::uint64_t ref, std::uint32_t shares, std::uint64_t timestamp = 0) {
+        char* m = begin('E', timestamp);
+        detail::store_be64(m + 11, ref);
+        detail::store_be32(m + 19, shares);
+        detail::store_be64(m + 23, ++match_number_);
+    }
+
+    void execute_at(std::uint64_t ref, std::uint32_t shares, std::uint32_t price,
+                    std::uint64_t timestamp = 0) {
+        char* m = begin('C', timestamp);
+        detail::store_be64(m + 11, ref);
+        detail::store_be32(m + 19, shares);
+        detail::store_be64(m + 23, ++match_number_);
+        m[31] = 'Y';  // printable
+        detail::store_be32(m + 32, price);
+    }
+
+    void cancel(std::uint64_t ref, std::uint32_t shares, std::uint64_t timestamp = 0) {
+        char* m = begin('X', timestamp);
+        detail::store_be64(m + 11, ref);
+        detail::store_be32(m + 19, shares);
+    }
+
+    void remove(std::uint64_t ref, std::uint64_t timestamp = 0) {
+        char* m = begin('D', timestamp);
+        detail::store_be64(m + 11, ref);
+    }
+
+    void replace(std::uint64_t ref, std::uint64_t new_ref, std::uint32_t shares,
+                 std::uint32_t price, std::uint64_t timestamp = 0) {
+        char* m = begin('U', timestamp);
+        detail::store_be64(m + 11, ref);
+        detail::store_be64(m + 19, new_ref);
+        detail::store_be32(m + 27, shares);
+        detail::store_be32(m + 31, price);
+    }
+
+    const std::vector<char>& buffer() const { return buffer_; }
+    const char* data() const { return buffer_.data(); }
+    std::size_t size() const { return buffer_.size(); }
+    void clear() { buffer_.clear(); }
+
+private:
+    // Frame a zeroed message of the type's size; returns its first byte
+    char* begin(char type, std::uint64_t timestamp) {
+        std::size_t length = feed_message_size(type);
+        std::size_t at = buffer_.size();
+        buffer_.resize(at + 2 + length);
+        char* frame = buffer_.data() + at;
+        detail::store_be16(frame, static_cast<std::uint16_t>(length));
+        char* m = frame + 2;
+        m[0] = type;
+        detail::store_be16(m + detail::FEED_LOCATE, locate_);
+        // 48-bit timestamp: the low six bytes of the big-endian value
+        char stamp[8];
+        detail::store_be64(stamp, timestamp);
+        std::memcpy(m + 5, stamp + 2, 6);
+        return m;
+    }
+
+    std::vector<char> buffer_;
+    std::uint64_t match_number_ = 0;
+    std::uint16_t locate_;
+};
+
+// Read-only mapping of a framed capture file. Throws std::system_error if
+// the file cannot be opened or mapped.
+class FeedFile {
+public:
+    explicit FeedFile(const std::string& path);
+    ~FeedFile();
+
+    FeedFile(const FeedFile&) = delete;
+    FeedFile& operator=(const FeedFile&) = delete;
+
+    const char* data() const { return static_cast<const char*>(map_); }
+    std::size_t size() const { return size_; }
+
+private:
+    void* map_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+}  // namespace lob
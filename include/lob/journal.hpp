@@ -0,0 +1,302 @@
+#pragma once
+
+#include "order_book.hpp"
+
+#include <string>
+#include <stdexcept>
+#include <cstdint>
+#include <cstddef>
+
+namespace lob {
+
+// Input kinds; 0 marks the unwritten (zero-filled) tail of the file
+enum class JournalOp : std::uint8_t {
+    End = 0,
+    Add = 1,
+    Cancel = 2,
+    Modify = 3,
+    Replace = 4,
+    BeginAuction = 5,
+    Uncross = 6
+};
+
+// One book input, fixed width so the log can be indexed and replayed
+// without parsing
+struct JournalRecord {
+    JournalOp op;
+    Side side;
+    OrderType type;
+    std::uint8_t reserved[5];
+    OrderId order_id;   // cancel / modify / replace target
+    Price price;        // add or replace price
+    Quantity quantity;  // add size, or new total for modify / replace
+};
+
+static_assert(sizeof(JournalRecord) == 32, "JournalRecord must stay 32 bytes");
+
+// First page of a journal file: format check plus the BookConfig fields
+// that decide how inputs are processed, so a replay builds the same book
+struct JournalHeader {
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::uint32_t record_size;
+    std::uint64_t pool_capacity;
+    std::uint64_t pool_max_capacity;
+    std::uint64_t pool_slab_size;
+    OrderId id_base;
+    OrderId id_limit;
+    Price ladder_min;
+    Price ladder_max;
+    Price ladder_tick;
+    LevelStorage level_storage;
+};
+
+constexpr std::uint64_t JOURNAL_MAGIC = 0x4c4f424a524e4c31ull;  // "LOBJRNL1"
+constexpr std::uint32_t JOURNAL_VERSION = 4;  // 2: in-place modify increase, Replace; 3: auctions; 4: id_limit
+constexpr std::size_t JOURNAL_HEADER_SIZE = 4096;  // records start on a page boundary
+
+JournalHeader make_journal_header(const BookConfig& config);
+BookConfig book_config_from(const JournalHeader& header);
+
+// Append-only writer over a pre-sized, memory-mapped file, created or
+// truncated on open. append() is a copy into the mapping; commit() hands
+// newly written pages to the kernel with MS_ASYNC and returns immediately,
+// so the caller never waits on the disk. sync() is the blocking variant
+// for orderly shutdown.
+//
+// Records sit in the page cache as soon as append() returns, so they
+// survive a process crash; commit()/sync() bound what a host crash loses.
+// Opening, sizing or mapping the file throws std::system_error.
+class JournalWriter {
+public:
+    JournalWriter(const std::string& path, const BookConfig& config, std::size_t max_records);
+    ~JournalWriter();
+
+    JournalWriter(const JournalWriter&) = delete;
+    JournalWriter& operator=(const JournalWriter&) = delete;
+
+    // False once max_records have been written
+    bool append(const JournalRecord& record) {
+        if (count_ == capacity_) return false;
+        records_[count_++] = record;
+        return true;
+    }
+
+    bool append_add(Side side, OrderType type, Price price, Quantity quantity) {
+        return append(JournalRecord{JournalOp::Add, side, type, {}, 0, price, quantity});
+    }
+    bool append_cancel(OrderId id) {
+        return append(JournalRecord{JournalOp::Cancel, Side::Buy, OrderType::Limit, {}, id, 0, 0});
+    }
+    bool append_modify(OrderId id, Quantity quantity) {
+        return append(
+            JournalRecord{JournalOp::Modify, Side::Buy, OrderType::Limit, {}, id, 0, quantity});
+    }
+    bool append_replace(OrderId id, Price price, Quantity quantity) {
+        return append(
+            JournalRecord{JournalOp::Replace, Side::Buy, OrderType::Limit, {}, id, price, quantity});
+    }
+    bool append_phase(JournalOp op) {
+        return append(JournalRecord{op, Side::Buy, OrderType::Limit, {}, 0, 0, 0});
+    }
+
+    void commit();  // schedule write-back of records since the last commit
+    void sync();    // write back everything and wait for it
+
+    std::size_t size() const { return count_; }
+    std::size_t capacity() const { return capacity_; }
+    bool full() const { return count_ == capacity_; }
+
+    // Records written so far, in place in the mapping
+    const JournalRecord* begin() const { return records_; }
+    const JournalRecord* end() const { return records_ + count_; }
+
+private:
+    void* map_ = nullptr;
+    std::size_t map_size_ = 0;
+    JournalRecord* records_ = nullptr;
+    std::size_t capacity_ = 0;
+    std::size_t count_ = 0;
+    std::size_t committed_ = 0;
+    int fd_ = -1;
+};
+
+// Read-only view of a journal file. Records are read in place from the
+// mapping; the log ends at the first End record (or the end of the file),
+// so a journal cut short by a crash replays up to its last full record.
+// Throws std::system_error if the file cannot be mapped and
+// std::runtime_error if it is not a journal.
+class JournalReader {
+public:
+    explicit JournalReader(const std::string& path);
+    ~JournalReader();
+
+    JournalReader(const JournalReader&) = delete;
+    JournalReader& operator=(const JournalReader&) = delete;
+
+    const JournalHeader& header() const { return *header_; }
+    const JournalRecord* begin() const { return records_; }
+    const JournalRecord* end() const { return records_ + count_; }
+    std::size_t size() const { return count_; }
+
+private:
+    void* map_ = nullptr;
+    std::size_t map_size_ = 0;
+    const JournalHeader* header_ = nullptr;
+    const JournalRecord* records_ = nullptr;
+    std::size_t count_ = 0;
+};
+
+// Apply one journaled input. False for End, which applies nothing.
+template <typename Book>
+bool apply_journal_record(const JournalRecord& r, Book& book, TradeBuffer& discard) {
+    switch (r.op) {
+    case JournalOp::Add:
+        book.add_order(r.side, r.type, r.price, r.quantity, discard);
+        discard.clear();
+        return true;
+    case JournalOp::Cancel:
+        book.cancel_order(r.order_id);
+        return true;
+    case JournalOp::Modify:
+        book.modify_order(r.order_id, r.quantity);
+        return true;
+    case JournalOp::Replace:
+        book.replace_order(r.order_id, r.price, r.quantity, discard);
+        discard.clear();
+        return true;
+    case JournalOp::BeginAuction:
+        book.begin_auction();
+        return true;
+    case JournalOp::Uncross:
+        book.uncross();
+        return true;
+    case JournalOp::End:
+        break;
+    }
+    return false;
+}
+
+// Apply journaled inputs to a book built from the journal's header config.
+// The book is deterministic, so order IDs, timestamps and counters come out
+// identical to the original run. Returns the number of records applied.
+template <typename Book>
+std::size_t replay_journal(const JournalRecord* first, const JournalRecord* last, Book& book) {
+    TradeBuffer discard;  // trades are counted by the book, not kept
+    std::size_t applied = 0;
+    for (const JournalRecord* r = first; r != last; ++r, ++applied) {
+        if (!apply_journal_record(*r, book, discard)) break;
+    }
+    return applied;
+}
+
+template <typename Book>
+std::size_t replay_journal(const JournalReader& reader, Book& book) {
+    return replay_journal(reader.begin(), reader.end(), book);
+}
+
+// Snapshot + tail replay: restore the snapshot into an empty book, then
+// apply the journal records written after it was taken. Returns the number
+// of records replayed; throws std::runtime_error if the snapshot does not
+// restore or is newer than the journal.
+template <typename Book>
+std::size_t recover(Book& book, const std::string& snapshot_path, const JournalReader& journal) {
+    SnapshotFile file(snapshot_path);
+    const SnapshotHeader* header = file.header();
+    if (!header || header->journal_position > journal.size() ||
+        !book.restore(file.data(), file.size())) {
+        throw std::runtime_error("snapshot does not restore against this journal");
+    }
+    return replay_journal(journal.begin() + header->journal_position, journal.end(), book);
+}
+
+// An order book that journals every input before applying it. An input the
+// journal cannot hold is not applied (add is Rejected with JournalFull,
+// cancel / modify return false, replace is Rejected), so the log always
+// replays to this book.
+template <typename Listener>
+class BasicJournaledBook {
+public:
+    using Book = BasicOrderBook<Listener>;
+
+    BasicJournaledBook(const std::string& path, const BookConfig& config,
+                       std::size_t max_records, std::size_t commit_interval = 4096,
+                       Listener listener = Listener())
+        : journal_(path, config, max_records), book_(config, std::move(listener)),
+          commit_interval_(commit_interval == 0 ? 1 : commit_interval) {}
+
+    OrderAck add_order(Side side, OrderType type, Price price, Quantity quantity,
+                       TradeBuffer& trades) {
+        if (!journal_.append_add(side, type, price, quantity)) {
+            OrderAck ack;
+            ack.status = OrderStatus::Rejected;
+            ack.reject_reason = RejectReason::JournalFull;
+            ack.remaining_quantity = quantity;
+            return ack;
+        }
+        maybe_commit();
+        return book_.add_order(side, type, price, quantity, trades);
+    }
+
+    bool cancel_order(OrderId id) {
+        if (!journal_.append_cancel(id)) return false;
+        maybe_commit();
+        return book_.cancel_order(id);
+    }
+
+    bool modify_order(OrderId id, Quantity new_quantity) {
+        if (!journal_.append_modify(id, new_quantity)) return false;
+        maybe_commit();
+        return book_.modify_order(id, new_quantity);
+    }
+
+    OrderAck replace_order(OrderId id, Price new_price, Quantity new_quantity,
+                           TradeBuffer& trades) {
+        if (!journal_.append_replace(id, new_price, new_quantity)) {
+            OrderAck ack;
+            ack.order_id = id;
+            ack.status = OrderStatus::Rejected;
+            ack.reject_reason = RejectReason::JournalFull;
+            return ack;
+        }
+        maybe_commit();
+        return book_.replace_order(id, new_price, new_quantity, trades);
+    }
+
+    // False (and the phase unchanged) if the journal is full
+    bool begin_auction() {
+        if (!journal_.append_phase(JournalOp::BeginAuction)) return false;
+        maybe_commit();
+        book_.begin_auction();
+        return true;
+    }
+
+    // An empty result (price INVALID_PRICE) and no trades if the journal is full
+    AuctionResult uncross(TradeBuffer& trades) {
+        if (!journal_.append_phase(JournalOp::Uncross)) return AuctionResult();
+        maybe_commit();
+        return book_.uncross(trades);
+    }
+
+    // Snapshot tagged with the current journal position, for recover()
+    bool save_snapshot(const std::string& path) const {
+        return book_.save_snapshot(path, journal_.size());
+    }
+
+    Book& book() { return book_; }
+    const Book& book() const { return book_; }
+    JournalWriter& journal() { return journal_; }
+
+private:
+    void maybe_commit() {
+        if (journal_.size() % commit_interval_ == 0) journal_.commit();
+    }
+
+    JournalWriter journal_;
+    Book book_;
+    std::size_t commit_interval_;
+};
+
+using JournaledBook = BasicJournaledBook<CallbackListener>;
+
+}  // namespace lob
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "memory.hpp"
+
+#include <stdexcept>
+#include <cstdint>
+#include <cstddef>
+
+namespace lob {
+
+// Hierarchical 64-ary bitset over a fixed number of slots. Layer 0 holds
+// one bit per slot; bit j of a word in layer d+1 is set iff word j of
+// layer d is non-zero. Searching for the next set slot climbs until a word
+// has a candidate bit and then descends with one count-zeros per layer, so
+// a lookup costs O(depth) word operations however far away the slot is.
+// A band of 262,144 slots is three layers deep. All layers share one
+// page-mapped allocation.
+class LevelBitmap {
+public:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+    static constexpr std::size_t MAX_DEPTH = 6;  // 64^6 slots
+
+    LevelBitmap() = default;
+
+    explicit LevelBitmap(std::size_t slots, const PageOptions& pages = PageOptions())
+        : slots_(slots) {
+        std::size_t words = (slots + 63) / 64;
+        std::size_t total = 0;
+        for (;;) {
+            if (depth_ == MAX_DEPTH) throw std::invalid_argument("LevelBitmap: too many slots");
+            offset_[depth_] = total;
+            words_in_[depth_] = words;
+            total += words;
+            ++depth_;
+            if (words <= 1) break;
+            words = (words + 63) / 64;
+        }
+        words_ = PageArray<std::uint64_t>(total, pages);
+    }
+
+    bool test(std::size_t i) const { return (layer(0)[i >> 6] >> (i & 63)) & 1u; }
+
+    void set(std::size_t i) {
+        for (std::size_t d = 0; d < depth_; ++d) {
+            std::uint64_t& word = layer(d)[i >> 6];
+            bool was_empty = word == 0;
+            word |= std::uint64_t{1} << (i & 63);
+            if (!was_empty) return;  // parents already mark this word
+            i >>= 6;
+        }
+    }
+
+    void clear(std::size_t i) {
+        for (std::size_t d = 0; d < depth_; ++d) {
+            std::uint64_t& word = layer(d)[i >> 6];
+            word &= ~(std::uint64_t{1} << (i & 63));
+            if (word != 0) return;  // word still live: parents unchanged
+            i >>= 6;
+        }
+    }
+
+    // First set slot >= from, or npos
+    std::size_t find_next(std::size_t from) const {
+        if (from >= slots_) return npos;
+        std::size_t d = 0;
+        std::size_t idx = from;
+        for (;;) {
+            std::size_t word = idx >> 6;
+            std::uint64_t bits = layer(d)[word] & (~std::uint64_t{0} << (idx & 63));
+            if (bits != 0) {
+                idx = (word << 6) + static_cast<std::size_t>(__builtin_ctzll(bits));
+                break;
+            }
+            if (++d == depth_) return npos;
+            idx = word + 1;  // next word below = next bit in this layer
+            if (idx >= words_in_[d - 1]) return npos;
+        }
+        while (d-- > 0) {
+            idx = (idx << 6) + static_cast<std::size_t>(__builtin_ctzll(layer(d)[idx]));
+        }
+        return idx;
+    }
+
+    // Last set slot <= from, or npos
+    std::size_t find_prev(std::size_t from) const {
+        if (slots_ == 0) return npos;
+        if (from >= slots_) from = slots_ - 1;
+        std::size_t d = 0;
+        std::size_t idx = from;
+        for (;;) {
+            std::size_t word = idx >> 6;
+            std::uint64_t bits = layer(d)[word] & (~std::uint64_t{0} >> (63 - (idx & 63)));
+            if (bits != 0) {
+                idx = (word << 6) + 63 - static_cast<std::size_t>(__builtin_clzll(bits));
+                break;
+            }
+            if (word == 0 || ++d == depth_) return npos;
+            idx = word - 1;
+        }
+        while (d-- > 0) {
+            idx = (idx << 6) + 63 - static_cast<std::size_t>(__builtin_clzll(layer(d)[idx]));
+        }
+        return idx;
+    }
+
+    // Hint the cache to load the leaf word for slot i
+    void prefetch(std::size_t i) const { __builtin_prefetch(&layer(0)[i >> 6]); }
+
+    void warm_up() const noexcept { words_.warm_up(); }
+
+    std::size_t size() const { return slots_; }
+    std::size_t depth() const { return depth_; }
+    const PageBuffer& memory() const { return words_.memory(); }
+
+private:
+    std::uint64_t* layer(std::size_t d) { return words_.data() + offset_[d]; }
+    const std::uint64_t* layer(std::size_t d) const { return words_.data() + offset_[d]; }
+
+    PageArray<std::uint64_t> words_;    // layer 0 first, then each parent layer
+    std::size_t offset_[MAX_DEPTH] = {};
+    std::size_t words_in_[MAX_DEPTH] = {};
+    std::size_t depth_ = 0;
+    std::size_t slots_ = 0;
+};
+
+}  // namespace lob
@@ -4,5 +4,17 @@
 #include "lob/types.hpp"
 #include "lob/order.hpp"
 #include "lob/order_pool.hpp"
+#include "lob/order_index.hpp"
 #include "lob/price_level.hpp"
+#include "lob/price_ladder.hpp"
+#include "lob/book_side.hpp"
+#include "lob/book_events.hpp"
 #include "lob/order_book.hpp"
+#include "lob/matching_engine.hpp"
+#include "lob/spsc_ring.hpp"
+#include "lob/pipeline.hpp"
+#include "lob/journal.hpp"
+#include "lob/snapshot.hpp"
+#include "lob/feed.hpp"
+#include "lob/replication.hpp"
+#include "lob/simulation.hpp"
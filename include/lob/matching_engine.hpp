@@ -0,0 +1,216 @@
+#pragma once
+
+#include "order_book.hpp"
+
+#include <vector>
+#include <memory>
+#include <thread>
+#include <stdexcept>
+#include <cstdint>
+#include <cstddef>
+
+namespace lob {
+
+using SymbolId = std::uint32_t;
+
+// Order IDs carry their symbol in the high bits, so any ID routes back to
+// its book with a shift: 24 bits of symbol, 40 bits of per-book sequence.
+// A book therefore issues at most 2^40 - 1 IDs; past that its add_order
+// calls are Rejected with IdsExhausted rather than spilling into the next
+// symbol's range.
+constexpr unsigned SYMBOL_SHIFT = 40;
+constexpr SymbolId MAX_SYMBOLS = SymbolId{1} << 24;
+
+inline SymbolId symbol_of(OrderId id) { return static_cast<SymbolId>(id >> SYMBOL_SHIFT); }
+inline OrderId symbol_id_base(SymbolId symbol) { return OrderId{symbol} << SYMBOL_SHIFT; }
+inline OrderId symbol_id_limit(SymbolId symbol) {
+    return symbol_id_base(symbol) | ((OrderId{1} << SYMBOL_SHIFT) - 1);
+}
+
+// Pin the calling thread to one CPU; false if the core is invalid or the
+// kernel refused
+bool pin_current_thread(int core);
+
+// One worker thread and the symbols it owns
+struct ShardConfig {
+    int core = -1;       // CPU to pin the worker to; -1 = unpinned
+    int numa_node = -1;  // node for the shard's book memory; -1 = per BookConfig
+};
+
+struct EngineConfig {
+    std::vector<ShardConfig> shards{ShardConfig{}};
+    SymbolId max_symbols = 1024;  // size of the flat symbol table
+    bool warm_up = true;          // warm each book up on its worker before run()'s work
+};
+
+// Many order books, one per symbol, grouped into shards. Each shard is run
+// by exactly one worker thread, which is the only writer of its books, so
+// the matching path takes no locks. Symbols resolve to books through a flat
+// table indexed by SymbolId, and order IDs through symbol_of().
+//
+// The routing calls (add_order, cancel_order, ...) must be made from the
+// thread that owns the symbol's shard once run() has started. Adding
+// symbols is set-up work and must happen before run().
+template <typename Listener>
+class BasicMatchingEngine {
+public:
+    using Book = BasicOrderBook<Listener>;
+
+    explicit BasicMatchingEngine(const EngineConfig& config = EngineConfig())
+        : config_(config), shard_symbols_(config.shards.size()) {
+        if (config_.shards.empty()) {
+            throw std::invalid_argument("MatchingEngine needs at least one shard");
+        }
+        if (config_.max_symbols > MAX_SYMBOLS) {
+            throw std::invalid_argument("MatchingEngine symbol table exceeds ID range");
+        }
+        table_.resize(config_.max_symbols);
+    }
+
+    BasicMatchingEngine(const BasicMatchingEngine&) = delete;
+    BasicMatchingEngine& operator=(const BasicMatchingEngine&) = delete;
+
+    // Create the book for a symbol on a given shard. Throws if the symbol is
+    // out of range, already listed, or the shard does not exist.
+    Book& add_symbol(SymbolId symbol, std::size_t shard, const BookConfig& config,
+                     Listener listener = Listener()) {
+        if (symbol >= table_.size()) throw std::out_of_range("symbol outside table");
+        if (table_[symbol].book) throw std::invalid_argument("symbol already listed");
+        if (shard >= shard_symbols_.size()) throw std::out_of_range("no such shard");
+
+        BookConfig book_config = config;
+        book_config.id_base = symbol_id_base(symbol);
+        book_config.id_limit = symbol_id_limit(symbol);
+        if (book_config.pool.pages.numa_node < 0) {
+            book_config.pool.pages.numa_node = config_.shards[shard].numa_node;
+        }
+        book_config.warm_up = false;  // done on the owning worker in run()
+
+        Entry& entry = table_[symbol];
+        entry.book = std::make_unique<Book>(book_config, std::move(listener));
+        entry.shard = static_cast<std::uint32_t>(shard);
+        shard_symbols_[shard].push_back(symbol);
+        ++symbol_count_;
+        return *entry.book;
+    }
+
+    // Place the symbol on the shard with the fewest symbols
+    Book& add_symbol(SymbolId symbol, const BookConfig& config, Listener listener = Listener()) {
+        std::size_t target = 0;
+        for (std::size_t s = 1; s < shard_symbols_.size(); ++s) {
+            if (shard_symbols_[s].size() < shard_symbols_[target].size()) target = s;
+        }
+        return add_symbol(symbol, target, config, std::move(listener));
+    }
+
+    // O(1) — book for a symbol, or nullptr if it is not listed
+    Book* book(SymbolId symbol) {
+        return symbol < table_.size() ? table_[symbol].book.get() : nullptr;
+    }
+    const Book* book(SymbolId symbol) const {
+        return symbol < table_.size() ? table_[symbol].book.get() : nullptr;
+    }
+
+    // Book that issued an order ID
+    Book* book_for_order(OrderId id) { return book(symbol_of(id)); }
+
+    // Routing: same semantics as the OrderBook calls, plus UnknownSymbol
+    OrderResult add_order(SymbolId symbol, Side side, OrderType type, Price price,
+                          Quantity quantity) {
+        Book* b = book(symbol);
+        if (!b) return unknown_symbol<OrderResult>(quantity);
+        return b->add_order(side, type, price, quantity);
+    }
+
+    OrderAck add_order(SymbolId symbol, Side side, OrderType type, Price price,
+                       Quantity quantity, TradeBuffer& trades) {
+        Book* b = book(symbol);
+        if (!b) return unknown_symbol<OrderAck>(quantity);
+        return b->add_order(side, type, price, quantity, trades);
+    }
+
+    bool cancel_order(OrderId id) {
+        Book* b = book_for_order(id);
+        return b && b->cancel_order(id);
+    }
+
+    bool modify_order(OrderId id, Quantity new_quantity) {
+        Book* b = book_for_order(id);
+        return b && b->modify_order(id, new_quantity);
+    }
+
+    OrderResult replace_order(OrderId id, Price new_price, Quantity new_quantity) {
+        Book* b = book_for_order(id);
+        if (!b) return unknown_order<OrderResult>(id);
+        return b->replace_order(id, new_price, new_quantity);
+    }
+
+    OrderAck replace_order(OrderId id, Price new_price, Quantity new_quantity,
+                           TradeBuffer& trades) {
+        Book* b = book_for_order(id);
+        if (!b) return unknown_order<OrderAck>(id);
+        return b->replace_order(id, new_price, new_quantity, trades);
+    }
+
+    // Start one worker per shard, pin it, warm its books up and call
+    // work(shard) on it. Returns once every worker's work has returned.
+    template <typename Fn>
+    void run(Fn&& work) {
+        std::vector<std::thread> workers;
+        workers.reserve(shard_symbols_.size());
+        for (std::size_t s = 0; s < shard_symbols_.size(); ++s) {
+            workers.emplace_back([this, &work, s] {
+                if (config_.shards[s].core >= 0) pin_current_thread(config_.shards[s].core);
+                if (config_.warm_up) {
+                    for (SymbolId symbol : shard_symbols_[s]) table_[symbol].book->warm_up();
+                }
+                work(s);
+            });
+        }
+        for (std::thread& t : workers) t.join();
+    }
+
+    std::size_t shard_count() const { return shard_symbols_.size(); }
+    std::size_t shard_of(SymbolId symbol) const { return table_[symbol].shard; }
+    const std::vector<SymbolId>& symbols_on(std::size_t shard) const {
+        return shard_symbols_[shard];
+    }
+    std::size_t symbol_count() const { return symbol_count_; }
+    SymbolId max_symbols() const { return static_cast<SymbolId>(table_.size()); }
+
+private:
+    struct Entry {
+        std::unique_ptr<Book> book;
+        std::uint32_t shard = 0;
+    };
+
+    template <typename Result>
+    static Result unknown_symbol(Quantity quantity) {
+        Result result;
+        result.status = OrderStatus::Rejected;
+        result.reject_reason = RejectReason::UnknownSymbol;
+        result.remaining_quantity = quantity;
+        return result;
+    }
+
+    // An ID whose symbol has no book cannot be resting anywhere
+    template <typename Result>
+    static Result unknown_order(OrderId id) {
+        Result result;
+        result.order_id = id;
+        result.status = OrderStatus::Rejected;
+        result.reject_reason = RejectReason::UnknownOrder;
+        return result;
+    }
+
+    EngineConfig config_;
+    std::vector<Entry> table_;                       // indexed by SymbolId
+    std::vector<std::vector<SymbolId>> shard_symbols_;
+    std::size_t symbol_count_ = 0;
+};
+
+using MatchingEngine = BasicMatchingEngine<CallbackListener>;
+
+extern template class BasicMatchingEngine<CallbackListener>;
+
+}  // namespace lob
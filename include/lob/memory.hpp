@@ -0,0 +1,85 @@
+#pragma once
+
+#include <new>
+#include <utility>
+#include <cstddef>
+
+namespace lob {
+
+// How page-backed storage (pool slabs, index and ladder tables) is mapped
+struct PageOptions {
+    bool huge_pages = false;  // 2MB pages: MAP_HUGETLB, else transparent huge pages
+    bool prefault = false;    // fault every page in at map time
+    int numa_node = -1;       // preferred NUMA node for the pages; -1 = first touch
+};
+
+constexpr std::size_t SMALL_PAGE_SIZE = 4096;
+constexpr std::size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+// Write-fault every page of [data, data + bytes) without changing its contents
+void touch_pages(void* data, std::size_t bytes) noexcept;
+
+// Anonymous, zero-filled memory mapped straight from the kernel.
+// Move-only; unmapped on destruction. allocate() never throws — an empty
+// buffer signals failure so callers on the hot path can report an error code.
+class PageBuffer {
+public:
+    PageBuffer() = default;
+    ~PageBuffer();
+
+    PageBuffer(PageBuffer&& other) noexcept;
+    PageBuffer& operator=(PageBuffer&& other) noexcept;
+    PageBuffer(const PageBuffer&) = delete;
+    PageBuffer& operator=(const PageBuffer&) = delete;
+
+    // Rounds bytes up to the page size in use
+    static PageBuffer allocate(std::size_t bytes, const PageOptions& options) noexcept;
+
+    void* data() const { return data_; }
+    std::size_t size() const { return size_; }
+    bool huge_pages() const { return huge_pages_; }
+    int numa_node() const { return numa_node_; }  // -1 if not bound to a node
+    explicit operator bool() const { return data_ != nullptr; }
+
+    void warm_up() const noexcept { touch_pages(data_, size_); }
+
+private:
+    void release() noexcept;
+
+    void* data_ = nullptr;
+    std::size_t size_ = 0;
+    bool huge_pages_ = false;
+    int numa_node_ = -1;
+};
+
+// Fixed-size array in page-mapped memory, for tables that should honour
+// PageOptions. Elements start zero-filled; T must be valid as all-zero
+// bytes or be assigned before use. Throws std::bad_alloc if mapping fails,
+// since it is only built at construction time.
+template <typename T>
+class PageArray {
+public:
+    PageArray() = default;
+
+    PageArray(std::size_t count, const PageOptions& options)
+        : memory_(PageBuffer::allocate(count * sizeof(T), options)), count_(count) {
+        if (count != 0 && !memory_) throw std::bad_alloc();
+    }
+
+    T* data() { return static_cast<T*>(memory_.data()); }
+    const T* data() const { return static_cast<const T*>(memory_.data()); }
+    T& operator[](std::size_t i) { return data()[i]; }
+    const T& operator[](std::size_t i) const { return data()[i]; }
+
+    std::size_t size() const { return count_; }
+    std::size_t bytes() const { return memory_.size(); }
+    const PageBuffer& memory() const { return memory_; }
+
+    void warm_up() const noexcept { memory_.warm_up(); }
+
+private:
+    PageBuffer memory_;
+    std::size_t count_ = 0;
+};
+
+}  // namespace lob
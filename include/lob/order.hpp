@@ -1,52 +1,97 @@
 #pragma once
 
 #include "types.hpp"
-#include <chrono>
+#include <cstdint>
+#include <cstddef>
 
 namespace lob {
 
-// Intrusive doubly-linked list order node.
-// No dynamic allocation per order — pointers managed by PriceLevel.
-struct Order {
+template <typename Traits>
+struct BasicPriceLevel;
+
+// Index of an order slot in its OrderPool
+using OrderHandle = std::uint32_t;
+constexpr OrderHandle NULL_HANDLE = 0xFFFFFFFFu;
+
+namespace detail {
+
+// Nodes of exactly half a cache line are aligned to it so that no node
+// straddles two lines; narrower nodes pack at pointer alignment instead
+template <typename Traits>
+constexpr std::size_t order_alignment() {
+    return sizeof(typename Traits::OrderId) + sizeof(typename Traits::Quantity) == 16
+               ? 32
+               : alignof(void*);
+}
+
+}  // namespace detail
+
+// Hot part of an order: exactly the fields matching and cancels touch.
+// 32 bytes and 32-byte aligned with 64-bit fields, so two resting orders
+// share a cache line; 24 bytes with 32-bit fields. List links are pool
+// handles managed by PriceLevel; price and side are read through the level.
+template <typename Traits>
+struct alignas(detail::order_alignment<Traits>()) BasicOrder {
+    using OrderId = typename Traits::OrderId;
+    using Quantity = typename Traits::Quantity;
+
     OrderId id = 0;
-    Price price = INVALID_PRICE;
-    Quantity quantity = 0;
-    Quantity filled_quantity = 0;
-    Side side = Side::Buy;
-    OrderType type = OrderType::Limit;
-    OrderStatus status = OrderStatus::New;
+    Quantity remaining = 0;
 
-    // Intrusive list pointers (managed by PriceLevel)
-    Order* prev = nullptr;
-    Order* next = nullptr;
+    // Level this order rests on (set by PriceLevel), so fills and cancels
+    // update the level without a price lookup
+    BasicPriceLevel<Traits>* level = nullptr;
 
-    // Timestamp for price-time priority verification
-    std::uint64_t timestamp = 0;
+    // Intrusive list links (managed by PriceLevel)
+    OrderHandle prev = NULL_HANDLE;
+    OrderHandle next = NULL_HANDLE;
 
-    Quantity remaining() const { return quantity - filled_quantity; }
-    bool is_filled() const { return filled_quantity >= quantity; }
+    bool is_filled() const { return remaining == 0; }
 
     void reset() {
         id = 0;
-        price = INVALID_PRICE;
-        quantity = 0;
-        filled_quantity = 0;
-        side = Side::Buy;
-        type = OrderType::Limit;
-        status = OrderStatus::New;
-        prev = nullptr;
-        next = nullptr;
-        timestamp = 0;
+        remaining = 0;
+        level = nullptr;
+        prev = NULL_HANDLE;
+        next = NULL_HANDLE;
     }
 };
 
+using Order = BasicOrder<DefaultBookTraits>;
+
+static_assert(sizeof(Order) == 32, "Order node must stay half a cache line");
+static_assert(sizeof(BasicOrder<CompactBookTraits>) == 24,
+              "Compact order node should be three quarters of the default");
+
+// Cold part of an order, kept in a parallel array in OrderPool.
+// Only touched on submission, modify and reporting — never while walking a level.
+template <typename Traits>
+struct BasicOrderInfo {
+    using Price = typename Traits::Price;
+    using Quantity = typename Traits::Quantity;
+
+    Price price = INVALID_PRICE;
+    Quantity quantity = 0;  // original (or modified) total quantity
+    std::uint64_t timestamp = 0;  // for price-time priority verification
+    Side side = Side::Buy;
+    OrderType type = OrderType::Limit;
+    OrderStatus status = OrderStatus::New;
+
+    void reset() { *this = BasicOrderInfo{}; }
+};
+
+using OrderInfo = BasicOrderInfo<DefaultBookTraits>;
+
 // Trade execution record
-struct Trade {
-    OrderId buy_order_id;
-    OrderId sell_order_id;
-    Price price;
-    Quantity quantity;
+template <typename Traits>
+struct BasicTrade {
+    typename Traits::OrderId buy_order_id;
+    typename Traits::OrderId sell_order_id;
+    typename Traits::Price price;
+    typename Traits::Quantity quantity;
     std::uint64_t timestamp;
 };
 
+using Trade = BasicTrade<DefaultBookTraits>;
+
 }  // namespace lob
@@ -3,98 +3,623 @@
 #include "types.hpp"
 #include "order.hpp"
 #include "price_level.hpp"
+#include "book_side.hpp"
 #include "order_pool.hpp"
+#include "order_index.hpp"
+#include "book_events.hpp"
+#include "depth_cache.hpp"
+#include "book_view.hpp"
+#include "telemetry.hpp"
+#include "snapshot.hpp"
 
-#include <map>
-#include <unordered_map>
 #include <vector>
-#include <functional>
+#include <string>
 #include <cstdint>
 
 namespace lob {
 
 // Result of an order submission
-struct OrderResult {
-    OrderId order_id = 0;
+template <typename Traits>
+struct BasicOrderResult {
+    typename Traits::OrderId order_id = 0;
     OrderStatus status = OrderStatus::New;
-    Quantity filled_quantity = 0;
-    Quantity remaining_quantity = 0;
-    std::vector<Trade> trades;
+    typename Traits::Quantity filled_quantity = 0;
+    typename Traits::Quantity remaining_quantity = 0;
+    RejectReason reject_reason = RejectReason::None;
+    std::vector<BasicTrade<Traits>> trades;
 };
 
-// Callback types for market data events
-using TradeCallback = std::function<void(const Trade&)>;
+using OrderResult = BasicOrderResult<DefaultBookTraits>;
 
-class OrderBook {
+// Result of an order submission into a caller-supplied TradeBuffer
+template <typename Traits>
+struct BasicOrderAck {
+    typename Traits::OrderId order_id = 0;
+    OrderStatus status = OrderStatus::New;
+    typename Traits::Quantity filled_quantity = 0;
+    typename Traits::Quantity remaining_quantity = 0;
+    RejectReason reject_reason = RejectReason::None;
+    std::size_t trade_count = 0;  // trades generated by this order
+};
+
+using OrderAck = BasicOrderAck<DefaultBookTraits>;
+
+// Caller-owned, fixed-capacity trade output. The book appends fills and
+// never allocates; trades beyond capacity still execute but are only
+// counted in dropped. Call clear() to reuse the storage.
+template <typename Traits>
+struct BasicTradeBuffer {
+    using Trade = BasicTrade<Traits>;
+
+    Trade* data = nullptr;
+    std::size_t capacity = 0;
+    std::size_t size = 0;
+    std::size_t dropped = 0;
+
+    BasicTradeBuffer() = default;
+    BasicTradeBuffer(Trade* storage, std::size_t cap) : data(storage), capacity(cap) {}
+
+    void push(const Trade& trade) {
+        if (size < capacity) {
+            data[size++] = trade;
+        } else {
+            ++dropped;
+        }
+    }
+
+    void clear() {
+        size = 0;
+        dropped = 0;
+    }
+
+    const Trade* begin() const { return data; }
+    const Trade* end() const { return data + size; }
+};
+
+using TradeBuffer = BasicTradeBuffer<DefaultBookTraits>;
+
+// One entry of an add_orders batch
+template <typename Traits>
+struct BasicOrderRequest {
+    Side side = Side::Buy;
+    OrderType type = OrderType::Limit;
+    typename Traits::Price price = 0;
+    typename Traits::Quantity quantity = 0;
+};
+
+using OrderRequest = BasicOrderRequest<DefaultBookTraits>;
+
+// Equilibrium of a call auction: the price at which the most quantity
+// crosses, and how much of the larger side is left unmatched there
+template <typename Traits>
+struct BasicAuctionResult {
+    typename Traits::Price price = INVALID_PRICE;  // INVALID_PRICE if nothing crosses
+    typename Traits::Quantity volume = 0;          // executed at price
+    typename Traits::Quantity surplus = 0;         // unmatched at price on surplus_side
+    Side surplus_side = Side::Buy;
+    std::size_t trade_count = 0;                   // uncross() only
+};
+
+using AuctionResult = BasicAuctionResult<DefaultBookTraits>;
+
+// Bytes held by each part of a book (see memory_stats()). Page-mapped
+// structures report their mapping, touched or not.
+struct BookMemoryStats {
+    std::size_t pool = 0;        // order nodes and info, every mapped slab
+    std::size_t index = 0;       // order ID table
+    std::size_t bid_levels = 0;  // ladder arrays, or estimated map nodes
+    std::size_t ask_levels = 0;
+    std::size_t book = 0;        // the book object: depth caches, counters, sides
+
+    std::size_t total() const { return pool + index + bid_levels + ask_levels + book; }
+};
+
+// Queue depth histogram buckets: bucket b counts levels holding
+// [2^b, 2^(b+1)) live orders; the last bucket is open-ended
+constexpr std::size_t QUEUE_DEPTH_BUCKETS = 16;
+
+// How full the book's structures are (see occupancy_stats()), for sizing
+// PoolConfig::capacity and the ladder band from production data
+template <typename Traits>
+struct BasicOccupancyStats {
+    using Price = typename Traits::Price;
+
+    // Order pool
+    std::size_t orders = 0;            // live orders
+    std::size_t tombstones = 0;        // lazily cancelled nodes still linked
+    std::size_t pool_capacity = 0;
+    std::size_t pool_max_capacity = 0;
+    std::size_t pool_high_water = 0;   // most slots ever in use at once
+
+    // Order index
+    std::size_t index_slots = 0;
+    double index_load = 0;             // entries / slots
+    double mean_probe = 0;             // slots read per successful lookup
+    std::size_t max_probe = 0;
+
+    // Levels and their queues
+    std::size_t bid_levels = 0;
+    std::size_t ask_levels = 0;
+    std::size_t ladder_ticks = 0;      // slots per ladder side; 0 when map-backed
+    double mean_queue_depth = 0;       // live orders per level
+    std::size_t max_queue_depth = 0;
+    std::size_t queue_depth[QUEUE_DEPTH_BUCKETS] = {};
+
+    // Resting price span per side; INVALID_PRICE for an empty side
+    Price bid_low = INVALID_PRICE;
+    Price bid_high = INVALID_PRICE;
+    Price ask_low = INVALID_PRICE;
+    Price ask_high = INVALID_PRICE;
+};
+
+using OccupancyStats = BasicOccupancyStats<DefaultBookTraits>;
+
+// Construction options for an OrderBook. Prices and IDs are given at full
+// width; a book with narrower fields throws std::invalid_argument from its
+// constructor if the ladder band or id_base does not fit.
+struct BookConfig {
+    // Order pool sizing; set pool.max_capacity to let the pool grow by slabs.
+    // pool.pages also applies to the order index and ladder tables, so one
+    // NUMA node / huge page setting covers all of the book's hot memory.
+    PoolConfig pool;
+
+    // Ladder storage needs a tick band; limit orders outside it are rejected
+    LevelStorage level_storage = LevelStorage::Map;
+    LadderRange ladder;
+
+    // Call warm_up() from the constructor
+    bool warm_up = false;
+
+    // Order IDs are id_base + 1, id_base + 2, ...; lets several books share
+    // one ID space (see MatchingEngine)
+    OrderId id_base = 0;
+    // Last ID the book may issue (0 = the largest OrderId); add_order is
+    // Rejected with IdsExhausted once it has been handed out
+    OrderId id_limit = 0;
+
+    // Lazy cancellation: cancel_order takes the order out of the index and
+    // its level's totals but leaves the node linked as a tombstone, so
+    // neither queue neighbour is touched. Matching unlinks tombstones as it
+    // reaches them; compact() sweeps the rest. Suits flow where most orders
+    // are cancelled before they trade, at the cost of pool slots held until
+    // reclaimed.
+    bool lazy_cancel = false;
+};
+
+// Levels per side kept in the top-of-book depth cache by default
+constexpr std::size_t DEFAULT_DEPTH_LEVELS = 10;
+
+// Limit order book and matching engine for one instrument.
+// Listener receives trade, order and level events (see book_events.hpp);
+// OrderBook is the CallbackListener instantiation. Traits (types.hpp) sets
+// the field widths of orders, levels, trades and IDs and the price
+// multiplier. DepthLevels sets how many levels per side bid_top() /
+// ask_top() maintain; 0 disables the cache.
+template <typename Listener, typename Traits = DefaultBookTraits,
+          std::size_t DepthLevels = DEFAULT_DEPTH_LEVELS>
+class BasicOrderBook {
 public:
-    explicit OrderBook(std::size_t pool_capacity = 1'000'000);
+    using Price = typename Traits::Price;
+    using Quantity = typename Traits::Quantity;
+    using OrderId = typename Traits::OrderId;
+    using Order = BasicOrder<Traits>;
+    using OrderInfo = BasicOrderInfo<Traits>;
+    using Trade = BasicTrade<Traits>;
+    using OrderResult = BasicOrderResult<Traits>;
+    using OrderAck = BasicOrderAck<Traits>;
+    using OrderRequest = BasicOrderRequest<Traits>;
+    using TradeBuffer = BasicTradeBuffer<Traits>;
+    using OrderEvent = BasicOrderEvent<Traits>;
+    using LevelUpdate = BasicLevelUpdate<Traits>;
+    using LevelDeltaBuffer = BasicLevelDeltaBuffer<Traits>;
+    using LevelExecution = BasicLevelExecution<Traits>;
+    using ExecutionBuffer = BasicExecutionBuffer<Traits>;
+    using TradeCallback = BasicTradeCallback<Traits>;
+    using PriceLevel = BasicPriceLevel<Traits>;
+    using PriceLadder = BasicPriceLadder<Traits>;
+    using BookSide = BasicBookSide<Traits>;
+    using OrderPool = BasicOrderPool<Traits>;
+    using OrderIndex = BasicOrderIndex<Traits>;
+    using FillEstimate = BasicFillEstimate<Traits>;
+    using AuctionResult = BasicAuctionResult<Traits>;
+    using OccupancyStats = BasicOccupancyStats<Traits>;
+    using traits_type = Traits;
+
+    static constexpr std::size_t DEPTH_LEVELS = DepthLevels;
+    using DepthLevel = BasicDepthLevel<Traits>;
+    using TopLevels = DepthCache<DEPTH_LEVELS, Traits>;
+    using PublishedView = PublishedBookView<DEPTH_LEVELS, Traits>;
 
-    // Core operations
+    explicit BasicOrderBook(std::size_t pool_capacity = 1'000'000);
+    explicit BasicOrderBook(const BookConfig& config, Listener listener = Listener());
+
+    // Core operations. Market, IOC and FOK orders never rest: they match
+    // from a node on the stack, so they take no pool slot or index entry,
+    // and any unfilled remainder is reported Cancelled. A FOK order is
+    // first checked against the opposite side's level totals and Rejected
+    // with InsufficientLiquidity, before any trade, if it cannot fill.
     OrderResult add_order(Side side, OrderType type, Price price, Quantity quantity);
+    // Allocation-free variant: fills are appended to the caller's buffer
+    OrderAck add_order(Side side, OrderType type, Price price, Quantity quantity,
+                       TradeBuffer& trades);
     bool cancel_order(OrderId order_id);
     bool modify_order(OrderId order_id, Quantity new_quantity);
 
-    // Market data queries — all O(1)
+    // Cancel/replace: move a resting order to new_price with new_quantity as
+    // its total size (filled part included), keeping its ID, pool node and
+    // index entry. A same-price reduce keeps time priority; any other change
+    // re-queues the order at the tail of its target level, matching it first
+    // if the new price crosses. Unknown IDs are Rejected with UnknownOrder
+    // and out-of-band prices with PriceOutOfBand, leaving the order as it
+    // was; new_quantity at or below the filled amount cancels it.
+    // filled_quantity and trade_count cover fills caused by the replace.
+    OrderResult replace_order(OrderId order_id, Price new_price, Quantity new_quantity);
+    OrderAck replace_order(OrderId order_id, Price new_price, Quantity new_quantity,
+                           TradeBuffer& trades);
+
+    // Call auction. After begin_auction(), limit orders (and replaces) rest
+    // without matching, so the book may cross; market, IOC and FOK orders
+    // are Rejected with AuctionPhase. uncross() then executes everything that crosses
+    // at one equilibrium price in a single pass, trading resting orders in
+    // price-time priority on both sides, and returns the book to
+    // continuous matching. The price maximises executed volume; among the
+    // limit prices that do, those leaving the least imbalance win. If they
+    // all leave a buy surplus the highest is used, if all a sell surplus
+    // the lowest; otherwise (balanced, or a surplus either way) the middle
+    // of them on a valid tick. Trades carry both resting IDs.
+    void begin_auction() { phase_ = TradingPhase::Auction; }
+    AuctionResult uncross(TradeBuffer& trades);
+    AuctionResult uncross() {
+        TradeBuffer no_trades;
+        return uncross(no_trades);
+    }
+    // The price and volume uncross() would execute now; the book is untouched
+    AuctionResult indicative_uncross() const;
+    TradingPhase phase() const { return phase_; }
+
+    // Market-by-order entry points for books rebuilt from an exchange feed,
+    // where matching has already happened upstream and orders carry the
+    // exchange's IDs. None of them match. The largest ID rested so far is
+    // tracked like a generated one, so snapshot()/restore() round-trip; a
+    // book fed this way should still not take add_order calls, whose
+    // generated IDs could collide with later exchange IDs.
+    //
+    // insert_order rests quantity at price under order_id; it is Rejected
+    // with DuplicateId if the ID is zero or already resting, and with
+    // PriceOutOfBand / PoolExhausted as add_order would be.
+    OrderAck insert_order(OrderId order_id, Side side, Price price, Quantity quantity);
+    // Fill up to quantity of a resting order against an unseen aggressor
+    // (reported with order ID 0); the trade prints at price, or at the
+    // order's own price if price is INVALID_PRICE. False if unknown.
+    bool execute_order(OrderId order_id, Quantity quantity, Price price = INVALID_PRICE);
+    // Cancel quantity of a resting order's open size, keeping its time
+    // priority; the order goes once nothing is left. False if unknown.
+    bool reduce_order(OrderId order_id, Quantity quantity);
+    // The exchange's cancel/replace: retire order_id and rest the same
+    // side under new_id at the tail of new_price. Rejected with
+    // UnknownOrder, DuplicateId or PriceOutOfBand, leaving the book as it
+    // was; zero quantity just removes the order.
+    OrderAck reinsert_order(OrderId order_id, OrderId new_id, Price new_price,
+                            Quantity new_quantity);
+
+    // Batch entry points with the same effect as calling add_order /
+    // cancel_order once per entry, in order. acks[i] (and results[i], if
+    // given) receive the outcome of entry i; fills of the whole batch are
+    // appended to trades, acks[i].trade_count of them per entry. Index
+    // slots, pool nodes and ladder levels of later entries are prefetched
+    // while earlier ones are processed.
+    void add_orders(const OrderRequest* requests, std::size_t count, OrderAck* acks,
+                    TradeBuffer& trades);
+    // Returns the number of orders cancelled
+    std::size_t cancel_orders(const OrderId* ids, std::size_t count, bool* results = nullptr);
+
+    // Fault in every pool page, index slot and ladder slot so the first
+    // orders do not pay for page faults. Call on the thread (and core) that
+    // will run the book, before trading starts.
+    void warm_up() noexcept;
+
+    // Snapshot / restore (image layout in snapshot.hpp). snapshot() writes
+    // the image into out and returns its size, or 0 if capacity is too
+    // small; journal_position records how much of the journal it covers.
+    // restore() loads an image into an empty book with the same level
+    // storage, keeping FIFO order, IDs and counters, and emits no listener
+    // events. It returns false if the book is not empty or the image is
+    // malformed or incompatible; images are checked before anything is
+    // applied.
+    std::size_t snapshot_size() const { return snapshot_bytes(orders_.size()); }
+    std::size_t snapshot(void* out, std::size_t capacity, std::uint64_t journal_position = 0) const;
+    bool restore(const void* image, std::size_t size);
+
+    // File variants; load_snapshot throws std::system_error if the file
+    // cannot be opened
+    bool save_snapshot(const std::string& path, std::uint64_t journal_position = 0) const;
+    bool load_snapshot(const std::string& path);
+
+    // Unlink and free every tombstone left by lazy cancels (see
+    // BookConfig::lazy_cancel); returns how many were reclaimed. O(levels +
+    // linked orders), meant for idle time. Also run automatically when
+    // the pool is exhausted.
+    std::size_t compact();
+
+    // Drop every order and level and return IDs, counters and phase to
+    // their freshly constructed values, keeping the pool slabs, index and
+    // ladder mapped, so one book can run scenario after scenario without
+    // paying for fresh pages. O(linked orders); emits no listener events.
+    void reset();
+    std::size_t tombstones() const { return tombstones_; }
+
+    // Market data queries. Best prices are O(1). Level lookups are O(1) on
+    // ladder storage; on map storage they are served from the depth cache
+    // when the price is within it, else O(log L). A book crossed during an
+    // auction reports a spread of 0.
     Price best_bid() const;
     Price best_ask() const;
     Price spread() const;
     Quantity volume_at_price(Side side, Price price) const;
     std::uint32_t order_count_at_price(Side side, Price price) const;
+    // Open quantity of a resting order; 0 if the ID is not resting
+    Quantity open_quantity(OrderId order_id) const;
+
+    // Pre-trade checks for a market order of quantity on side (a buy walks
+    // the asks). Nothing is modified and nothing is allocated.
+    // cost_to_fill reports how much would fill, the cost and the worst price
+    // reached; price_for_quantity is the volume-weighted average price of
+    // those fills in price units, 0 if the opposite side is empty. Ladder
+    // storage scans a dense per-level quantity array in vector-width
+    // blocks; map storage walks the levels.
+    FillEstimate cost_to_fill(Side side, Quantity quantity) const {
+        return side_of(side == Side::Buy ? Side::Sell : Side::Buy).estimate_fill(quantity);
+    }
+    double price_for_quantity(Side side, Quantity quantity) const {
+        return cost_to_fill(side, quantity).average_price();
+    }
 
     // Book state
     std::size_t total_orders() const { return orders_.size(); }
+    const OrderPool& pool() const { return pool_; }
     std::size_t bid_levels() const { return bids_.size(); }
     std::size_t ask_levels() const { return asks_.size(); }
     bool empty() const { return orders_.empty(); }
 
+    // Bytes per structure; O(slabs). Trade vectors returned in OrderResult
+    // belong to the caller and are not counted.
+    BookMemoryStats memory_stats() const {
+        BookMemoryStats stats;
+        stats.pool = pool_.memory_bytes();
+        stats.index = orders_.memory().size();
+        stats.bid_levels = bids_.memory_bytes();
+        stats.ask_levels = asks_.memory_bytes();
+        stats.book = sizeof(*this);
+        return stats;
+    }
+
+    // Pool, index and level occupancy. Walks the index table and every
+    // level: for monitoring between bursts, not for the matching path.
+    OccupancyStats occupancy_stats() const;
+
     // Depth snapshot: returns (price, quantity) pairs from best to worst
     std::vector<std::pair<Price, Quantity>> bid_depth(std::size_t levels) const;
     std::vector<std::pair<Price, Quantity>> ask_depth(std::size_t levels) const;
+    // Allocation-free variants: fill up to levels entries of out, return the count
+    std::size_t bid_depth(std::pair<Price, Quantity>* out, std::size_t levels) const;
+    std::size_t ask_depth(std::pair<Price, Quantity>* out, std::size_t levels) const;
+
+    // Best DEPTH_LEVELS levels per side, best first, maintained as levels
+    // change; reading them never walks the level storage
+    const TopLevels& bid_top() const { return bid_top_; }
+    const TopLevels& ask_top() const { return ask_top_; }
+
+    // Incremental market data: while set, the buffer is cleared at the start
+    // of every add / cancel / modify call and collects that call's level
+    // changes, coalesced per level (a batch call is one message). nullptr
+    // turns it off. The listener still sees every individual change.
+    void set_level_deltas(LevelDeltaBuffer* buffer) { deltas_ = buffer; }
 
-    // Register trade callback
-    void set_trade_callback(TradeCallback cb) { trade_callback_ = std::move(cb); }
+    // Conflated trades: while set, the buffer is cleared at the start of
+    // every add / cancel / modify call and collects one LevelExecution per
+    // price level each aggressor sweeps, with the passive (ID, quantity)
+    // list alongside. The listener's on_level_execution sees each one as
+    // its level is finished. Individual trades still reach the trade sink
+    // and on_trade. nullptr turns it off.
+    void set_level_executions(ExecutionBuffer* buffer) { executions_ = buffer; }
+
+    // Published view for readers on other threads: while set, the book
+    // stores its BBO, bid_top() / ask_top() and trade counters into view at
+    // the end of every add / cancel / modify call (and on set and restore).
+    // Readers load() consistent copies without blocking the matching
+    // thread. nullptr turns it off.
+    void set_published_view(PublishedView* view) {
+        view_ = view;
+        if (view_) publish_view();
+    }
+
+    // Register trade callback (CallbackListener books only)
+    void set_trade_callback(TradeCallback cb) { listener_.set_trade_callback(std::move(cb)); }
+
+    Listener& listener() { return listener_; }
+    const Listener& listener() const { return listener_; }
 
     // Statistics
     std::uint64_t total_trades() const { return trade_count_; }
     std::uint64_t total_volume() const { return total_volume_; }
 
 private:
-    // Match an incoming order against the opposite side of the book
-    void match_order(Order* order, OrderResult& result);
-    void match_against_asks(Order* order, OrderResult& result);
-    void match_against_bids(Order* order, OrderResult& result);
+    // Shared add path; Sink receives each trade through push(const Trade&)
+    template <typename Sink>
+    OrderAck submit_order(Side side, OrderType type, Price price, Quantity quantity, Sink& sink);
+
+    // Match an incoming order against the opposite side of the book.
+    // Type and limit come from the caller so matching never reads OrderInfo.
+    template <typename Sink>
+    void match_order(Order& order, Side side, OrderType type, Price limit, Sink& sink);
+    template <typename Sink>
+    void match_against_asks(Order& order, OrderType type, Price limit, Sink& sink);
+    template <typename Sink>
+    void match_against_bids(Order& order, OrderType type, Price limit, Sink& sink);
 
-    // Execute a trade between two orders
-    void execute_trade(Order* aggressive, Order* passive, Quantity qty, OrderResult& result);
+    // Execute a trade between the aggressor and a resting order
+    template <typename Sink>
+    void execute_trade(Order& aggressive, Side aggressor_side, Order& passive, Quantity qty,
+                       Sink& sink);
+
+    // Bracket the fills one aggressor takes from one level
+    void open_level_execution(const Order& aggressive, Side aggressor_side,
+                              const PriceLevel& level) {
+        if (executions_) {
+            executions_->open(aggressive.id, aggressor_side, level.price, timestamp_counter_);
+        }
+    }
+    void close_level_execution() {
+        if (executions_) {
+            const LevelExecution& execution = executions_->close();
+            LOB_PROBE(Dispatch);
+            listener_.on_level_execution(execution);
+        }
+    }
 
     // Insert a resting order into the book
-    void insert_into_book(Order* order);
+    void insert_into_book(OrderHandle h, Side side, Price price);
+
+    void notify_level(const PriceLevel& level) {
+        LevelUpdate update{level.side, level.price, level.total_quantity, level.order_count};
+        side_of(level.side).sync(level);
+        if (deltas_) deltas_->record(update);
+        if constexpr (DEPTH_LEVELS > 0) {
+            const BookSide& side = side_of(level.side);
+            auto next_worse = [&side](Price price) { return side.next_worse(price); };
+            (level.side == Side::Buy ? bid_top_ : ask_top_).apply(update, next_worse);
+        }
+        LOB_PROBE(Dispatch);
+        listener_.on_level_update(update);
+    }
+
+    // Drop a level with no live orders, freeing any tombstones still
+    // linked to it
+    void erase_level(PriceLevel& level) {
+        release_tombstones(level);
+        side_of(level.side).erase(level);
+    }
+    void release_tombstones(PriceLevel& level);
+
+    void reclaim_tombstone(PriceLevel& level, OrderHandle h) {
+        level.unlink(pool_, h);
+        pool_.deallocate(h);
+        --tombstones_;
+    }
+
+    // Oldest live order of a non-empty level, dropping tombstones ahead of it
+    OrderHandle live_front(PriceLevel& level) {
+        OrderHandle h = level.head;
+        while (pool_[h].remaining == 0) {
+            OrderHandle next = pool_[h].next;
+            reclaim_tombstone(level, h);
+            h = next;
+        }
+        return h;
+    }
+
+    // Pool slot for a new order; an exhausted pool first gets back the
+    // slots held by tombstones
+    OrderHandle allocate_order() {
+        OrderHandle h = pool_.allocate();
+        if (h == NULL_HANDLE && tombstones_ > 0) {
+            compact();
+            h = pool_.allocate();
+        }
+        return h;
+    }
+
+    // Fill-or-kill pre-check, read-only: whether the opposite side holds
+    // quantity at prices no worse than limit. Level totals leave out
+    // tombstones, so this agrees with what matching would fill.
+    bool fillable(Side side, Price limit, Quantity quantity) const {
+        if (quantity == 0) return true;
+        FillEstimate estimate = cost_to_fill(side, quantity);
+        if (estimate.filled < quantity) return false;
+        return side == Side::Buy ? estimate.worst_price <= limit : estimate.worst_price >= limit;
+    }
+
+    // Reload both depth caches from the level storage
+    void rebuild_depth_cache();
+
+    // Brackets one public input: the delta buffer describes that message
+    // and the published view is refreshed once it has been applied
+    struct MessageScope {
+        explicit MessageScope(BasicOrderBook& b) : book(b) {
+            ++book.messages_;
+            if (book.deltas_) book.deltas_->clear();
+            if (book.executions_) book.executions_->clear();
+        }
+        ~MessageScope() {
+            if (book.view_) book.publish_view();
+        }
+        BasicOrderBook& book;
+    };
 
-    // Remove empty price levels
-    void remove_price_level_if_empty(Side side, Price price);
+    void publish_view();
+
+    // Cancel body shared by cancel_order, cancel_orders and modify_order
+    bool cancel_resting(OrderId order_id);
+
+    // Replace body shared by replace_order and modify_order; h is the
+    // indexed handle of order_id
+    template <typename Sink>
+    OrderAck replace_resting(OrderId order_id, OrderHandle h, Price new_price,
+                             Quantity new_quantity, Sink& sink);
+
+    // Resting orders only: side and price are read through the level
+    static OrderEvent order_event(const Order& order) {
+        return OrderEvent{order.id, order.level->side, order.level->price, order.remaining};
+    }
 
     // Generate monotonic order IDs and timestamps
     OrderId next_order_id() { return ++next_id_; }
     std::uint64_t next_timestamp() { return ++timestamp_counter_; }
 
-    // Price levels: bids sorted descending (rbegin = best), asks sorted ascending (begin = best)
-    std::map<Price, PriceLevel> bids_;
-    std::map<Price, PriceLevel> asks_;
+    // How many entries ahead the batch APIs prefetch
+    static constexpr std::size_t PREFETCH_DISTANCE = 8;
+
+    BookSide& side_of(Side side) { return side == Side::Buy ? bids_ : asks_; }
+    const BookSide& side_of(Side side) const { return side == Side::Buy ? bids_ : asks_; }
+
+    // Price levels per side, map- or ladder-backed (see BookConfig)
+    BookSide bids_;
+    BookSide asks_;
 
-    // O(1) order lookup by ID
-    std::unordered_map<OrderId, Order*> orders_;
+    // O(1) order lookup by ID (open addressing, sized from pool capacity)
+    OrderIndex orders_;
 
     // Memory pool: zero heap allocation on hot path
     OrderPool pool_;
 
     // Counters
     OrderId next_id_ = 0;
+    OrderId id_base_ = 0;
+    OrderId id_limit_ = 0;
     std::uint64_t timestamp_counter_ = 0;
     std::uint64_t trade_count_ = 0;
     std::uint64_t total_volume_ = 0;
 
-    // Optional callback
-    TradeCallback trade_callback_;
+    // Top-of-book depth, updated from notify_level
+    TopLevels bid_top_{Side::Buy};
+    TopLevels ask_top_{Side::Sell};
+
+    // Event sink, dispatched statically
+    Listener listener_;
+    LevelDeltaBuffer* deltas_ = nullptr;
+    ExecutionBuffer* executions_ = nullptr;
+    PublishedView* view_ = nullptr;
+    std::uint64_t messages_ = 0;
+    TradingPhase phase_ = TradingPhase::Continuous;
+    bool lazy_cancel_ = false;
+    std::size_t tombstones_ = 0;  // lazily cancelled nodes still linked
 };
 
+using OrderBook = BasicOrderBook<CallbackListener>;
+
+// Compiled once in src/order_book.cpp
+extern template class BasicOrderBook<CallbackListener>;
+
 }  // namespace lob
+
+#include "order_book_impl.hpp"
@@ -0,0 +1,1328 @@
+#pragma once
+
+// Template definitions for BasicOrderBook; included by order_book.hpp.
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace lob {
+
+namespace detail {
+
+template <typename Traits>
+BasicBookSide<Traits> make_side(Side side, const BookConfig& config) {
+    if (config.level_storage == LevelStorage::Ladder) {
+        return BasicBookSide<Traits>(side, config.ladder, config.pool.pages);
+    }
+    return BasicBookSide<Traits>(side);
+}
+
+// First ID of a book; throws if the configured base does not fit OrderId
+template <typename OrderId>
+OrderId narrow_id_base(lob::OrderId id_base) {
+    if (!fits_in<OrderId>(id_base)) {
+        throw std::invalid_argument("BookConfig: id_base exceeds the order ID range");
+    }
+    return static_cast<OrderId>(id_base);
+}
+
+// Last ID a book may issue; an unset or too-wide limit is the type's maximum
+template <typename OrderId>
+OrderId narrow_id_limit(lob::OrderId id_limit) {
+    if (id_limit == 0 || !fits_in<OrderId>(id_limit)) {
+        return std::numeric_limits<OrderId>::max();
+    }
+    return static_cast<OrderId>(id_limit);
+}
+
+inline BookConfig config_with_capacity(std::size_t pool_capacity) {
+    BookConfig config;
+    config.pool.capacity = pool_capacity;
+    return config;
+}
+
+// Adapts OrderResult::trades to the sink interface used by matching
+template <typename Trade>
+struct TradeVectorSink {
+    std::vector<Trade>& trades;
+    void push(const Trade& trade) { trades.push_back(trade); }
+};
+
+}  // namespace detail
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+BasicOrderBook<Listener, Traits, DepthLevels>::BasicOrderBook(std::size_t pool_capacity)
+    : BasicOrderBook(detail::config_with_capacity(pool_capacity)) {}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+BasicOrderBook<Listener, Traits, DepthLevels>::BasicOrderBook(const BookConfig& config,
+                                                              Listener listener)
+    : bids_(detail::make_side<Traits>(Side::Buy, config)),
+      asks_(detail::make_side<Traits>(Side::Sell, config)),
+      orders_(config.pool.capacity, config.pool.pages),
+      pool_(config.pool),
+      next_id_(detail::narrow_id_base<OrderId>(config.id_base)),
+      id_base_(next_id_),
+      id_limit_(detail::narrow_id_limit<OrderId>(config.id_limit)),
+      listener_(std::move(listener)), lazy_cancel_(config.lazy_cancel) {
+    if (config.warm_up) warm_up();
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+void BasicOrderBook<Listener, Traits, DepthLevels>::warm_up() noexcept {
+    pool_.warm_up();
+    orders_.warm_up();
+    bids_.warm_up();
+    asks_.warm_up();
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+auto BasicOrderBook<Listener, Traits, DepthLevels>::add_order(Side side, OrderType type,
+                                                              Price price, Quantity quantity)
+    -> OrderResult {
+    MessageScope message(*this);
+    OrderResult result;
+    detail::TradeVectorSink<Trade> sink{result.trades};
+    OrderAck ack = submit_order(side, type, price, quantity, sink);
+    result.order_id = ack.order_id;
+    result.status = ack.status;
+    result.filled_quantity = ack.filled_quantity;
+    result.remaining_quantity = ack.remaining_quantity;
+    result.reject_reason = ack.reject_reason;
+    return result;
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+auto BasicOrderBook<Listener, Traits, DepthLevels>::add_order(Side side, OrderType type,
+                                                              Price price, Quantity quantity,
+                                                              TradeBuffer& trades) -> OrderAck {
+    MessageScope message(*this);
+    return submit_order(side, type, price, quantity, trades);
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+template <typename Sink>
+auto BasicOrderBook<Listener, Traits, DepthLevels>::submit_order(Side side, OrderType type,
+                                                                 Price price, Quantity quantity,
+                                                                 Sink& sink) -> OrderAck {
+    LOB_PROBE(AddOrder);
+    OrderAck result;
+
+    // Issuing past the limit would wrap into another book's ID range
+    if (next_id_ >= id_limit_) {
+        result.status = OrderStatus::Rejected;
+        result.reject_reason = RejectReason::IdsExhausted;
+        result.remaining_quantity = quantity;
+        return result;
+    }
+
+    // Orders that cannot rest have no price to wait at through an auction
+    if (type != OrderType::Limit && phase_ == TradingPhase::Auction) {
+        result.status = OrderStatus::Rejected;
+        result.reject_reason = RejectReason::AuctionPhase;
+        result.remaining_quantity = quantity;
+        return result;
+    }
+
+    if (type != OrderType::Limit) {
+        // IOC and FOK limits never rest, but are held to the tick all the same
+        if (type != OrderType::Market && price % Traits::TICK_SIZE != 0) {
+            result.status = OrderStatus::Rejected;
+            result.reject_reason = RejectReason::PriceOutOfBand;
+            result.remaining_quantity = quantity;
+            return result;
+        }
+        if (type == OrderType::FOK && !fillable(side, price, quantity)) {
+            result.status = OrderStatus::Rejected;
+            result.reject_reason = RejectReason::InsufficientLiquidity;
+            result.remaining_quantity = quantity;
+            return result;
+        }
+
+        // Nothing is left behind to rest, so the aggressor lives on the
+        // stack and the pool and index are never touched for it
+        Order order;
+        order.id = next_order_id();
+        order.remaining = quantity;
+        next_timestamp();
+        result.order_id = order.id;
+
+        std::uint64_t trades_before = trade_count_;
+        match_order(order, side, type, price, sink);
+        result.trade_count = static_cast<std::size_t>(trade_count_ - trades_before);
+        result.filled_quantity = quantity - order.remaining;
+        result.remaining_quantity = order.remaining;
+        result.status = order.is_filled() ? OrderStatus::Filled : OrderStatus::Cancelled;
+        return result;
+    }
+
+    // A limit order that could end up resting must fit the level storage
+    if (!side_of(side).accepts(price)) {
+        result.status = OrderStatus::Rejected;
+        result.reject_reason = RejectReason::PriceOutOfBand;
+        result.remaining_quantity = quantity;
+        return result;
+    }
+
+    OrderHandle h = allocate_order();
+    if (h == NULL_HANDLE) {
+        result.status = OrderStatus::Rejected;
+        result.reject_reason = RejectReason::PoolExhausted;
+        result.remaining_quantity = quantity;
+        return result;
+    }
+    Order& order = pool_[h];
+    OrderInfo& info = pool_.info(h);
+    order.id = next_order_id();
+    order.remaining = quantity;
+    info.side = side;
+    info.type = type;
+    info.price = price;
+    info.quantity = quantity;
+    info.status = OrderStatus::Active;
+    info.timestamp = next_timestamp();
+
+    result.order_id = order.id;
+
+    // Attempt to match against opposite side
+    std::uint64_t trades_before = trade_count_;
+    match_order(order, side, type, price, sink);
+    result.trade_count = static_cast<std::size_t>(trade_count_ - trades_before);
+    result.filled_quantity = quantity - order.remaining;
+    result.remaining_quantity = order.remaining;
+
+    if (order.is_filled()) {
+        // Fully filled — return to pool
+        result.status = OrderStatus::Filled;
+        pool_.deallocate(h);
+        return result;
+    }
+
+    // Resting order — insert into book
+    if (order.remaining < quantity) {
+        info.status = OrderStatus::PartiallyFilled;
+    }
+    insert_into_book(h, side, price);
+    if (orders_.size() == orders_.capacity()) {
+        orders_.reserve(pool_.capacity());  // pool grew by a slab
+    }
+    orders_.insert(order.id, h);
+    listener_.on_order_added(order_event(order));
+    result.status = info.status;
+    return result;
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+bool BasicOrderBook<Listener, Traits, DepthLevels>::cancel_order(OrderId order_id) {
+    MessageScope message(*this);
+    return cancel_resting(order_id);
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+bool BasicOrderBook<Listener, Traits, DepthLevels>::cancel_resting(OrderId order_id) {
+    LOB_PROBE(CancelOrder);
+    OrderHandle h = orders_.erase(order_id);
+    if (h == NULL_HANDLE) {
+        return false;
+    }
+
+    Order& order = pool_[h];
+    OrderEvent event = order_event(order);
+    PriceLevel* level = order.level;
+    if (lazy_cancel_ && level->order_count > 1) {
+        // Tombstone: the node stays linked until matching or compact()
+        // walks past it; the last live order still takes its level with it
+        level->kill_order(order);
+        pool_.info(h).status = OrderStatus::Cancelled;
+        ++tombstones_;
+        notify_level(*level);
+        listener_.on_order_cancelled(event);
+        return true;
+    }
+
+    // Remove from its price level
+    level->remove_order(pool_, h);
+    notify_level(*level);
+    if (level->empty()) {
+        erase_level(*level);
+    }
+    listener_.on_order_cancelled(event);
+
+    // Return to pool
+    pool_.deallocate(h);
+    return true;
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+void BasicOrderBook<Listener, Traits, DepthLevels>::add_orders(const OrderRequest* requests,
+                                                               std::size_t count, OrderAck* acks,
+                                                               TradeBuffer& trades) {
+    MessageScope message(*this);
+    for (std::size_t i = 0; i < count; ++i) {
+        if (i + PREFETCH_DISTANCE < count) {
+            // IDs are handed out sequentially, so entry i + D will most
+            // likely get next_id_ + 1 + D (a wrong guess only costs a hint)
+            const OrderRequest& ahead = requests[i + PREFETCH_DISTANCE];
+            side_of(ahead.side).prefetch(ahead.price);
+            orders_.prefetch(static_cast<OrderId>(next_id_ + 1 + PREFETCH_DISTANCE));
+        }
+        const OrderRequest& r = requests[i];
+        acks[i] = submit_order(r.side, r.type, r.price, r.quantity, trades);
+    }
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+std::size_t BasicOrderBook<Listener, Traits, DepthLevels>::cancel_orders(const OrderId* ids,
+                                                                         std::size_t count,
+                                                                         bool* results) {
+    constexpr std::size_t NODE_DISTANCE = PREFETCH_DISTANCE / 2;
+    MessageScope message(*this);
+    std::size_t cancelled = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        // Two-stage pipeline: index slot first, then (once that slot is in
+        // cache) the pool node it points at
+        if (i + PREFETCH_DISTANCE < count) {
+            orders_.prefetch(ids[i + PREFETCH_DISTANCE]);
+        }
+        if (i + NODE_DISTANCE < count) {
+            OrderHandle ahead = orders_.find(ids[i + NODE_DISTANCE]);
+            if (ahead != NULL_HANDLE) pool_.prefetch(ahead);
+        }
+        bool ok = cancel_resting(ids[i]);
+        if (results) results[i] = ok;
+        cancelled += ok ? 1 : 0;
+    }
+    return cancelled;
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+bool BasicOrderBook<Listener, Traits, DepthLevels>::modify_order(OrderId order_id,
+                                                                 Quantity new_quantity) {
+    MessageScope message(*this);
+    OrderHandle h = orders_.find(order_id);
+    if (h == NULL_HANDLE) {
+        return false;
+    }
+    // Same price cannot cross: a reduce keeps priority, an increase re-queues
+    TradeBuffer no_trades;
+    replace_resting(order_id, h, pool_.info(h).price, new_quantity, no_trades);
+    return true;
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+auto BasicOrderBook<Listener, Traits, DepthLevels>::replace_order(OrderId order_id, Price new_price,
+                                                                  Quantity new_quantity)
+    -> OrderResult {
+    MessageScope message(*this);
+    OrderResult result;
+    OrderAck ack;
+    OrderHandle h = orders_.find(order_id);
+    if (h == NULL_HANDLE) {
+        ack.order_id = order_id;
+        ack.status = OrderStatus::Rejected;
+        ack.reject_reason = RejectReason::UnknownOrder;
+    } else {
+        detail::TradeVectorSink<Trade> sink{result.trades};
+        ack = replace_resting(order_id, h, new_price, new_quantity, sink);
+    }
+    result.order_id = ack.order_id;
+    result.status = ack.status;
+    result.filled_quantity = ack.filled_quantity;
+    result.remaining_quantity = ack.remaining_quantity;
+    result.reject_reason = ack.reject_reason;
+    return result;
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+auto BasicOrderBook<Listener, Traits, DepthLevels>::replace_order(OrderId order_id, Price new_price,
+                                                                  Quantity new_quantity,
+                                                                  TradeBuffer& trades) -> OrderAck {
+    MessageScope message(*this);
+    OrderHandle h = orders_.find(order_id);
+    if (h == NULL_HANDLE) {
+        OrderAck ack;
+        ack.order_id = order_id;
+        ack.status = OrderStatus::Rejected;
+        ack.reject_reason = RejectReason::UnknownOrder;
+        return ack;
+    }
+    return replace_resting(order_id, h, new_price, new_quantity, trades);
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+template <typename Sink>
+auto BasicOrderBook<Listener, Traits, DepthLevels>::replace_resting(OrderId order_id, OrderHandle h,
+                                                                    Price new_price,
+                                                                    Quantity new_quantity,
+                                                                    Sink& sink) -> OrderAck {
+    Order& order = pool_[h];
+    OrderInfo& info = pool_.info(h);
+    Quantity filled = info.quantity - order.remaining;
+    OrderAck result;
+    result.order_id = order_id;
+
+    if (new_quantity <= filled) {
+        // Nothing left to rest: effectively a cancel
+        cancel_resting(order_id);
+        result.status = OrderStatus::Cancelled;
+        return result;
+    }
+    Side side = info.side;
+    if (!side_of(side).accepts(new_price)) {
+        result.status = OrderStatus::Rejected;
+        result.reject_reason = RejectReason::PriceOutOfBand;
+        result.remaining_quantity = order.remaining;
+        return result;
+    }
+
+    Quantity new_remaining = new_quantity - filled;
+    if (new_price == info.price && new_quantity <= info.quantity) {
+        // Reduce (or no-op) at the same price preserves time priority
+        if (new_quantity < info.quantity) {
+            order.level->total_quantity -= (order.remaining - new_remaining);
+            order.remaining = new_remaining;
+            info.quantity = new_quantity;
+            notify_level(*order.level);
+            listener_.on_order_modified(order_event(order));
+        }
+        result.status = info.status;
+        result.remaining_quantity = order.remaining;
+        return result;
+    }
+
+    // Unlink from the current level; the node, ID and index entry stay put
+    PriceLevel* level = order.level;
+    level->remove_order(pool_, h);
+    notify_level(*level);
+    if (level->empty()) {
+        erase_level(*level);
+    }
+    order.remaining = new_remaining;
+    info.price = new_price;
+    info.quantity = new_quantity;
+    info.timestamp = next_timestamp();  // priority is lost
+
+    std::uint64_t trades_before = trade_count_;
+    match_order(order, side, OrderType::Limit, new_price, sink);
+    result.trade_count = static_cast<std::size_t>(trade_count_ - trades_before);
+    result.filled_quantity = new_remaining - order.remaining;
+    result.remaining_quantity = order.remaining;
+
+    if (order.is_filled()) {
+        orders_.erase(order_id);
+        pool_.deallocate(h);
+        result.status = OrderStatus::Filled;
+        return result;
+    }
+    info.status = order.remaining < info.quantity ? OrderStatus::PartiallyFilled
+                                                  : OrderStatus::Active;
+    insert_into_book(h, side, new_price);
+    listener_.on_order_modified(order_event(order));
+    result.status = info.status;
+    return result;
+}
+
+// --- Call Auction ---
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+auto BasicOrderBook<Listener, Traits, DepthLevels>::indicative_uncross() const -> AuctionResult {
+    AuctionResult result;
+    const PriceLevel* bid = bids_.best();
+    const PriceLevel* ask = asks_.best();
+    if (!bid || !ask || bid->price < ask->price) {
+        return result;
+    }
+
+    // Pair the sides off best level first, as one sweep would. The quantity
+    // paired is the most any single price can execute.
+    std::uint64_t volume = 0;
+    Quantity bid_left = bid->total_quantity;
+    Quantity ask_left = ask->total_quantity;
+    for (;;) {
+        Quantity qty = std::min(bid_left, ask_left);
+        volume += qty;
+        bid_left -= qty;
+        ask_left -= qty;
+        if (bid_left == 0) {
+            const PriceLevel* next = bids_.next_worse(bid->price);
+            if (!next || next->price < ask->price) break;
+            bid = next;
+            bid_left = bid->total_quantity;
+        }
+        if (ask_left == 0) {
+            const PriceLevel* next = asks_.next_worse(ask->price);
+            if (!next || next->price > bid->price) break;
+            ask = next;
+            ask_left = ask->total_quantity;
+        }
+    }
+    result.volume = static_cast<Quantity>(volume);
+
+    // It executes at every price from the ask level where supply first
+    // reaches it (lo) up to the bid level where demand does (hi)
+    const PriceLevel* top = bids_.best();
+    std::uint64_t demand = top->total_quantity;
+    while (demand < volume) {
+        top = bids_.next_worse(top->price);
+        demand += top->total_quantity;
+    }
+    const PriceLevel* bottom = asks_.best();
+    std::uint64_t supply = bottom->total_quantity;
+    while (supply < volume) {
+        bottom = asks_.next_worse(bottom->price);
+        supply += bottom->total_quantity;
+    }
+    const Price lo = bottom->price;
+    const Price hi = top->price;
+    for (const PriceLevel* b = bids_.next_worse(hi); b && b->price >= lo;
+         b = bids_.next_worse(b->price)) {
+        demand += b->total_quantity;
+    }
+
+    // Walk the limit prices in [lo, hi] upwards, keeping demand (bids at or
+    // above p) and supply (asks at or below p) current. Imbalance only falls
+    // as p rises, so the prices with the least of it are one run.
+    std::uint64_t least = ~std::uint64_t{0};
+    Price run_low = lo;
+    Price run_high = lo;
+    bool buy_surplus = false;
+    bool sell_surplus = false;
+    for (Price p = lo;;) {
+        std::uint64_t imbalance = demand > supply ? demand - supply : supply - demand;
+        if (imbalance < least) {
+            least = imbalance;
+            run_low = p;
+            buy_surplus = sell_surplus = false;
+        }
+        if (imbalance == least) {
+            run_high = p;
+            buy_surplus |= demand > supply;
+            sell_surplus |= supply > demand;
+        }
+        if (p == hi) break;
+        if (const PriceLevel* b = bids_.find(p)) demand -= b->total_quantity;
+        Price next = hi;
+        if (const PriceLevel* b = bids_.next_better(p); b && b->price < next) next = b->price;
+        if (const PriceLevel* a = asks_.next_worse(p); a && a->price < next) next = a->price;
+        if (const PriceLevel* a = asks_.find(next)) supply += a->total_quantity;
+        p = next;
+    }
+
+    // Ties go to the surplus side's limit; a balanced run, or one that
+    // leaves a surplus on each side, to its middle on a valid tick
+    if (buy_surplus && !sell_surplus) {
+        result.price = run_high;
+        result.surplus = static_cast<Quantity>(least);
+        result.surplus_side = Side::Buy;
+        return result;
+    }
+    if (sell_surplus && !buy_surplus) {
+        result.price = run_low;
+        result.surplus = static_cast<Quantity>(least);
+        result.surplus_side = Side::Sell;
+        return result;
+    }
+    Price mid = run_low + (run_high - run_low) / 2;
+    while (mid > run_low && !bids_.accepts(mid)) --mid;
+    result.price = mid;
+    if (least > 0) {
+        // Off the limit prices the imbalance differs again: measure it at mid
+        demand = 0;
+        supply = 0;
+        for (const PriceLevel* b = bids_.best(); b && b->price >= mid;
+             b = bids_.next_worse(b->price)) {
+            demand += b->total_quantity;
+        }
+        for (const PriceLevel* a = asks_.best(); a && a->price <= mid;
+             a = asks_.next_worse(a->price)) {
+            supply += a->total_quantity;
+        }
+        result.surplus_side = supply > demand ? Side::Sell : Side::Buy;
+        result.surplus =
+            static_cast<Quantity>(demand > supply ? demand - supply : supply - demand);
+    }
+    return result;
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+auto BasicOrderBook<Listener, Traits, DepthLevels>::uncross(TradeBuffer& trades) -> AuctionResult {
+    MessageScope message(*this);
+    LOB_PROBE(Match);
+    AuctionResult result = indicative_uncross();
+    phase_ = TradingPhase::Continuous;
+    std::uint64_t trades_before = trade_count_;
+
+    // Same pairing as indicative_uncross(), now against the orders: the
+    // oldest order of each best level trades first, all at one price
+    Quantity left = result.volume;
+    PriceLevel* touched[2] = {nullptr, nullptr};  // partly consumed bid / ask level
+    auto settle = [&](PriceLevel* level, OrderHandle h) {
+        Order& order = pool_[h];
+        const Side side = level->side;  // erase_best() frees a map level
+        touched[static_cast<int>(side)] = level;
+        if (!order.is_filled()) {
+            pool_.info(h).status = OrderStatus::PartiallyFilled;
+            return;
+        }
+        level->remove_order(pool_, h);
+        orders_.erase(order.id);
+        pool_.deallocate(h);
+        if (level->empty()) {
+            notify_level(*level);
+            release_tombstones(*level);
+            side_of(side).erase_best();
+            touched[static_cast<int>(side)] = nullptr;
+        }
+    };
+    while (left > 0) {
+        PriceLevel* bid = bids_.best();
+        PriceLevel* ask = asks_.best();
+        OrderHandle buy_h = live_front(*bid);
+        OrderHandle sell_h = live_front(*ask);
+        Order& buy = pool_[buy_h];
+        Order& sell = pool_[sell_h];
+        Quantity qty = std::min(left, std::min(buy.remaining, sell.remaining));
+        buy.remaining -= qty;
+        sell.remaining -= qty;
+        bid->total_quantity -= qty;
+        ask->total_quantity -= qty;
+        left -= qty;
+
+        Trade trade;
+        trade.price = result.price;
+        trade.quantity = qty;
+        trade.timestamp = timestamp_counter_;
+        trade.buy_order_id = buy.id;
+        trade.sell_order_id = sell.id;
+        ++trade_count_;
+        total_volume_ += qty;
+        trades.push(trade);
+        {
+            LOB_PROBE(Dispatch);
+            listener_.on_trade(trade);
+        }
+
+        settle(bid, buy_h);
+        settle(ask, sell_h);
+    }
+    for (PriceLevel* level : touched) {
+        if (level) notify_level(*level);
+    }
+    result.trade_count = static_cast<std::size_t>(trade_count_ - trades_before);
+    return result;
+}
+
+// --- Market-by-order Entry Points ---
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+auto BasicOrderBook<Listener, Traits, DepthLevels>::insert_order(OrderId order_id, Side side,
+                                                                 Price price, Quantity quantity)
+    -> OrderAck {
+    MessageScope message(*this);
+    LOB_PROBE(AddOrder);
+    OrderAck result;
+    result.order_id = order_id;
+    result.remaining_quantity = quantity;
+    result.status = OrderStatus::Rejected;
+    if (order_id == 0 || orders_.find(order_id) != NULL_HANDLE) {
+        result.reject_reason = RejectReason::DuplicateId;
+        return result;
+    }
+    if (!side_of(side).accepts(price)) {
+        result.reject_reason = RejectReason::PriceOutOfBand;
+        return result;
+    }
+    if (quantity == 0) {
+        result.status = OrderStatus::Cancelled;  // nothing to rest
+        return result;
+    }
+    OrderHandle h = allocate_order();
+    if (h == NULL_HANDLE) {
+        result.reject_reason = RejectReason::PoolExhausted;
+        return result;
+    }
+    Order& order = pool_[h];
+    OrderInfo& info = pool_.info(h);
+    order.id = order_id;
+    order.remaining = quantity;
+    info.side = side;
+    info.type = OrderType::Limit;
+    info.price = price;
+    info.quantity = quantity;
+    info.status = OrderStatus::Active;
+    info.timestamp = next_timestamp();
+
+    insert_into_book(h, side, price);
+    if (orders_.size() == orders_.capacity()) {
+        orders_.reserve(pool_.capacity());
+    }
+    orders_.insert(order_id, h);
+    // Keep next_id_ above every resting ID so snapshot() stays restorable
+    next_id_ = std::max(next_id_, order_id);
+    listener_.on_order_added(order_event(order));
+    result.status = OrderStatus::Active;
+    return result;
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+bool BasicOrderBook<Listener, Traits, DepthLevels>::execute_order(OrderId order_id,
+                                                                  Quantity quantity,
+                                                                  Price price) {
+    MessageScope message(*this);
+    OrderHandle h = orders_.find(order_id);
+    if (h == NULL_HANDLE) {
+        return false;
+    }
+    Order& order = pool_[h];
+    PriceLevel* level = order.level;
+    Quantity qty = std::min(quantity, order.remaining);
+    if (qty == 0) {
+        return true;
+    }
+    order.remaining -= qty;
+    level->total_quantity -= qty;
+
+    Trade trade;
+    trade.price = price == INVALID_PRICE ? level->price : price;
+    trade.quantity = qty;
+    trade.timestamp = timestamp_counter_;
+    trade.buy_order_id = level->side == Side::Buy ? order_id : 0;
+    trade.sell_order_id = level->side == Side::Buy ? 0 : order_id;
+    ++trade_count_;
+    total_volume_ += qty;
+    {
+        LOB_PROBE(Dispatch);
+        listener_.on_trade(trade);
+    }
+
+    if (order.is_filled()) {
+        level->remove_order(pool_, h);
+        orders_.erase(order_id);
+        pool_.deallocate(h);
+    } else {
+        pool_.info(h).status = OrderStatus::PartiallyFilled;
+    }
+    notify_level(*level);
+    if (level->empty()) {
+        erase_level(*level);
+    }
+    return true;
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+bool BasicOrderBook<Listener, Traits, DepthLevels>::reduce_order(OrderId order_id,
+                                                                 Quantity quantity) {
+    MessageScope message(*this);
+    OrderHandle h = orders_.find(order_id);
+    if (h == NULL_HANDLE) {
+        return false;
+    }
+    Quantity cancelled = std::min(quantity, pool_[h].remaining);
+    const OrderInfo& info = pool_.info(h);
+    // Same price and a smaller total: priority is kept, or the order goes
+    TradeBuffer no_trades;
+    replace_resting(order_id, h, info.price, info.quantity - cancelled, no_trades);
+    return true;
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+auto BasicOrderBook<Listener, Traits, DepthLevels>::reinsert_order(OrderId order_id,
+                                                                   OrderId new_id,
+                                                                   Price new_price,
+                                                                   Quantity new_quantity)
+    -> OrderAck {
+    MessageScope message(*this);
+    OrderAck result;
+    result.order_id = new_id;
+    result.status = OrderStatus::Rejected;
+    OrderHandle h = orders_.find(order_id);
+    if (h == NULL_HANDLE) {
+        result.reject_reason = RejectReason::UnknownOrder;
+        return result;
+    }
+    Order& order = pool_[h];
+    OrderInfo& info = pool_.info(h);
+    if (new_id == 0 || (new_id != order_id && orders_.find(new_id) != NULL_HANDLE)) {
+        result.reject_reason = RejectReason::DuplicateId;
+        result.remaining_quantity = order.remaining;
+        return result;
+    }
+    if (!side_of(info.side).accepts(new_price)) {
+        result.reject_reason = RejectReason::PriceOutOfBand;
+        result.remaining_quantity = order.remaining;
+        return result;
+    }
+    if (new_quantity == 0) {
+        cancel_resting(order_id);
+        result.status = OrderStatus::Cancelled;
+        return result;
+    }
+
+    // Reuse the node: unlink, re-key the index, relink at the new tail
+    OrderEvent retired = order_event(order);
+    PriceLevel* level = order.level;
+    level->remove_order(pool_, h);
+    notify_level(*level);
+    if (level->empty()) {
+        erase_level(*level);
+    }
+    listener_.on_order_cancelled(retired);
+    orders_.erase(order_id);
+
+    order.id = new_id;
+    order.remaining = new_quantity;
+    info.price = new_price;
+    info.quantity = new_quantity;
+    info.status = OrderStatus::Active;
+    info.timestamp = next_timestamp();
+    insert_into_book(h, info.side, new_price);
+    orders_.insert(new_id, h);
+    next_id_ = std::max(next_id_, new_id);
+    listener_.on_order_added(order_event(order));
+
+    result.status = OrderStatus::Active;
+    result.remaining_quantity = new_quantity;
+    return result;
+}
+
+// --- Matching Engine (hot path) ---
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+template <typename Sink>
+void BasicOrderBook<Listener, Traits, DepthLevels>::match_order(Order& order, Side side,
+                                                                OrderType type, Price limit,
+                                                                Sink& sink) {
+    LOB_PROBE(Match);
+    if (phase_ == TradingPhase::Auction) {
+        return;  // orders accumulate until uncross()
+    }
+    if (side == Side::Buy) {
+        match_against_asks(order, type, limit, sink);
+    } else {
+        match_against_bids(order, type, limit, sink);
+    }
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+template <typename Sink>
+void BasicOrderBook<Listener, Traits, DepthLevels>::match_against_asks(Order& order, OrderType type,
+                                                                       Price limit, Sink& sink) {
+    // Buy order matches against asks from lowest price upward
+    while (order.remaining > 0) {
+        PriceLevel* level = asks_.best();
+        if (!level) break;
+
+        // Priced order (limit, IOC, FOK): stop if ask price exceeds our limit
+        if (type != OrderType::Market && level->price > limit) {
+            break;
+        }
+
+        OrderHandle passive_h = level->front();
+        open_level_execution(order, Side::Buy, *level);
+
+        while (passive_h != NULL_HANDLE && order.remaining > 0) {
+            Order& passive = pool_[passive_h];
+            OrderHandle next_passive = passive.next;
+            if (passive.remaining == 0) {
+                reclaim_tombstone(*level, passive_h);  // lazily cancelled: drop it in passing
+                passive_h = next_passive;
+                continue;
+            }
+            Quantity trade_qty = std::min(order.remaining, passive.remaining);
+            execute_trade(order, Side::Buy, passive, trade_qty, sink);
+
+            if (passive.is_filled()) {
+                level->remove_order(pool_, passive_h);
+                orders_.erase(passive.id);
+                pool_.deallocate(passive_h);
+            }
+            notify_level(*level);
+            passive_h = next_passive;
+        }
+        close_level_execution();
+
+        // A level left non-empty means the aggressor is filled
+        if (level->empty()) {
+            release_tombstones(*level);
+            asks_.erase_best();
+        }
+    }
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+template <typename Sink>
+void BasicOrderBook<Listener, Traits, DepthLevels>::match_against_bids(Order& order, OrderType type,
+                                                                       Price limit, Sink& sink) {
+    // Sell order matches against bids from highest price downward
+    while (order.remaining > 0) {
+        PriceLevel* level = bids_.best();
+        if (!level) break;
+
+        // Priced order (limit, IOC, FOK): stop if bid price is below our limit
+        if (type != OrderType::Market && level->price < limit) {
+            break;
+        }
+
+        OrderHandle passive_h = level->front();
+        open_level_execution(order, Side::Sell, *level);
+
+        while (passive_h != NULL_HANDLE && order.remaining > 0) {
+            Order& passive = pool_[passive_h];
+            OrderHandle next_passive = passive.next;
+            if (passive.remaining == 0) {
+                reclaim_tombstone(*level, passive_h);  // lazily cancelled: drop it in passing
+                passive_h = next_passive;
+                continue;
+            }
+            Quantity trade_qty = std::min(order.remaining, passive.remaining);
+            execute_trade(order, Side::Sell, passive, trade_qty, sink);
+
+            if (passive.is_filled()) {
+                level->remove_order(pool_, passive_h);
+                orders_.erase(passive.id);
+                pool_.deallocate(passive_h);
+            }
+            notify_level(*level);
+            passive_h = next_passive;
+        }
+        close_level_execution();
+
+        if (level->empty()) {
+            release_tombstones(*level);
+            bids_.erase_best();
+        }
+    }
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+template <typename Sink>
+void BasicOrderBook<Listener, Traits, DepthLevels>::execute_trade(Order& aggressive,
+                                                                  Side aggressor_side,
+                                                                  Order& passive, Quantity qty,
+                                                                  Sink& sink) {
+    aggressive.remaining -= qty;
+    passive.remaining -= qty;
+
+    // Update passive's price level total quantity
+    passive.level->total_quantity -= qty;
+
+    Trade trade;
+    trade.price = passive.level->price;  // trade at passive (resting) order's price
+    trade.quantity = qty;
+    trade.timestamp = timestamp_counter_;
+
+    if (aggressor_side == Side::Buy) {
+        trade.buy_order_id = aggressive.id;
+        trade.sell_order_id = passive.id;
+    } else {
+        trade.buy_order_id = passive.id;
+        trade.sell_order_id = aggressive.id;
+    }
+
+    ++trade_count_;
+    total_volume_ += qty;
+    if (executions_) executions_->add_fill(passive.id, qty);
+    sink.push(trade);
+    LOB_PROBE(Dispatch);
+    listener_.on_trade(trade);
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+void BasicOrderBook<Listener, Traits, DepthLevels>::insert_into_book(OrderHandle h, Side side,
+                                                                     Price price) {
+    PriceLevel& level = side_of(side).get_or_insert(price);
+    level.add_order(pool_, h);
+    notify_level(level);
+}
+
+// --- Lazy Cancel ---
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+std::size_t BasicOrderBook<Listener, Traits, DepthLevels>::compact() {
+    std::size_t before = tombstones_;
+    for (BookSide* side : {&bids_, &asks_}) {
+        for (PriceLevel* level = side->best(); level && tombstones_ > 0;) {
+            for (OrderHandle h = level->head; h != NULL_HANDLE;) {
+                OrderHandle next = pool_[h].next;
+                if (pool_[h].remaining == 0) reclaim_tombstone(*level, h);
+                h = next;
+            }
+            const PriceLevel* next = side->next_worse(level->price);
+            level = next ? side->find(next->price) : nullptr;
+        }
+    }
+    return before - tombstones_;
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+void BasicOrderBook<Listener, Traits, DepthLevels>::release_tombstones(PriceLevel& level) {
+    // Called once a level has no live orders: whatever is linked is dead
+    for (OrderHandle h = level.head; h != NULL_HANDLE;) {
+        OrderHandle next = pool_[h].next;
+        reclaim_tombstone(level, h);
+        h = next;
+    }
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+void BasicOrderBook<Listener, Traits, DepthLevels>::reset() {
+    for (BookSide* side : {&bids_, &asks_}) {
+        while (PriceLevel* level = side->best()) {
+            // Ladder slots are reused as they are, so each level is emptied
+            // before it is released
+            while (level->head != NULL_HANDLE) {
+                OrderHandle h = level->head;
+                if (pool_[h].remaining != 0) {
+                    orders_.erase(pool_[h].id);
+                    level->remove_order(pool_, h);
+                } else {
+                    level->unlink(pool_, h);  // tombstones are already unindexed
+                }
+                pool_.deallocate(h);
+            }
+            side->sync(*level);  // zero the ladder's depth-scan mirror too
+            side->erase_best();
+        }
+    }
+    next_id_ = id_base_;
+    timestamp_counter_ = 0;
+    trade_count_ = 0;
+    total_volume_ = 0;
+    messages_ = 0;
+    phase_ = TradingPhase::Continuous;
+    tombstones_ = 0;
+    rebuild_depth_cache();
+    if (view_) publish_view();
+}
+
+// --- Snapshot / Restore ---
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+std::size_t BasicOrderBook<Listener, Traits, DepthLevels>::snapshot(
+    void* out, std::size_t capacity, std::uint64_t journal_position) const {
+    std::size_t bytes = snapshot_size();
+    if (capacity < bytes) return 0;
+
+    char* cursor = static_cast<char*>(out) + sizeof(SnapshotHeader);
+    std::uint64_t written = 0;
+    auto dump = [&](const BookSide& side) {
+        side.for_each_level(side.size(), [&](const PriceLevel& level) {
+            for (OrderHandle h = level.head; h != NULL_HANDLE; h = pool_[h].next) {
+                const Order& order = pool_[h];
+                if (order.remaining == 0) continue;  // tombstone
+                const OrderInfo& info = pool_.info(h);
+                SnapshotOrder record{};
+                record.id = order.id;
+                record.price = level.price;
+                record.quantity = info.quantity;
+                record.remaining = order.remaining;
+                record.timestamp = info.timestamp;
+                record.side = level.side;
+                record.type = info.type;
+                record.status = info.status;
+                std::memcpy(cursor, &record, sizeof(record));
+                cursor += sizeof(record);
+                ++written;
+            }
+        });
+    };
+
+    SnapshotHeader header{};
+    header.magic = SNAPSHOT_MAGIC;
+    header.version = SNAPSHOT_VERSION;
+    header.record_size = sizeof(SnapshotOrder);
+    header.next_id = next_id_;
+    header.timestamp_counter = timestamp_counter_;
+    header.trade_count = trade_count_;
+    header.total_volume = total_volume_;
+    dump(bids_);
+    header.bid_orders = written;
+    dump(asks_);
+    header.ask_orders = written - header.bid_orders;
+    header.pool_capacity = pool_.capacity();
+    header.journal_position = journal_position;
+    header.level_storage = bids_.uses_ladder() ? LevelStorage::Ladder : LevelStorage::Map;
+    header.phase = phase_;
+    if (const PriceLadder* ladder = bids_.ladder()) {
+        header.ladder_min = ladder->min_price();
+        header.ladder_max = ladder->max_price();
+        header.ladder_tick = ladder->tick_size();
+    }
+    std::memcpy(out, &header, sizeof(header));
+    return bytes;
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+bool BasicOrderBook<Listener, Traits, DepthLevels>::restore(const void* image, std::size_t size) {
+    if (!orders_.empty() || size < sizeof(SnapshotHeader)) return false;
+
+    SnapshotHeader header;
+    std::memcpy(&header, image, sizeof(header));
+    if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION ||
+        header.record_size != sizeof(SnapshotOrder)) {
+        return false;
+    }
+    std::uint64_t count = header.bid_orders + header.ask_orders;
+    if (count > pool_.max_capacity() - pool_.size() ||
+        size != snapshot_bytes(static_cast<std::size_t>(count))) {
+        return false;
+    }
+    LevelStorage storage = bids_.uses_ladder() ? LevelStorage::Ladder : LevelStorage::Map;
+    if (header.level_storage != storage || !fits_in<OrderId>(header.next_id) ||
+        header.phase > TradingPhase::Auction) {
+        return false;
+    }
+
+    const char* records = static_cast<const char*>(image) + sizeof(SnapshotHeader);
+    auto record_at = [&](std::uint64_t i) {
+        SnapshotOrder record;
+        std::memcpy(&record, records + i * sizeof(SnapshotOrder), sizeof(record));
+        return record;
+    };
+
+    // Validate everything before touching the book
+    std::vector<std::uint64_t> ids;
+    ids.reserve(static_cast<std::size_t>(count));
+    for (std::uint64_t i = 0; i < count; ++i) {
+        SnapshotOrder r = record_at(i);
+        ids.push_back(r.id);
+        Side expected = i < header.bid_orders ? Side::Buy : Side::Sell;
+        // Images are full width: values must also fit this book's fields
+        if (r.side != expected || r.id == 0 || r.id > header.next_id || r.remaining == 0 ||
+            r.remaining > r.quantity || !fits_in<Quantity>(r.quantity) ||
+            !fits_in<Price>(r.price) || !side_of(r.side).accepts(static_cast<Price>(r.price))) {
+            return false;
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+    if (std::adjacent_find(ids.begin(), ids.end()) != ids.end()) return false;
+
+    // Room for every record up front, so applying them cannot fail half way
+    if (!pool_.reserve(static_cast<std::size_t>(count))) return false;  // no slab
+    orders_.reserve(pool_.capacity());
+
+    // Orders arrive best level first, oldest first, so appending to each
+    // level's tail rebuilds time priority exactly
+    for (std::uint64_t i = 0; i < count; ++i) {
+        SnapshotOrder r = record_at(i);
+        OrderHandle h = pool_.allocate();
+        Order& order = pool_[h];
+        OrderInfo& info = pool_.info(h);
+        order.id = static_cast<OrderId>(r.id);
+        order.remaining = static_cast<Quantity>(r.remaining);
+        info.side = r.side;
+        info.type = r.type;
+        info.price = static_cast<Price>(r.price);
+        info.quantity = static_cast<Quantity>(r.quantity);
+        info.status = r.status;
+        info.timestamp = r.timestamp;
+        PriceLevel& level = side_of(r.side).get_or_insert(info.price);
+        level.add_order(pool_, h);
+        side_of(r.side).sync(level);
+        orders_.insert(order.id, h);
+    }
+
+    next_id_ = static_cast<OrderId>(header.next_id);
+    timestamp_counter_ = header.timestamp_counter;
+    trade_count_ = header.trade_count;
+    total_volume_ = header.total_volume;
+    phase_ = header.phase;
+    rebuild_depth_cache();
+    if (view_) publish_view();
+    return true;
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+void BasicOrderBook<Listener, Traits, DepthLevels>::rebuild_depth_cache() {
+    auto reload = [](const BookSide& side, TopLevels& cache) {
+        cache.clear();
+        side.for_each_level(DEPTH_LEVELS, [&](const PriceLevel& level) {
+            cache.push_back(DepthLevel{level.price, level.total_quantity, level.order_count});
+        });
+    };
+    reload(bids_, bid_top_);
+    reload(asks_, ask_top_);
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+void BasicOrderBook<Listener, Traits, DepthLevels>::publish_view() {
+    BookView<DEPTH_LEVELS, Traits> view;
+    view.messages = messages_;
+    view.best_bid = best_bid();
+    view.best_ask = best_ask();
+    view.total_trades = trade_count_;
+    view.total_volume = total_volume_;
+    view.bid_count = static_cast<std::uint32_t>(bid_top_.size());
+    view.ask_count = static_cast<std::uint32_t>(ask_top_.size());
+    std::copy(bid_top_.begin(), bid_top_.end(), view.bids.begin());
+    std::copy(ask_top_.begin(), ask_top_.end(), view.asks.begin());
+    view_->store(view);
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+bool BasicOrderBook<Listener, Traits, DepthLevels>::save_snapshot(
+    const std::string& path, std::uint64_t journal_position) const {
+    std::vector<char> image(snapshot_size());
+    snapshot(image.data(), image.size(), journal_position);
+    return write_snapshot_file(path, image.data(), image.size());
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+bool BasicOrderBook<Listener, Traits, DepthLevels>::load_snapshot(const std::string& path) {
+    SnapshotFile file(path);
+    return restore(file.data(), file.size());
+}
+
+// --- Market Data Queries ---
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+auto BasicOrderBook<Listener, Traits, DepthLevels>::best_bid() const -> Price {
+    const PriceLevel* level = bids_.best();
+    return level ? level->price : INVALID_PRICE;
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+auto BasicOrderBook<Listener, Traits, DepthLevels>::best_ask() const -> Price {
+    const PriceLevel* level = asks_.best();
+    return level ? level->price : INVALID_PRICE;
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+auto BasicOrderBook<Listener, Traits, DepthLevels>::spread() const -> Price {
+    Price bid = best_bid();
+    Price ask = best_ask();
+    if (bid == INVALID_PRICE || ask == INVALID_PRICE) return INVALID_PRICE;
+    return ask > bid ? ask - bid : 0;
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+auto BasicOrderBook<Listener, Traits, DepthLevels>::volume_at_price(Side side, Price price) const
+    -> Quantity {
+    const BookSide& book_side = side_of(side);
+    if constexpr (DEPTH_LEVELS > 0) {
+        const TopLevels& top = side == Side::Buy ? bid_top_ : ask_top_;
+        if (!book_side.uses_ladder() && top.covers(price)) {
+            const DepthLevel* cached = top.find(price);
+            return cached ? cached->quantity : 0;
+        }
+    }
+    const PriceLevel* level = book_side.find(price);
+    return level ? level->total_quantity : 0;
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+std::uint32_t BasicOrderBook<Listener, Traits, DepthLevels>::order_count_at_price(Side side,
+                                                                                  Price price) const
+{
+    const BookSide& book_side = side_of(side);
+    if constexpr (DEPTH_LEVELS > 0) {
+        const TopLevels& top = side == Side::Buy ? bid_top_ : ask_top_;
+        if (!book_side.uses_ladder() && top.covers(price)) {
+            const DepthLevel* cached = top.find(price);
+            return cached ? cached->order_count : 0;
+        }
+    }
+    const PriceLevel* level = book_side.find(price);
+    return level ? level->order_count : 0;
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+auto BasicOrderBook<Listener, Traits, DepthLevels>::open_quantity(OrderId order_id) const
+    -> Quantity {
+    OrderHandle h = orders_.find(order_id);
+    return h == NULL_HANDLE ? 0 : pool_[h].remaining;
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+auto BasicOrderBook<Listener, Traits, DepthLevels>::bid_depth(std::size_t levels) const
+    -> std::vector<std::pair<Price, Quantity>> {
+    std::vector<std::pair<Price, Quantity>> depth;
+    depth.reserve(levels);
+    bids_.for_each_level(levels, [&](const PriceLevel& level) {
+        depth.emplace_back(level.price, level.total_quantity);
+    });
+    return depth;
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+auto BasicOrderBook<Listener, Traits, DepthLevels>::ask_depth(std::size_t levels) const
+    -> std::vector<std::pair<Price, Quantity>> {
+    std::vector<std::pair<Price, Quantity>> depth;
+    depth.reserve(levels);
+    asks_.for_each_level(levels, [&](const PriceLevel& level) {
+        depth.emplace_back(level.price, level.total_quantity);
+    });
+    return depth;
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+std::size_t BasicOrderBook<Listener, Traits, DepthLevels>::bid_depth(std::pair<Price,
+                                                                     Quantity>* out,
+                                                                     std::size_t levels) const {
+    std::size_t n = 0;
+    bids_.for_each_level(levels, [&](const PriceLevel& level) {
+        out[n++] = {level.price, level.total_quantity};
+    });
+    return n;
+}
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+std::size_t BasicOrderBook<Listener, Traits, DepthLevels>::ask_depth(std::pair<Price,
+                                                                     Quantity>* out,
+                                                                     std::size_t levels) const {
+    std::size_t n = 0;
+    asks_.for_each_level(levels, [&](const PriceLevel& level) {
+        out[n++] = {level.price, level.total_quantity};
+    });
+    return n;
+}
+
+// --- Introspection ---
+
+template <typename Listener, typename Traits, std::size_t DepthLevels>
+auto BasicOrderBook<Listener, Traits, DepthLevels>::occupancy_stats() const -> OccupancyStats {
+    OccupancyStats stats;
+    stats.orders = orders_.size();
+    stats.tombstones = tombstones_;
+    stats.pool_capacity = pool_.capacity();
+    stats.pool_max_capacity = pool_.max_capacity();
+    stats.pool_high_water = pool_.high_water();
+
+    stats.index_slots = orders_.slot_count();
+    stats.index_load = orders_.load_factor();
+    IndexProbeStats probes = orders_.probe_stats();
+    stats.mean_probe = probes.mean;
+    stats.max_probe = probes.max;
+
+    stats.bid_levels = bids_.size();
+    stats.ask_levels = asks_.size();
+    if (const PriceLadder* ladder = bids_.ladder()) stats.ladder_ticks = ladder->capacity();
+
+    std::size_t queued = 0;
+    auto tally = [&](const PriceLevel& level, Price& low, Price& high) {
+        std::size_t depth = level.order_count;
+        queued += depth;
+        if (depth > stats.max_queue_depth) stats.max_queue_depth = depth;
+        std::size_t bucket = 0;
+        while (bucket + 1 < QUEUE_DEPTH_BUCKETS && (depth >> (bucket + 1)) != 0) ++bucket;
+        ++stats.queue_depth[bucket];
+        if (low == INVALID_PRICE || level.price < low) low = level.price;
+        if (level.price > high) high = level.price;
+    };
+    bids_.for_each_level(bids_.size(), [&](const PriceLevel& level) {
+        tally(level, stats.bid_low, stats.bid_high);
+    });
+    asks_.for_each_level(asks_.size(), [&](const PriceLevel& level) {
+        tally(level, stats.ask_low, stats.ask_high);
+    });
+    std::size_t levels = stats.bid_levels + stats.ask_levels;
+    if (levels != 0) {
+        stats.mean_queue_depth = static_cast<double>(queued) / static_cast<double>(levels);
+    }
+    return stats;
+}
+
+}  // namespace lob
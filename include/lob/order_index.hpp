@@ -0,0 +1,160 @@
+#pragma once
+
+#include "order.hpp"
+#include "memory.hpp"
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+namespace lob {
+
+// Probe lengths of an OrderIndex: slots read by a successful find
+struct IndexProbeStats {
+    double mean = 0;
+    std::size_t max = 0;
+};
+
+// Open-addressing map from order ID to the resting order's pool handle.
+// Linear probing over a power-of-two table kept at most half full, sized
+// once at construction. Erase shifts the following run back instead of
+// leaving tombstones, so probe lengths stay short under heavy cancel flow.
+// The table is page-mapped and starts all-zero (all empty), so its pages
+// are only faulted in on first use unless prefaulted or warmed up.
+// Slots are an ID plus a handle: 16 bytes with 64-bit IDs, 8 with 32-bit.
+// No heap allocation after construction.
+template <typename Traits>
+class BasicOrderIndex {
+public:
+    using OrderId = typename Traits::OrderId;
+
+    explicit BasicOrderIndex(std::size_t capacity, const PageOptions& pages = PageOptions())
+        : pages_(pages), capacity_(capacity) {
+        resize_table(capacity);
+    }
+
+    // Grow to hold at least capacity entries, rehashing in place of the old
+    // table. Only called when a growable pool adds a slab.
+    void reserve(std::size_t capacity) {
+        if (capacity <= capacity_) return;
+        PageArray<Slot> old = std::move(slots_);
+        resize_table(capacity);
+        capacity_ = capacity;
+        size_ = 0;
+        for (std::size_t i = 0; i < old.size(); ++i) {
+            if (old[i].id != EMPTY) insert(old[i].id, old[i].handle);
+        }
+    }
+
+    // Hint the cache to load the home slot of an ID about to be looked up
+    void prefetch(OrderId id) const { __builtin_prefetch(&slots_[home(id)]); }
+
+    // Fault in every slot ahead of the first order
+    void warm_up() const noexcept { slots_.warm_up(); }
+
+    // O(1) expected — NULL_HANDLE if the ID is not present
+    OrderHandle find(OrderId id) const {
+        if (id == EMPTY) return NULL_HANDLE;
+        for (std::size_t i = home(id);; i = (i + 1) & mask_) {
+            const Slot& slot = slots_[i];
+            if (slot.id == id) return slot.handle;
+            if (slot.id == EMPTY) return NULL_HANDLE;
+        }
+    }
+
+    // O(1) expected — false if the ID is already present or the index is full
+    bool insert(OrderId id, OrderHandle handle) {
+        if (id == EMPTY || size_ == capacity_) return false;
+        std::size_t i = home(id);
+        while (slots_[i].id != EMPTY) {
+            if (slots_[i].id == id) return false;
+            i = (i + 1) & mask_;
+        }
+        slots_[i].id = id;
+        slots_[i].handle = handle;
+        ++size_;
+        return true;
+    }
+
+    // O(1) expected — removes the ID and returns its handle, or NULL_HANDLE if absent
+    OrderHandle erase(OrderId id) {
+        if (id == EMPTY) return NULL_HANDLE;
+        std::size_t i = home(id);
+        while (slots_[i].id != id) {
+            if (slots_[i].id == EMPTY) return NULL_HANDLE;
+            i = (i + 1) & mask_;
+        }
+        OrderHandle handle = slots_[i].handle;
+
+        // Backward-shift deletion: pull later entries of the run into the hole
+        // when the hole lies between their home slot and where they sit now.
+        std::size_t hole = i;
+        for (std::size_t j = (i + 1) & mask_; slots_[j].id != EMPTY; j = (j + 1) & mask_) {
+            std::size_t h = home(slots_[j].id);
+            if (((j - h) & mask_) >= ((j - hole) & mask_)) {
+                slots_[hole] = slots_[j];
+                hole = j;
+            }
+        }
+        slots_[hole].id = EMPTY;
+        --size_;
+        return handle;
+    }
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    std::size_t capacity() const { return capacity_; }
+    std::size_t slot_count() const { return slots_.size(); }
+    const PageBuffer& memory() const { return slots_.memory(); }
+    double load_factor() const {
+        if (slots_.size() == 0) return 0.0;
+        return static_cast<double>(size_) / static_cast<double>(slots_.size());
+    }
+
+    // O(slots) — walks the whole table, for monitoring rather than the hot path
+    IndexProbeStats probe_stats() const {
+        IndexProbeStats stats;
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < slots_.size(); ++i) {
+            if (slots_[i].id == EMPTY) continue;
+            std::size_t probes = ((i - home(slots_[i].id)) & mask_) + 1;
+            total += probes;
+            if (probes > stats.max) stats.max = probes;
+        }
+        if (size_ != 0) stats.mean = static_cast<double>(total) / static_cast<double>(size_);
+        return stats;
+    }
+
+private:
+    // Order IDs start at 1, so 0 marks a free slot; its handle is ignored
+    static constexpr OrderId EMPTY = 0;
+
+    struct Slot {
+        OrderId id;
+        OrderHandle handle;
+    };
+
+    void resize_table(std::size_t capacity) {
+        std::size_t slots = 16;
+        while (slots < capacity * 2) slots <<= 1;
+        slots_ = PageArray<Slot>(slots, pages_);
+        mask_ = slots - 1;
+        shift_ = 64;
+        for (std::size_t s = slots; s > 1; s >>= 1) --shift_;
+    }
+
+    // Fibonacci hashing: spreads both dense and strided IDs across the table
+    std::size_t home(OrderId id) const {
+        return static_cast<std::size_t>((std::uint64_t{id} * 0x9E3779B97F4A7C15ull) >> shift_);
+    }
+
+    PageOptions pages_;
+    PageArray<Slot> slots_;
+    std::size_t mask_ = 0;
+    unsigned shift_ = 0;
+    std::size_t capacity_;
+    std::size_t size_ = 0;
+};
+
+using OrderIndex = BasicOrderIndex<DefaultBookTraits>;
+
+}  // namespace lob
@@ -1,54 +1,188 @@
 #pragma once
 
 #include "order.hpp"
+#include "memory.hpp"
 #include <vector>
+#include <new>
 #include <stdexcept>
 #include <cstddef>
 
 namespace lob {
 
+// Sizing and backing for an OrderPool
+struct PoolConfig {
+    std::size_t capacity = 1'000'000;  // orders available at construction
+    std::size_t max_capacity = 0;      // growth limit; <= capacity means fixed size
+    std::size_t slab_size = 65536;     // orders per slab, rounded up to a power of two
+    PageOptions pages;                 // huge pages / prefault / NUMA node for slab memory
+};
+
 // Pre-allocated object pool with O(1) allocate/deallocate.
-// Uses a free-list of indices into a contiguous memory block.
-// No heap allocation after construction.
-class OrderPool {
+// Orders live in slabs of hot Order nodes with a parallel array of cold
+// OrderInfo records, addressed by the same 32-bit handle. Freed slots are
+// chained through Order::next; slots never used yet are handed out in order.
+// A growable pool maps whole new slabs when it runs dry, so existing orders
+// never move. No heap allocation after construction except slab growth.
+template <typename Traits>
+class BasicOrderPool {
 public:
-    explicit OrderPool(std::size_t capacity)
-        : orders_(capacity), free_stack_(capacity), capacity_(capacity), size_(0) {
-        // Initialize free stack: all indices available
-        for (std::size_t i = 0; i < capacity; ++i) {
-            free_stack_[i] = capacity - 1 - i;  // top of stack = index 0
+    using Order = BasicOrder<Traits>;
+    using OrderInfo = BasicOrderInfo<Traits>;
+
+    explicit BasicOrderPool(std::size_t capacity) : BasicOrderPool(fixed_config(capacity)) {}
+
+    explicit BasicOrderPool(const PoolConfig& config)
+        : pages_(config.pages), capacity_(config.capacity),
+          max_capacity_(config.max_capacity > config.capacity ? config.max_capacity
+                                                              : config.capacity) {
+        if (max_capacity_ >= NULL_HANDLE) {
+            throw std::invalid_argument("OrderPool capacity exceeds handle range");
+        }
+        // Small fixed pools use a single right-sized slab
+        std::size_t slab = 1;
+        std::size_t wanted = config.slab_size;
+        if (max_capacity_ == capacity_ && capacity_ < wanted) wanted = capacity_;
+        while (slab < wanted) {
+            slab <<= 1;
+            ++slab_shift_;
+        }
+        slab_mask_ = slab - 1;
+
+        slabs_.reserve((max_capacity_ + slab - 1) / slab);
+        while (mapped_ < capacity_) {
+            if (!map_slab()) throw std::bad_alloc();
         }
-        free_count_ = capacity;
     }
 
-    // O(1) allocation from free list
-    Order* allocate() {
-        if (free_count_ == 0) {
-            throw std::runtime_error("OrderPool exhausted");
+    BasicOrderPool(const BasicOrderPool&) = delete;
+    BasicOrderPool& operator=(const BasicOrderPool&) = delete;
+
+    // O(1) allocation. Returns NULL_HANDLE when the pool is exhausted and
+    // cannot grow (limit reached or the kernel refused another slab).
+    OrderHandle allocate() {
+        OrderHandle h;
+        if (free_head_ != NULL_HANDLE) {
+            h = free_head_;
+            free_head_ = (*this)[h].next;
+        } else if (next_unused_ < capacity_ || grow()) {
+            h = static_cast<OrderHandle>(next_unused_++);
+        } else {
+            return NULL_HANDLE;
         }
-        std::size_t idx = free_stack_[--free_count_];
-        orders_[idx].reset();
+        (*this)[h].reset();
+        info(h).reset();
         ++size_;
-        return &orders_[idx];
+        return h;
+    }
+
+    // Grow until count more allocations are sure to succeed. False if the
+    // limit or the kernel stops it first; slabs already mapped are kept.
+    bool reserve(std::size_t count) {
+        while (available() < count) {
+            if (!grow()) return false;
+        }
+        return true;
     }
 
     // O(1) deallocation back to free list
-    void deallocate(Order* order) {
-        std::size_t idx = static_cast<std::size_t>(order - orders_.data());
-        free_stack_[free_count_++] = idx;
+    void deallocate(OrderHandle h) {
+        (*this)[h].next = free_head_;
+        free_head_ = h;
         --size_;
     }
 
+    Order& operator[](OrderHandle h) { return slabs_[h >> slab_shift_].nodes[h & slab_mask_]; }
+    const Order& operator[](OrderHandle h) const {
+        return slabs_[h >> slab_shift_].nodes[h & slab_mask_];
+    }
+
+    OrderInfo& info(OrderHandle h) { return slabs_[h >> slab_shift_].info[h & slab_mask_]; }
+    const OrderInfo& info(OrderHandle h) const {
+        return slabs_[h >> slab_shift_].info[h & slab_mask_];
+    }
+
+    void prefetch(OrderHandle h) const { __builtin_prefetch(&(*this)[h]); }
+
     std::size_t size() const { return size_; }
     std::size_t capacity() const { return capacity_; }
-    std::size_t available() const { return free_count_; }
+    std::size_t max_capacity() const { return max_capacity_; }
+    std::size_t available() const { return capacity_ - size_; }
+    bool growable() const { return max_capacity_ > capacity_; }
+    std::size_t slab_size() const { return slab_mask_ + 1; }
+    std::size_t slab_count() const { return slabs_.size(); }
+
+    // Most orders ever live at once. The free list is LIFO, so slots are
+    // only taken from the unused tail when every earlier slot is in use.
+    std::size_t high_water() const { return next_unused_; }
+
+    // Bytes mapped for nodes and info, across every slab
+    std::size_t memory_bytes() const {
+        std::size_t bytes = 0;
+        for (const Slab& s : slabs_) bytes += s.memory.size();
+        return bytes;
+    }
+
+    // Fault in every page of the mapped slabs. Contents are left unchanged,
+    // so this is safe on a live pool, but it is meant for start-up.
+    void warm_up() const noexcept {
+        for (const Slab& s : slabs_) s.memory.warm_up();
+    }
+
+    // True if every slab is backed by explicit 2MB pages
+    bool huge_pages() const {
+        for (const Slab& s : slabs_) {
+            if (!s.memory.huge_pages()) return false;
+        }
+        return !slabs_.empty();
+    }
 
 private:
-    std::vector<Order> orders_;          // contiguous order storage
-    std::vector<std::size_t> free_stack_; // indices of free slots
-    std::size_t capacity_;
-    std::size_t size_;
-    std::size_t free_count_;
+    struct Slab {
+        PageBuffer memory;
+        Order* nodes;
+        OrderInfo* info;
+    };
+
+    static PoolConfig fixed_config(std::size_t capacity) {
+        PoolConfig config;
+        config.capacity = capacity;
+        return config;
+    }
+
+    // Map one slab: nodes first (page aligned, so node aligned), then info
+    bool map_slab() {
+        std::size_t count = slab_size();
+        PageBuffer memory = PageBuffer::allocate(count * (sizeof(Order) + sizeof(OrderInfo)),
+                                                 pages_);
+        if (!memory) return false;
+        auto* nodes = static_cast<Order*>(memory.data());
+        auto* cold = reinterpret_cast<OrderInfo*>(nodes + count);
+        slabs_.push_back(Slab{std::move(memory), nodes, cold});
+        mapped_ += count;
+        return true;
+    }
+
+    // Extend capacity into the mapped tail, or map a new slab
+    bool grow() {
+        if (capacity_ >= max_capacity_) return false;
+        if (capacity_ == mapped_ && !map_slab()) return false;
+        capacity_ = mapped_ < max_capacity_ ? mapped_ : max_capacity_;
+        return true;
+    }
+
+    PageOptions pages_;
+    std::vector<Slab> slabs_;   // reserved for max_capacity up front
+    unsigned slab_shift_ = 0;
+    std::size_t slab_mask_ = 0;
+
+    std::size_t capacity_;      // usable slots right now
+    std::size_t max_capacity_;  // growth limit
+    std::size_t mapped_ = 0;    // slots backed by slabs
+    std::size_t next_unused_ = 0;
+    OrderHandle free_head_ = NULL_HANDLE;
+    std::size_t size_ = 0;
 };
 
+using OrderPool = BasicOrderPool<DefaultBookTraits>;
+
 }  // namespace lob
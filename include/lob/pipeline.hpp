@@ -0,0 +1,312 @@
+#pragma once
+
+#include "order_book.hpp"
+#include "spsc_ring.hpp"
+#include "matching_engine.hpp"
+#include "journal.hpp"
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace lob {
+
+enum class CommandType : std::uint8_t {
+    Add = 0,
+    Cancel = 1,
+    Modify = 2,
+    Replace = 3
+};
+
+// Fixed-size ingress record. tag is the caller's correlation ID, echoed in
+// the ack; the book assigns order IDs itself.
+struct OrderCommand {
+    CommandType type;
+    Side side;
+    OrderType order_type;
+    std::uint64_t tag;
+    OrderId order_id;  // cancel / modify / replace target
+    Price price;       // add or replace price
+    Quantity quantity;  // add size, or new total for modify / replace
+
+    static OrderCommand add(std::uint64_t tag, Side side, OrderType type, Price price,
+                            Quantity quantity) {
+        return OrderCommand{CommandType::Add, side, type, tag, 0, price, quantity};
+    }
+    static OrderCommand cancel(std::uint64_t tag, OrderId id) {
+        return OrderCommand{CommandType::Cancel, Side::Buy, OrderType::Limit, tag, id, 0, 0};
+    }
+    static OrderCommand modify(std::uint64_t tag, OrderId id, Quantity quantity) {
+        return OrderCommand{CommandType::Modify, Side::Buy, OrderType::Limit, tag, id, 0, quantity};
+    }
+    static OrderCommand replace(std::uint64_t tag, OrderId id, Price price, Quantity quantity) {
+        return OrderCommand{CommandType::Replace, Side::Buy, OrderType::Limit, tag, id, price,
+                            quantity};
+    }
+};
+
+// Outcome of one command. Cancel / modify / replace of an unknown ID is Rejected
+// with RejectReason::UnknownOrder. remaining_quantity is what is left
+// resting; a modify at or below the filled amount cancels the order.
+// Trades beyond PipelineConfig::max_trades_per_order still execute and
+// count in trade_count, but only trade_count - trades_dropped are published.
+struct CommandAck {
+    std::uint64_t tag;
+    OrderId order_id;
+    Quantity filled_quantity;
+    Quantity remaining_quantity;
+    std::uint32_t trade_count;
+    std::uint32_t trades_dropped;
+    CommandType command;
+    OrderStatus status;
+    RejectReason reject_reason;
+};
+
+enum class EgressType : std::uint8_t {
+    Fill = 0,  // EgressEvent::trade holds a trade
+    Ack = 1    // EgressEvent::ack holds a command ack
+};
+
+// Egress record: a command's trades are published before its ack
+struct EgressEvent {
+    EgressType type;
+    union {
+        Trade trade;
+        CommandAck ack;
+    };
+};
+
+struct PipelineConfig {
+    std::size_t ingress_capacity = 65536;  // commands
+    std::size_t egress_capacity = 262144;  // trades + acks
+    std::size_t max_trades_per_order = 4096;
+    int core = -1;                 // CPU for the matching thread; -1 = unpinned
+    bool yield_when_idle = false;  // yield instead of spinning on an empty ring
+
+    // Optional journal of every command, written by the matching thread.
+    // Commits are MS_ASYNC and happen when the ingress ring runs empty or
+    // every journal_commit_interval commands, whichever comes first.
+    JournalWriter* journal = nullptr;
+    std::size_t journal_commit_interval = 4096;
+};
+
+// A book behind a lock-free ingress ring, run by its own matching thread.
+// The producer (decode) thread calls submit(); the matching thread busy-polls
+// the ingress ring, applies each command and publishes trades and acks to
+// the egress ring, which the producer (or another single consumer) drains
+// with poll(). The matching thread makes no allocation or syscall once
+// started, unless yield_when_idle is set, the pool grows, or a journal
+// commit schedules write-back (which does not wait for the disk).
+//
+// If the egress ring is full the matching thread waits for the consumer;
+// during stop() events that still do not fit are counted as dropped.
+template <typename Listener>
+class BasicBookPipeline {
+public:
+    using Book = BasicOrderBook<Listener>;
+
+    explicit BasicBookPipeline(const BookConfig& book_config,
+                               const PipelineConfig& config = PipelineConfig(),
+                               Listener listener = Listener())
+        : config_(config), book_(book_config, std::move(listener)),
+          ingress_(config.ingress_capacity, ring_pages()),
+          egress_(config.egress_capacity, ring_pages()),
+          trade_storage_(config.max_trades_per_order),
+          trades_(trade_storage_.data(), trade_storage_.size()) {}
+
+    ~BasicBookPipeline() { stop(); }
+
+    BasicBookPipeline(const BasicBookPipeline&) = delete;
+    BasicBookPipeline& operator=(const BasicBookPipeline&) = delete;
+
+    // Start the matching thread (no-op if running)
+    void start() {
+        if (thread_.joinable()) return;
+        stopping_.store(false, std::memory_order_relaxed);
+        thread_ = std::thread([this] { run(); });
+    }
+
+    // Process every command already submitted, then join the thread
+    void stop() {
+        if (!thread_.joinable()) return;
+        stopping_.store(true, std::memory_order_release);
+        thread_.join();
+    }
+
+    bool running() const { return thread_.joinable(); }
+
+    // Producer side — false if the ingress ring is full
+    bool submit(const OrderCommand& command) { return ingress_.try_push(command); }
+
+    // Consumer side — false if no event is waiting
+    bool poll(EgressEvent& event) { return egress_.try_pop(event); }
+
+    // Only safe to touch while the matching thread is stopped
+    Book& book() { return book_; }
+    const Book& book() const { return book_; }
+
+    std::uint64_t commands_processed() const {
+        return processed_.load(std::memory_order_acquire);
+    }
+    std::uint64_t egress_dropped() const { return dropped_.load(std::memory_order_acquire); }
+
+private:
+    static PageOptions ring_pages() {
+        PageOptions pages;
+        pages.prefault = true;
+        return pages;
+    }
+
+    void run() {
+        if (config_.core >= 0) pin_current_thread(config_.core);
+        book_.warm_up();
+
+        OrderCommand command;
+        for (;;) {
+            if (ingress_.try_pop(command)) {
+                process(command);
+                std::uint64_t done = processed_.load(std::memory_order_relaxed) + 1;
+                processed_.store(done, std::memory_order_release);
+                if (config_.journal && done % config_.journal_commit_interval == 0) {
+                    config_.journal->commit();
+                }
+            } else {
+                if (config_.journal) config_.journal->commit();  // group commit when idle
+                if (stopping_.load(std::memory_order_acquire)) {
+                    if (ingress_.empty()) return;
+                } else {
+                    idle();
+                }
+            }
+        }
+    }
+
+    void process(const OrderCommand& command) {
+        CommandAck ack{};
+        ack.tag = command.tag;
+        ack.command = command.type;
+        if (config_.journal && !journal(command)) {
+            ack.order_id = command.order_id;
+            ack.status = OrderStatus::Rejected;
+            ack.reject_reason = RejectReason::JournalFull;
+            ack.remaining_quantity = command.quantity;
+            EgressEvent event;
+            event.type = EgressType::Ack;
+            event.ack = ack;
+            publish(event);
+            return;
+        }
+        switch (command.type) {
+        case CommandType::Add: {
+            trades_.clear();
+            OrderAck result = book_.add_order(command.side, command.order_type, command.price,
+                                              command.quantity, trades_);
+            publish_trades(ack);
+            fill_ack(ack, result);
+            break;
+        }
+        case CommandType::Cancel:
+            ack.order_id = command.order_id;
+            finish(ack, book_.cancel_order(command.order_id), OrderStatus::Cancelled);
+            break;
+        case CommandType::Modify: {
+            ack.order_id = command.order_id;
+            bool ok = book_.modify_order(command.order_id, command.quantity);
+            ack.remaining_quantity = book_.open_quantity(command.order_id);
+            finish(ack, ok, ack.remaining_quantity ? OrderStatus::Active : OrderStatus::Cancelled);
+            break;
+        }
+        case CommandType::Replace: {
+            trades_.clear();
+            OrderAck result = book_.replace_order(command.order_id, command.price,
+                                                  command.quantity, trades_);
+            publish_trades(ack);
+            fill_ack(ack, result);
+            break;
+        }
+        }
+        EgressEvent event;
+        event.type = EgressType::Ack;
+        event.ack = ack;
+        publish(event);
+    }
+
+    bool journal(const OrderCommand& command) {
+        switch (command.type) {
+        case CommandType::Add:
+            return config_.journal->append_add(command.side, command.order_type, command.price,
+                                               command.quantity);
+        case CommandType::Cancel:
+            return config_.journal->append_cancel(command.order_id);
+        case CommandType::Modify:
+            return config_.journal->append_modify(command.order_id, command.quantity);
+        case CommandType::Replace:
+            return config_.journal->append_replace(command.order_id, command.price,
+                                                   command.quantity);
+        }
+        return false;
+    }
+
+    void publish_trades(CommandAck& ack) {
+        ack.trades_dropped = static_cast<std::uint32_t>(trades_.dropped);
+        for (const Trade& trade : trades_) {
+            EgressEvent event;
+            event.type = EgressType::Fill;
+            event.trade = trade;
+            publish(event);
+        }
+    }
+
+    static void fill_ack(CommandAck& ack, const OrderAck& result) {
+        ack.order_id = result.order_id;
+        ack.status = result.status;
+        ack.reject_reason = result.reject_reason;
+        ack.filled_quantity = result.filled_quantity;
+        ack.remaining_quantity = result.remaining_quantity;
+        ack.trade_count = static_cast<std::uint32_t>(result.trade_count);
+    }
+
+    static void finish(CommandAck& ack, bool ok, OrderStatus success) {
+        ack.status = ok ? success : OrderStatus::Rejected;
+        ack.reject_reason = ok ? RejectReason::None : RejectReason::UnknownOrder;
+    }
+
+    // Back-pressure: wait for the consumer rather than lose an event
+    void publish(const EgressEvent& event) {
+        while (!egress_.try_push(event)) {
+            if (stopping_.load(std::memory_order_acquire)) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            idle();
+        }
+    }
+
+    void idle() {
+        if (config_.yield_when_idle) {
+            std::this_thread::yield();
+        } else {
+            cpu_relax();
+        }
+    }
+
+    PipelineConfig config_;
+    Book book_;
+    SpscRing<OrderCommand> ingress_;
+    SpscRing<EgressEvent> egress_;
+    std::vector<Trade> trade_storage_;
+    TradeBuffer trades_;
+
+    std::thread thread_;
+    std::atomic<bool> stopping_{false};
+    std::atomic<std::uint64_t> processed_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+};
+
+using BookPipeline = BasicBookPipeline<CallbackListener>;
+
+extern template class BasicBookPipeline<CallbackListener>;
+
+}  // namespace lob
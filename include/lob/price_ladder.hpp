@@ -0,0 +1,301 @@
+#pragma once
+
+#include "price_level.hpp"
+#include "memory.hpp"
+#include "level_bitmap.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cstddef>
+
+namespace lob {
+
+// Liquidity a hypothetical market order would take from one side of the
+// book, best level first. Produced without modifying the book.
+template <typename Traits>
+struct BasicFillEstimate {
+    using Price = typename Traits::Price;
+    using Quantity = typename Traits::Quantity;
+
+    Quantity filled = 0;                // requested quantity, or all the side holds
+    std::uint64_t cost = 0;             // sum of price * quantity over the fills
+    Price worst_price = INVALID_PRICE;  // last level reached: the limit that fills it
+    std::size_t levels = 0;             // price levels the fills touch
+
+    // Volume-weighted average fill price in price units; 0 if nothing fills
+    double average_price() const {
+        return filled == 0 ? 0.0 : static_cast<double>(cost) / static_cast<double>(filled);
+    }
+};
+
+using FillEstimate = BasicFillEstimate<DefaultBookTraits>;
+
+// Array-backed price levels for one side of the book over a fixed tick band.
+// Level i holds price min_price + i * tick_size. A hierarchical bitmap
+// marks non-empty levels, so when the top level empties the best-price
+// cursor finds the next live level in a few word operations however wide
+// the gap. Level totals are mirrored into a dense quantity array (see
+// sync()) for depth scans. All storage is page-mapped in the constructor.
+template <typename Traits>
+class BasicPriceLadder {
+public:
+    using Price = typename Traits::Price;
+    using Quantity = typename Traits::Quantity;
+    using PriceLevel = BasicPriceLevel<Traits>;
+    using FillEstimate = BasicFillEstimate<Traits>;
+
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    BasicPriceLadder() = default;
+
+    BasicPriceLadder(Side side, Price min_price, Price max_price, Price tick_size,
+                const PageOptions& pages = PageOptions())
+        : side_(side), min_price_(min_price), max_price_(max_price), tick_size_(tick_size) {
+        if (tick_size == 0 || max_price < min_price || (max_price - min_price) % tick_size != 0) {
+            throw std::invalid_argument("PriceLadder: invalid price band");
+        }
+        std::size_t count = static_cast<std::size_t>((max_price - min_price) / tick_size) + 1;
+        levels_ = PageArray<PriceLevel>(count, pages);
+        for (std::size_t i = 0; i < count; ++i) {
+            new (&levels_[i]) PriceLevel(min_price + static_cast<Price>(i) * tick_size, side);
+        }
+        occupied_ = LevelBitmap(count, pages);
+        quantities_ = PageArray<Quantity>(count, pages);
+    }
+
+    // True if the price lies inside the band and on a tick boundary
+    bool contains(Price price) const {
+        return price >= min_price_ && price <= max_price_ &&
+               (price - min_price_) % tick_size_ == 0;
+    }
+
+    // O(1) — level at price, or nullptr if the level is empty or out of band
+    PriceLevel* find(Price price) {
+        if (!contains(price)) return nullptr;
+        std::size_t idx = index_of(price);
+        return occupied_.test(idx) ? &levels_[idx] : nullptr;
+    }
+
+    const PriceLevel* find(Price price) const {
+        return const_cast<BasicPriceLadder*>(this)->find(price);
+    }
+
+    // O(1) — mark the level at price as live and return it. Price must be in band.
+    PriceLevel& get_or_insert(Price price) {
+        std::size_t idx = index_of(price);
+        if (!occupied_.test(idx)) {
+            occupied_.set(idx);
+            ++count_;
+            if (best_ == npos || is_better(idx, best_)) {
+                best_ = idx;
+            }
+        }
+        return levels_[idx];
+    }
+
+    // Release an empty level. Searches the bitmap only if the best level is removed.
+    void erase(const PriceLevel& level) {
+        std::size_t idx = index_of(level.price);
+        occupied_.clear(idx);
+        --count_;
+        if (idx == best_) {
+            best_ = next_worse(idx);
+        }
+    }
+
+    PriceLevel* best() { return best_ == npos ? nullptr : &levels_[best_]; }
+    const PriceLevel* best() const { return best_ == npos ? nullptr : &levels_[best_]; }
+
+    // Visit up to max_levels live levels from best to worst
+    template <typename Fn>
+    void for_each_level(std::size_t max_levels, Fn&& fn) const {
+        std::size_t idx = best_;
+        for (std::size_t n = 0; idx != npos && n < max_levels; ++n) {
+            fn(levels_[idx]);
+            idx = next_worse(idx);
+        }
+    }
+
+    // Best live level strictly worse than price (price must be in band), or nullptr
+    const PriceLevel* next_worse_level(Price price) const {
+        std::size_t idx = next_worse(index_of(price));
+        return idx == npos ? nullptr : &levels_[idx];
+    }
+
+    // Worst live level strictly better than price (price must be in band), or nullptr
+    const PriceLevel* next_better_level(Price price) const {
+        std::size_t idx = next_better(index_of(price));
+        return idx == npos ? nullptr : &levels_[idx];
+    }
+
+    // Copy a level's total into the dense quantity array. The owner calls
+    // this after every change to a level's total_quantity, including the
+    // change that empties it.
+    void sync(const PriceLevel& level) {
+        quantities_[static_cast<std::size_t>(&level - levels_.data())] = level.total_quantity;
+    }
+
+    // Walk from the best level towards worse ones until qty is covered.
+    // The dense quantity array is read in blocks of SCAN_BLOCK levels: a
+    // block sum decides whether the order clears the block, and each dense
+    // stretch of cleared levels is then tallied in one straight loop. Both
+    // loops have no data-dependent branches, so the compiler vectorises
+    // them. Only the block where the order stops is walked level by level,
+    // and empty blocks jump to the next live level through the bitmap.
+    FillEstimate estimate_fill(Quantity qty) const {
+        FillEstimate estimate;
+        if (best_ == npos || qty == 0) return estimate;
+        const Quantity* q = quantities_.data();
+        const bool up = side_ == Side::Sell;  // asks get worse upwards
+        const std::size_t count = levels_.size();
+        std::uint64_t wanted = qty;
+        std::uint64_t weighted = 0;     // sum of quantity * level index
+        std::size_t last = npos;        // worst level reached
+        std::size_t idx = best_;        // first level of the next block
+        std::size_t run_start = best_;  // first level of the stretch being cleared
+
+        // Levels [lo, hi) are cleared entirely
+        auto tally = [&](std::size_t lo, std::size_t hi) {
+            std::uint64_t w = 0;
+            std::size_t live = 0;
+            for (std::size_t i = lo; i < hi; ++i) {
+                w += std::uint64_t{q[i]} * i;
+                live += q[i] != 0;
+            }
+            weighted += w;
+            estimate.levels += live;
+        };
+
+        for (;;) {
+            std::size_t lo = up ? idx : (idx + 1 > SCAN_BLOCK ? idx + 1 - SCAN_BLOCK : 0);
+            std::size_t hi = up ? std::min(idx + SCAN_BLOCK, count) : idx + 1;
+            std::uint64_t sum = block_sum(q, lo, hi);
+
+            if (sum >= wanted) {
+                // The order stops inside this block
+                if (up) {
+                    tally(run_start, lo);
+                } else {
+                    tally(hi, run_start + 1);
+                }
+                for (std::size_t k = 0; wanted > 0; ++k) {
+                    std::size_t i = up ? lo + k : hi - 1 - k;
+                    std::uint64_t take = std::min<std::uint64_t>(q[i], wanted);
+                    if (take == 0) continue;
+                    wanted -= take;
+                    weighted += take * i;
+                    ++estimate.levels;
+                    last = i;
+                }
+                break;
+            }
+
+            wanted -= sum;
+            bool edge = up ? hi == count : lo == 0;
+            if (sum != 0 && !edge) {
+                idx = up ? hi : lo - 1;  // dense: continue with the adjacent block
+                continue;
+            }
+            // The stretch ends here: tally it, then skip the gap
+            if (up) {
+                tally(run_start, hi);
+            } else {
+                tally(lo, run_start + 1);
+            }
+            if (edge) break;
+            idx = up ? occupied_.find_next(hi) : occupied_.find_prev(lo - 1);
+            if (idx == npos) break;
+            run_start = idx;
+        }
+
+        if (wanted > 0) {
+            // The side ran out: its worst live level was the last one reached
+            last = up ? occupied_.find_prev(count - 1) : occupied_.find_next(0);
+        }
+        std::uint64_t filled = qty - wanted;
+        estimate.filled = static_cast<Quantity>(filled);
+        estimate.cost = std::uint64_t{min_price_} * filled + std::uint64_t{tick_size_} * weighted;
+        estimate.worst_price = levels_[last].price;
+        return estimate;
+    }
+
+    // Hint the cache to load the level and bitmap word for a price
+    void prefetch(Price price) const {
+        if (!contains(price)) return;
+        std::size_t idx = index_of(price);
+        __builtin_prefetch(&levels_[idx]);
+        occupied_.prefetch(idx);
+    }
+
+    // Fault in the level array and bitmap pages
+    void warm_up() const noexcept {
+        levels_.warm_up();
+        occupied_.warm_up();
+        quantities_.warm_up();
+    }
+
+    std::size_t size() const { return count_; }
+    std::size_t capacity() const { return levels_.size(); }
+    const PageBuffer& memory() const { return levels_.memory(); }
+    // Level array, bitmap and quantity mirror
+    std::size_t memory_bytes() const {
+        return levels_.bytes() + occupied_.memory().size() + quantities_.bytes();
+    }
+    Price min_price() const { return min_price_; }
+    Price max_price() const { return max_price_; }
+    Price tick_size() const { return tick_size_; }
+
+    // Levels summed per step of estimate_fill: two AVX-512 or four AVX2
+    // vectors of 64-bit totals
+    static constexpr std::size_t SCAN_BLOCK = 16;
+
+private:
+    std::size_t index_of(Price price) const {
+        return static_cast<std::size_t>((price - min_price_) / tick_size_);
+    }
+
+    static std::uint64_t block_sum(const Quantity* q, std::size_t lo, std::size_t hi) {
+        std::uint64_t sum = 0;
+        if (hi - lo == SCAN_BLOCK) {
+            // Constant trip count: a few vector adds and one reduction
+            for (std::size_t j = 0; j < SCAN_BLOCK; ++j) sum += q[lo + j];
+        } else {
+            for (std::size_t i = lo; i < hi; ++i) sum += q[i];
+        }
+        return sum;
+    }
+
+    // Bids improve with higher prices, asks with lower
+    bool is_better(std::size_t a, std::size_t b) const {
+        return side_ == Side::Buy ? a > b : a < b;
+    }
+
+    std::size_t next_worse(std::size_t idx) const {
+        if (side_ == Side::Buy) {
+            return idx == 0 ? npos : occupied_.find_prev(idx - 1);
+        }
+        return occupied_.find_next(idx + 1);
+    }
+
+    std::size_t next_better(std::size_t idx) const {
+        if (side_ == Side::Buy) {
+            return occupied_.find_next(idx + 1);
+        }
+        return idx == 0 ? npos : occupied_.find_prev(idx - 1);
+    }
+
+    Side side_ = Side::Buy;
+    Price min_price_ = 0;
+    Price max_price_ = 0;
+    Price tick_size_ = 1;
+
+    PageArray<PriceLevel> levels_;        // one slot per tick in the band
+    LevelBitmap occupied_;                // slot i set = levels_[i] is live
+    PageArray<Quantity> quantities_;      // levels_[i].total_quantity, densely packed
+    std::size_t best_ = npos;
+    std::size_t count_ = 0;
+};
+
+using PriceLadder = BasicPriceLadder<DefaultBookTraits>;
+
+}  // namespace lob
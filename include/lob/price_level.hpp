@@ -1,57 +1,95 @@
 #pragma once
 
 #include "order.hpp"
+#include "order_pool.hpp"
 
 namespace lob {
 
 // Doubly-linked list of orders at a single price point.
+// Links are pool handles, so every operation takes the owning OrderPool.
 // All operations O(1). No heap allocation.
-struct PriceLevel {
+//
+// total_quantity and order_count cover live orders only. A lazily
+// cancelled order (see kill_order) stays linked as a tombstone with zero
+// remaining until whoever walks past it unlinks it.
+template <typename Traits>
+struct BasicPriceLevel {
+    using Price = typename Traits::Price;
+    using Quantity = typename Traits::Quantity;
+    using OrderPool = BasicOrderPool<Traits>;
+    using Order = BasicOrder<Traits>;
+
     Price price = INVALID_PRICE;
     Quantity total_quantity = 0;
     std::uint32_t order_count = 0;
-    Order* head = nullptr;  // oldest order (first to execute)
-    Order* tail = nullptr;  // newest order
+    Side side = Side::Buy;
+    OrderHandle head = NULL_HANDLE;  // oldest order (first to execute)
+    OrderHandle tail = NULL_HANDLE;  // newest order
 
-    PriceLevel() = default;
-    explicit PriceLevel(Price p) : price(p) {}
+    BasicPriceLevel() = default;
+    explicit BasicPriceLevel(Price p, Side s = Side::Buy) : price(p), side(s) {}
 
-    bool empty() const { return head == nullptr; }
+    // No live orders (tombstones may still be linked)
+    bool empty() const { return order_count == 0; }
 
     // O(1) — append order to tail (FIFO: oldest at head executes first)
-    void add_order(Order* order) {
-        order->prev = tail;
-        order->next = nullptr;
-        if (tail) {
-            tail->next = order;
+    void add_order(OrderPool& pool, OrderHandle h) {
+        Order& order = pool[h];
+        order.prev = tail;
+        order.next = NULL_HANDLE;
+        if (tail != NULL_HANDLE) {
+            pool[tail].next = h;
         } else {
-            head = order;
+            head = h;
         }
-        tail = order;
-        total_quantity += order->remaining();
+        tail = h;
+        order.level = this;
+        total_quantity += order.remaining;
         ++order_count;
     }
 
     // O(1) — remove order from anywhere in the list
-    void remove_order(Order* order) {
-        if (order->prev) {
-            order->prev->next = order->next;
+    void remove_order(OrderPool& pool, OrderHandle h) {
+        Order& order = pool[h];
+        total_quantity -= order.remaining;
+        --order_count;
+        unlink(pool, h);
+    }
+
+    // O(1) — cancel in place: the order leaves the level's totals but keeps
+    // its place in the list, so neither neighbour is touched
+    void kill_order(Order& order) {
+        total_quantity -= order.remaining;
+        --order_count;
+        order.remaining = 0;
+    }
+
+    // O(1) — take an order (or tombstone) out of the list; totals unchanged
+    void unlink(OrderPool& pool, OrderHandle h) {
+        Order& order = pool[h];
+        if (order.prev != NULL_HANDLE) {
+            pool[order.prev].next = order.next;
         } else {
-            head = order->next;
+            head = order.next;
         }
-        if (order->next) {
-            order->next->prev = order->prev;
+        if (order.next != NULL_HANDLE) {
+            pool[order.next].prev = order.prev;
         } else {
-            tail = order->prev;
+            tail = order.prev;
         }
-        total_quantity -= order->remaining();
-        --order_count;
-        order->prev = nullptr;
-        order->next = nullptr;
+        order.prev = NULL_HANDLE;
+        order.next = NULL_HANDLE;
+        order.level = nullptr;
     }
 
     // O(1) — peek at the oldest order (front of queue)
-    Order* front() const { return head; }
+    OrderHandle front() const { return head; }
 };
 
+using PriceLevel = BasicPriceLevel<DefaultBookTraits>;
+
+static_assert(sizeof(PriceLevel) == 32, "PriceLevel should stay half a cache line");
+static_assert(sizeof(BasicPriceLevel<CompactBookTraits>) == 24,
+              "Compact PriceLevel should be three quarters of the default");
+
 }  // namespace lob
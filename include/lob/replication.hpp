@@ -0,0 +1,405 @@
+#pragma once
+
+#include "journal.hpp"
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+namespace lob {
+
+// Hot-standby replication of book inputs. The primary streams its journal
+// records, in journal order, as UDP datagrams to a standby (unicast, or a
+// multicast group so several standbys share one stream). A record's
+// sequence number is its journal position. The standby applies records
+// to its own book in sequence, so, as with replay_journal, its order
+// IDs, timestamps and counters match the primary's exactly. It can take
+// over from its last applied record without restoring a snapshot.
+//
+// Loss is repaired by NACK: a standby that sees a sequence ahead of its
+// own sends the primary the first sequence it is missing. The primary
+// resends from there out of a ring of recent records. A standby that
+// falls further behind than the ring holds is told so and reports lost();
+// it must then be rebuilt from a snapshot and the journal (see recover()).
+// The tail of the stream is covered by heartbeats carrying the primary's
+// next sequence, sent from the primary's idle loop.
+
+// Datagram kinds
+enum class ReplicationPacketType : std::uint8_t {
+    Data = 1,       // count records from sequence
+    Heartbeat = 2,  // primary's next sequence; no records
+    Nack = 3,       // standby to primary: resend from sequence
+    Gone = 4        // primary to standby: records before sequence are not retained
+};
+
+struct ReplicationPacketHeader {
+    std::uint32_t magic;
+    ReplicationPacketType type;
+    std::uint8_t reserved;
+    std::uint16_t count;
+    std::uint64_t sequence;
+};
+
+static_assert(sizeof(ReplicationPacketHeader) == 16, "ReplicationPacketHeader must stay 16 bytes");
+
+constexpr std::uint32_t REPLICATION_MAGIC = 0x4c4f4252;  // "LOBR"
+// Records per datagram: header plus records stay inside a 1500-byte MTU
+constexpr std::size_t REPLICATION_MAX_RECORDS = 44;
+constexpr std::size_t REPLICATION_MAX_PACKET =
+    sizeof(ReplicationPacketHeader) + REPLICATION_MAX_RECORDS * sizeof(JournalRecord);
+
+// IPv4 address and port, host byte order
+struct UdpEndpoint {
+    std::uint32_t address = 0;
+    std::uint16_t port = 0;
+
+    bool operator==(const UdpEndpoint& other) const {
+        return address == other.address && port == other.port;
+    }
+    bool operator!=(const UdpEndpoint& other) const { return !(*this == other); }
+};
+
+// Dotted-quad address; throws std::invalid_argument for anything else
+UdpEndpoint udp_endpoint(const std::string& address, std::uint16_t port);
+
+// Non-blocking IPv4 datagram socket. Binding to a multicast address binds
+// the port on every interface and joins the group. Creating or binding
+// the socket throws std::system_error.
+class UdpSocket {
+public:
+    UdpSocket(const std::string& address, std::uint16_t port);
+    ~UdpSocket();
+
+    UdpSocket(const UdpSocket&) = delete;
+    UdpSocket& operator=(const UdpSocket&) = delete;
+
+    // False if the datagram was not handed to the kernel (e.g. ENOBUFS)
+    bool send(const void* data, std::size_t size, const UdpEndpoint& to);
+
+    // Size of the next datagram, or -1 once none is waiting
+    long receive(void* data, std::size_t size, UdpEndpoint& from);
+
+    // Outgoing multicast: hop limit, and loopback so a standby on the
+    // same host sees the group
+    void set_multicast(int ttl);
+
+    // Kernel send and receive buffer sizes, capped by net.core.[rw]mem_max
+    void set_buffer_size(std::size_t bytes);
+
+    UdpEndpoint local() const;
+
+private:
+    int fd_ = -1;
+};
+
+struct ReplicationConfig {
+    // Sender: the standby or group to send to. Receiver: the address to
+    // bind (a group is joined), with port 0 picking a free port.
+    std::string address = "127.0.0.1";
+    std::uint16_t port = 0;
+    // Sender: records per datagram, up to REPLICATION_MAX_RECORDS. 1 sends
+    // every input as it is published; larger values batch until flush().
+    std::size_t records_per_packet = 1;
+    // Sender: recent records kept for retransmission, rounded up to a
+    // power of two
+    std::size_t retransmit_capacity = 1 << 16;
+    int multicast_ttl = 1;
+    // Both sides: socket buffer, enough to ride out a standby that is
+    // descheduled for a while without dropping datagrams
+    std::size_t socket_buffer = 4 << 20;
+    // Sender: heartbeat spacing under idle()
+    std::chrono::nanoseconds heartbeat_interval = std::chrono::microseconds(100);
+    // Receiver: wait before repeating an unanswered NACK
+    std::chrono::nanoseconds nack_interval = std::chrono::microseconds(200);
+};
+
+struct ReplicationSenderStats {
+    std::uint64_t packets = 0;         // data datagrams, first sends and resends
+    std::uint64_t records = 0;         // records published
+    std::uint64_t retransmitted = 0;   // records sent again for a NACK
+    std::uint64_t nacks = 0;
+    std::uint64_t unrecoverable = 0;   // NACKs for records no longer in the ring
+    std::uint64_t send_failures = 0;
+};
+
+// Primary side. publish() copies a record into the retransmit ring and
+// sends it once a datagram's worth is pending; nothing is allocated after
+// construction. Call idle() from the matching thread's idle loop: it serves
+// NACKs and sends a heartbeat every heartbeat_interval, which bounds how
+// long a lost tail goes unnoticed.
+class ReplicationSender {
+public:
+    explicit ReplicationSender(const ReplicationConfig& config);
+
+    ReplicationSender(const ReplicationSender&) = delete;
+    ReplicationSender& operator=(const ReplicationSender&) = delete;
+
+    void publish(const JournalRecord& record) {
+        ring_[next_ & mask_] = record;
+        ++next_;
+        ++stats_.records;
+        if (next_ - sent_ >= batch_) flush();
+    }
+
+    // Publish every record journal holds beyond next_sequence(), so the
+    // stream's sequence numbers stay the journal's positions
+    void follow(const JournalWriter& journal) {
+        for (std::size_t i = next_; i < journal.size(); ++i) publish(journal.begin()[i]);
+    }
+
+    // Send records published but not yet sent
+    void flush();
+
+    // Flush, then tell the standby where the stream ends
+    void heartbeat();
+
+    // Answer waiting NACKs; returns the number served
+    std::size_t poll();
+
+    // Idle-loop work: poll(), plus a heartbeat once heartbeat_interval
+    // has passed since the last one
+    void idle() {
+        poll();
+        auto now = std::chrono::steady_clock::now();
+        if (now - heartbeat_at_ >= heartbeat_interval_) {
+            heartbeat();
+            heartbeat_at_ = now;
+        }
+    }
+
+    std::uint64_t next_sequence() const { return next_; }
+    const ReplicationSenderStats& stats() const { return stats_; }
+    UdpEndpoint local() const { return socket_.local(); }
+
+private:
+    // Send ring records [first, last) in full datagrams
+    void send_range(std::uint64_t first, std::uint64_t last);
+    void send_control(ReplicationPacketType type, std::uint64_t sequence, const UdpEndpoint& to);
+
+    UdpSocket socket_;
+    UdpEndpoint standby_;
+    std::vector<JournalRecord> ring_;
+    std::uint64_t mask_;
+    std::uint64_t next_ = 0;  // sequence of the next record published
+    std::uint64_t sent_ = 0;  // records before this have been sent
+    std::size_t batch_;
+    std::chrono::nanoseconds heartbeat_interval_;
+    std::chrono::steady_clock::time_point heartbeat_at_;
+    ReplicationSenderStats stats_;
+    alignas(8) char packet_[REPLICATION_MAX_PACKET];
+};
+
+struct ReplicationReceiverStats {
+    std::uint64_t packets = 0;
+    std::uint64_t applied = 0;     // records applied to the book
+    std::uint64_t duplicates = 0;  // records already applied
+    std::uint64_t gaps = 0;        // datagrams that arrived ahead of the stream
+    std::uint64_t nacks = 0;
+    std::uint64_t malformed = 0;
+};
+
+// Standby side: applies the stream to book, which must be built with the
+// primary's BookConfig (book_config_from of its journal header) and hold
+// the state at start_sequence (empty for 0, or restored from a snapshot
+// taken at that journal position). Records that arrive ahead of a gap are
+// dropped and resent by the primary after the NACK.
+template <typename Book>
+class ReplicationReceiver {
+public:
+    ReplicationReceiver(Book& book, const ReplicationConfig& config,
+                        std::uint64_t start_sequence = 0)
+        : book_(book), socket_(config.address, config.port), next_(start_sequence),
+          primary_next_(start_sequence), nack_interval_(config.nack_interval) {
+        socket_.set_buffer_size(config.socket_buffer);
+    }
+
+    // Drain waiting datagrams into the book; returns the records applied
+    std::size_t poll() {
+        std::uint64_t before = next_;
+        UdpEndpoint from;
+        long size;
+        while ((size = socket_.receive(packet_, sizeof(packet_), from)) >= 0) {
+            handle(static_cast<std::size_t>(size), from);
+        }
+        if (primary_next_ > next_ && !lost_) nack();
+        return static_cast<std::size_t>(next_ - before);
+    }
+
+    // Sequence of the next record to apply: the journal position the
+    // book is at
+    std::uint64_t next_sequence() const { return next_; }
+    // Highest sequence the primary has been seen to reach
+    std::uint64_t primary_sequence() const { return primary_next_; }
+    // The primary no longer holds a record this standby is missing
+    bool lost() const { return lost_; }
+
+    const ReplicationReceiverStats& stats() const { return stats_; }
+    UdpEndpoint local() const { return socket_.local(); }
+    Book& book() { return book_; }
+
+private:
+    void handle(std::size_t size, const UdpEndpoint& from) {
+        ++stats_.packets;
+        ReplicationPacketHeader header;
+        if (size < sizeof(header)) {
+            ++stats_.malformed;
+            return;
+        }
+        std::memcpy(&header, packet_, sizeof(header));
+        if (header.magic != REPLICATION_MAGIC) {
+            ++stats_.malformed;
+            return;
+        }
+        primary_ = from;
+        have_primary_ = true;
+        switch (header.type) {
+        case ReplicationPacketType::Data:
+            if (size != sizeof(header) + header.count * sizeof(JournalRecord)) {
+                ++stats_.malformed;
+                return;
+            }
+            see(header.sequence + header.count);
+            apply(header.sequence, header.count);
+            break;
+        case ReplicationPacketType::Heartbeat:
+            see(header.sequence);
+            break;
+        case ReplicationPacketType::Gone:
+            if (header.sequence > next_) lost_ = true;
+            break;
+        default:
+            ++stats_.malformed;
+            break;
+        }
+    }
+
+    void see(std::uint64_t sequence) {
+        if (sequence > primary_next_) primary_next_ = sequence;
+    }
+
+    void apply(std::uint64_t first, std::size_t count) {
+        if (first > next_) {
+            ++stats_.gaps;
+            return;
+        }
+        const char* records = packet_ + sizeof(ReplicationPacketHeader);
+        for (std::size_t i = 0; i < count; ++i) {
+            if (first + i < next_) {
+                ++stats_.duplicates;
+                continue;
+            }
+            JournalRecord record;
+            std::memcpy(&record, records + i * sizeof(JournalRecord), sizeof(record));
+            apply_journal_record(record, book_, discard_);
+            ++next_;
+            ++stats_.applied;
+        }
+    }
+
+    // At most one NACK per nack_interval for the same missing sequence
+    void nack() {
+        if (!have_primary_) return;
+        auto now = std::chrono::steady_clock::now();
+        if (next_ == nacked_ && now - nacked_at_ < nack_interval_) return;
+        ReplicationPacketHeader header{REPLICATION_MAGIC, ReplicationPacketType::Nack, 0, 0, next_};
+        if (socket_.send(&header, sizeof(header), primary_)) {
+            ++stats_.nacks;
+            nacked_ = next_;
+            nacked_at_ = now;
+        }
+    }
+
+    Book& book_;
+    UdpSocket socket_;
+    TradeBuffer discard_;  // trades are counted by the book, not kept
+    std::uint64_t next_;
+    std::uint64_t primary_next_;
+    std::chrono::nanoseconds nack_interval_;
+    UdpEndpoint primary_;
+    bool have_primary_ = false;
+    bool lost_ = false;
+    std::uint64_t nacked_ = ~std::uint64_t{0};
+    std::chrono::steady_clock::time_point nacked_at_;
+    ReplicationReceiverStats stats_;
+    alignas(8) char packet_[REPLICATION_MAX_PACKET];
+};
+
+// A journaled book that also streams each journaled input to a standby.
+// Inputs are published after they have been applied, before the call
+// returns. With records_per_packet == 1 anything acknowledged to the
+// caller is already on the wire; with larger batches the last records wait
+// in the sender until a batch fills, so call flush() before relying on the
+// standby having them (idle() also flushes, with each heartbeat).
+template <typename Listener>
+class BasicReplicatedBook {
+public:
+    using Book = BasicOrderBook<Listener>;
+
+    BasicReplicatedBook(const std::string& journal_path, const BookConfig& config,
+                        std::size_t max_records, const ReplicationConfig& replication,
+                        std::size_t commit_interval = 4096, Listener listener = Listener())
+        : journaled_(journal_path, config, max_records, commit_interval, std::move(listener)),
+          sender_(replication) {}
+
+    OrderAck add_order(Side side, OrderType type, Price price, Quantity quantity,
+                       TradeBuffer& trades) {
+        OrderAck ack = journaled_.add_order(side, type, price, quantity, trades);
+        sender_.follow(journaled_.journal());
+        return ack;
+    }
+
+    bool cancel_order(OrderId id) {
+        bool ok = journaled_.cancel_order(id);
+        sender_.follow(journaled_.journal());
+        return ok;
+    }
+
+    bool modify_order(OrderId id, Quantity new_quantity) {
+        bool ok = journaled_.modify_order(id, new_quantity);
+        sender_.follow(journaled_.journal());
+        return ok;
+    }
+
+    OrderAck replace_order(OrderId id, Price new_price, Quantity new_quantity,
+                           TradeBuffer& trades) {
+        OrderAck ack = journaled_.replace_order(id, new_price, new_quantity, trades);
+        sender_.follow(journaled_.journal());
+        return ack;
+    }
+
+    bool begin_auction() {
+        bool ok = journaled_.begin_auction();
+        sender_.follow(journaled_.journal());
+        return ok;
+    }
+
+    AuctionResult uncross(TradeBuffer& trades) {
+        AuctionResult result = journaled_.uncross(trades);
+        sender_.follow(journaled_.journal());
+        return result;
+    }
+
+    // Call from the idle loop: serves NACKs and paces heartbeats
+    void idle() { sender_.idle(); }
+
+    // Send inputs still held in a partial batch
+    void flush() { sender_.flush(); }
+
+    bool save_snapshot(const std::string& path) const { return journaled_.save_snapshot(path); }
+
+    Book& book() { return journaled_.book(); }
+    const Book& book() const { return journaled_.book(); }
+    JournalWriter& journal() { return journaled_.journal(); }
+    ReplicationSender& sender() { return sender_; }
+
+private:
+    BasicJournaledBook<Listener> journaled_;
+    ReplicationSender sender_;
+};
+
+using ReplicatedBook = BasicReplicatedBook<CallbackListener>;
+
+}  // namespace lob
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "spsc_ring.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <cstddef>
+
+namespace lob {
+
+// Single-writer sequence lock around a trivially copyable value. The writer
+// never waits; readers copy the value and retry if a write overlapped the
+// copy, so any number of them can read without stalling the writer or each
+// other. The payload is held as relaxed atomic words, which keeps the racy
+// reader copy well-defined.
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "seqlock values are copied as bytes");
+
+public:
+    SeqLock() = default;
+    explicit SeqLock(const T& initial) { store(initial); }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    // Writer only
+    void store(const T& value) {
+        std::uint64_t buffer[WORDS] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+        std::uint64_t seq = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(seq + 1, std::memory_order_relaxed);  // odd: write in progress
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < WORDS; ++i) {
+            words_[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        sequence_.store(seq + 2, std::memory_order_release);
+    }
+
+    // One read attempt: false if a write was in progress or overlapped it
+    bool try_load(T& out) const {
+        std::uint64_t before = sequence_.load(std::memory_order_acquire);
+        if (before & 1) return false;
+        std::uint64_t buffer[WORDS];
+        for (std::size_t i = 0; i < WORDS; ++i) {
+            buffer[i] = words_[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence_.load(std::memory_order_relaxed) != before) return false;
+        std::memcpy(&out, buffer, sizeof(T));
+        return true;
+    }
+
+    // Retry until a consistent copy is read
+    T load() const {
+        T out;
+        while (!try_load(out)) cpu_relax();
+        return out;
+    }
+
+    // Completed writes so far
+    std::uint64_t version() const { return sequence_.load(std::memory_order_acquire) / 2; }
+
+private:
+    static constexpr std::size_t WORDS = (sizeof(T) + 7) / 8;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> sequence_{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> words_[WORDS] = {};
+};
+
+}  // namespace lob
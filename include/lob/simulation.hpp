@@ -0,0 +1,167 @@
+#pragma once
+
+#include "order_book.hpp"
+#include "journal.hpp"
+#include "telemetry.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lob {
+
+// What one scenario did, as seen by the book it ran on
+struct ScenarioResult {
+    std::uint64_t inputs = 0;   // book calls made through the context
+    std::uint64_t trades = 0;
+    std::uint64_t volume = 0;
+    std::uint64_t resting = 0;  // orders left on the book at the end
+    std::uint64_t wall_ns = 0;  // whole scenario, set-up included
+    std::size_t worker = 0;
+    bool stolen = false;        // taken from another worker's share
+};
+
+// Totals over many scenarios. The histogram holds per-input latency in ns
+// (when SimulationConfig::measure_latency is set); it makes the type
+// non-copyable, so stats are merged into rather than returned.
+struct SimulationStats {
+    std::uint64_t scenarios = 0;
+    std::uint64_t inputs = 0;
+    std::uint64_t trades = 0;
+    std::uint64_t volume = 0;
+    std::uint64_t resting = 0;
+    std::uint64_t wall_ns = 0;  // summed over scenarios, not elapsed time
+    std::uint64_t steals = 0;   // scenarios that were stolen
+    LatencyHistogram latency;
+
+    void add(const ScenarioResult& result) {
+        ++scenarios;
+        inputs += result.inputs;
+        trades += result.trades;
+        volume += result.volume;
+        resting += result.resting;
+        wall_ns += result.wall_ns;
+        if (result.stolen) ++steals;
+    }
+
+    // Fold other into this; other's owner must be done writing it
+    void merge(const SimulationStats& other) {
+        scenarios += other.scenarios;
+        inputs += other.inputs;
+        trades += other.trades;
+        volume += other.volume;
+        resting += other.resting;
+        wall_ns += other.wall_ns;
+        steals += other.steals;
+        other.latency.add_to(latency);
+    }
+};
+
+struct SimulationConfig {
+    std::size_t threads = 0;   // workers; 0 = std::thread::hardware_concurrency()
+    BookConfig book;           // every worker's book; warm_up runs on the worker
+    int first_core = -1;       // pin worker w to core first_core + w; -1 = unpinned
+    bool measure_latency = true;
+    std::size_t trade_capacity = 1024;  // fills kept per call for trades()
+};
+
+// A scenario's handle on its worker's book. The book starts each scenario
+// empty, with IDs and counters at their initial values (see
+// OrderBook::reset); the inputs below time the call and count it, while
+// book() is there for queries and for driving the book untimed.
+class SimulationContext {
+public:
+    OrderBook& book() { return book_; }
+    std::size_t scenario() const { return scenario_; }
+    std::size_t worker() const { return worker_; }
+
+    // Same semantics as the OrderBook calls. Fills of the last add or
+    // replace are kept in trades(), up to SimulationConfig::trade_capacity.
+    OrderAck add_order(Side side, OrderType type, Price price, Quantity quantity);
+    bool cancel_order(OrderId order_id);
+    bool modify_order(OrderId order_id, Quantity new_quantity);
+    OrderAck replace_order(OrderId order_id, Price new_price, Quantity new_quantity);
+
+    // Apply one journal record; false for End, which applies nothing
+    bool apply(const JournalRecord& record);
+
+    const TradeBuffer& trades() const { return trades_; }
+    std::uint64_t inputs() const { return inputs_; }
+
+private:
+    friend class SimulationRunner;
+
+    SimulationContext(OrderBook& book, std::size_t worker, bool measure_latency,
+                      std::size_t trade_capacity, LatencyHistogram& latency);
+
+    template <typename Call>
+    auto timed(Call&& call) -> decltype(call());
+
+    OrderBook& book_;
+    std::size_t scenario_ = 0;
+    std::size_t worker_;
+    bool measure_latency_;
+    double ns_per_tick_;
+    LatencyHistogram& latency_;
+    std::vector<Trade> trade_storage_;
+    TradeBuffer trades_;
+    std::uint64_t inputs_ = 0;
+};
+
+using Scenario = std::function<void(SimulationContext&)>;
+
+// A scenario that replays a journal file (a recorded symbol-day) through
+// the context. The file is mapped on the worker when the scenario runs; a
+// file that cannot be opened throws from there, and so from run().
+Scenario journal_scenario(std::string path);
+
+// Runs independent scenarios across a pool of worker threads, each with
+// its own book and pool, then merges what they measured.
+//
+// Every worker starts with a contiguous share of the scenarios and takes
+// them oldest first; a worker that runs out steals the back half of the
+// fullest remaining share, so a few long symbol-days do not leave the
+// other cores idle. Queues are ranges of indices guarded by a mutex each;
+// scenarios are coarse enough that the lock never shows.
+//
+// Scenarios share nothing through the runner, so the merged totals do not
+// depend on the thread count or on which worker ran what; only latency
+// and wall times do. A scenario that throws stops the run: workers finish
+// what they are running and take nothing new, and run() rethrows the
+// first exception.
+class SimulationRunner {
+public:
+    explicit SimulationRunner(const SimulationConfig& config = SimulationConfig());
+    ~SimulationRunner();
+
+    SimulationRunner(const SimulationRunner&) = delete;
+    SimulationRunner& operator=(const SimulationRunner&) = delete;
+
+    // Run every scenario once and block until all are done. Returns each
+    // scenario's own figures, in input order, and folds them into stats().
+    // Books are created on their workers by the first run and kept (reset
+    // between scenarios) for later ones.
+    std::vector<ScenarioResult> run(const std::vector<Scenario>& scenarios);
+
+    // Merged over every run() so far
+    const SimulationStats& stats() const { return stats_; }
+    std::size_t threads() const { return workers_.size(); }
+
+private:
+    struct Worker;
+    struct Run;
+
+    void work(std::size_t w, Run& run);
+    // Next scenario for worker w, from its own share or stolen; false once
+    // every share is empty
+    bool take(std::size_t w, std::size_t& index, bool& stolen);
+
+    SimulationConfig config_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    SimulationStats stats_;
+};
+
+}  // namespace lob
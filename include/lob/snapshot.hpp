@@ -0,0 +1,90 @@
+#pragma once
+
+#include "types.hpp"
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace lob {
+
+// Flat binary image of a book: a header followed by every resting order,
+// bids then asks, each side best level first and each level in FIFO order.
+// The image has no pointers or handles, so it can be restored straight
+// from a read-only mapping of the file.
+struct SnapshotHeader {
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::uint32_t record_size;
+
+    // Book counters
+    OrderId next_id;
+    std::uint64_t timestamp_counter;
+    std::uint64_t trade_count;
+    std::uint64_t total_volume;
+
+    // Image contents
+    std::uint64_t bid_orders;
+    std::uint64_t ask_orders;
+    std::uint64_t pool_capacity;     // pool size when taken, including growth
+    std::uint64_t journal_position;  // journal records already reflected
+
+    // Level storage the orders were accepted under
+    Price ladder_min;
+    Price ladder_max;
+    Price ladder_tick;
+    LevelStorage level_storage;
+    TradingPhase phase;  // an auction image holds a crossed book
+};
+
+// One resting order
+struct SnapshotOrder {
+    OrderId id;
+    Price price;
+    Quantity quantity;   // original size
+    Quantity remaining;
+    std::uint64_t timestamp;
+    Side side;
+    OrderType type;
+    OrderStatus status;
+    std::uint8_t reserved[5];
+};
+
+static_assert(sizeof(SnapshotOrder) == 48, "SnapshotOrder must stay 48 bytes");
+
+constexpr std::uint64_t SNAPSHOT_MAGIC = 0x4c4f42534e415031ull;  // "LOBSNAP1"
+constexpr std::uint32_t SNAPSHOT_VERSION = 1;
+
+// Bytes of an image holding this many orders
+inline std::size_t snapshot_bytes(std::size_t orders) {
+    return sizeof(SnapshotHeader) + orders * sizeof(SnapshotOrder);
+}
+
+// Read-only mapping of a snapshot file. Throws std::system_error if the
+// file cannot be opened or mapped.
+class SnapshotFile {
+public:
+    explicit SnapshotFile(const std::string& path);
+    ~SnapshotFile();
+
+    SnapshotFile(const SnapshotFile&) = delete;
+    SnapshotFile& operator=(const SnapshotFile&) = delete;
+
+    const void* data() const { return map_; }
+    std::size_t size() const { return size_; }
+
+    // Header if the file is large enough to hold one, else nullptr
+    const SnapshotHeader* header() const {
+        return size_ >= sizeof(SnapshotHeader) ? static_cast<const SnapshotHeader*>(map_)
+                                               : nullptr;
+    }
+
+private:
+    void* map_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+// Write an image to path (replacing it) and fsync; false on any I/O error
+bool write_snapshot_file(const std::string& path, const void* image, std::size_t size);
+
+}  // namespace lob
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "memory.hpp"
+
+#include <atomic>
+#include <type_traits>
+#include <cstddef>
+
+namespace lob {
+
+constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+// Spin-wait hint for busy-poll loops
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+// Bounded lock-free single-producer / single-consumer queue of fixed-size
+// records. The producer and consumer indices sit on their own cache lines,
+// each next to a cached copy of the other side's index, so a push or pop
+// only touches the shared line when the cached view says full or empty.
+// Capacity is rounded up to a power of two; storage is mapped once.
+template <typename T>
+class SpscRing {
+    static_assert(std::is_trivially_copyable<T>::value, "ring records are copied as bytes");
+
+public:
+    explicit SpscRing(std::size_t capacity, const PageOptions& pages = PageOptions())
+        : capacity_(round_up_pow2(capacity)), mask_(capacity_ - 1), slots_(capacity_, pages) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer only — false if the ring is full
+    bool try_push(const T& item) {
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ == capacity_) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ == capacity_) return false;
+        }
+        slots_[tail & mask_] = item;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only — false if the ring is empty
+    bool try_pop(T& item) {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_) return false;
+        }
+        item = slots_[head & mask_];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Either side; exact only when the other side is idle
+    std::size_t size() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+    bool empty() const { return size() == 0; }
+    std::size_t capacity() const { return capacity_; }
+
+private:
+    static std::size_t round_up_pow2(std::size_t n) {
+        std::size_t p = 2;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    // Producer line
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> tail_{0};
+    std::size_t head_cache_ = 0;
+
+    // Consumer line
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> head_{0};
+    std::size_t tail_cache_ = 0;
+
+    // Read-only after construction
+    alignas(CACHE_LINE_SIZE) std::size_t capacity_;
+    std::size_t mask_;
+    PageArray<T> slots_;
+};
+
+}  // namespace lob
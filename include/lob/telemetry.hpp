@@ -0,0 +1,161 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+// Hot-path latency probes. Build with -DLOB_ENABLE_PROBES (CMake option
+// LOB_ENABLE_PROBES) to compile them in; otherwise LOB_PROBE expands to
+// nothing and costs nothing. Each probe reads the TSC on entry and exit and
+// records the difference into the calling thread's histogram for its
+// stage. Probes nest, so a stage's time includes the stages it calls.
+
+namespace lob {
+
+// Raw timestamp counter; ticks convert to ns with tsc_ns_per_tick()
+inline std::uint64_t read_tsc() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+// Nanoseconds per TSC tick, measured against steady_clock on first call
+double tsc_ns_per_tick();
+
+// Log-linear histogram in the style of HdrHistogram: values below 32 have
+// exact buckets, larger values keep 5 significant bits (about 3% error).
+// One thread records; any thread may read the counts concurrently.
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BITS = 5;
+    static constexpr std::size_t SUB_COUNT = std::size_t{1} << SUB_BITS;
+    static constexpr std::size_t BUCKETS = (64 - SUB_BITS + 1) * SUB_COUNT;
+
+    static std::size_t bucket_of(std::uint64_t value) {
+        if (value < SUB_COUNT) return static_cast<std::size_t>(value);
+        unsigned shift = 63u - static_cast<unsigned>(__builtin_clzll(value)) - SUB_BITS;
+        return (shift + 1) * SUB_COUNT + static_cast<std::size_t>((value >> shift) - SUB_COUNT);
+    }
+
+    // Smallest value that lands in bucket
+    static std::uint64_t bucket_floor(std::size_t bucket) {
+        if (bucket < SUB_COUNT) return bucket;
+        std::size_t shift = bucket / SUB_COUNT - 1;
+        return (SUB_COUNT + bucket % SUB_COUNT) << shift;
+    }
+
+    // Owner thread only. Plain load/store instead of fetch_add: there is
+    // one writer, so no locked instruction is needed.
+    void record(std::uint64_t value) {
+        bump(counts_[bucket_of(value)], 1);
+        bump(total_, 1);
+        if (value > max_.load(std::memory_order_relaxed)) {
+            max_.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    // Readers: counts may trail an in-flight record by one sample
+    std::uint64_t count() const { return total_.load(std::memory_order_relaxed); }
+    std::uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+    std::uint64_t count_at(std::size_t bucket) const {
+        return counts_[bucket].load(std::memory_order_relaxed);
+    }
+
+    // Bucket floor of the value at quantile q in [0, 1]; 0 if empty
+    std::uint64_t percentile(double q) const;
+
+    // Add this histogram's counts into total (total's owner only)
+    void add_to(LatencyHistogram& total) const;
+
+private:
+    static void bump(std::atomic<std::uint64_t>& cell, std::uint64_t n) {
+        cell.store(cell.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    std::atomic<std::uint64_t> counts_[BUCKETS] = {};
+    std::atomic<std::uint64_t> total_{0};
+    std::atomic<std::uint64_t> max_{0};
+};
+
+// Instrumented stages
+enum class ProbeStage : std::uint8_t {
+    AddOrder,     // submit_order: validation, matching, resting
+    Match,        // matching loop against the opposite side
+    CancelOrder,  // removing a resting order, by unlink or lazy-cancel tombstone:
+                  // cancels, and modifies / replaces that leave nothing to rest
+    Dispatch,     // listener callbacks (trade and level events)
+};
+
+constexpr std::size_t PROBE_STAGE_COUNT = 4;
+constexpr std::size_t MAX_PROBE_THREADS = 64;
+
+const char* probe_stage_name(ProbeStage stage);
+
+// One histogram per stage, owned by one recording thread. Values are TSC ticks.
+struct ProbeSet {
+    LatencyHistogram stages[PROBE_STAGE_COUNT];
+
+    LatencyHistogram& operator[](ProbeStage s) { return stages[static_cast<std::size_t>(s)]; }
+    const LatencyHistogram& operator[](ProbeStage s) const {
+        return stages[static_cast<std::size_t>(s)];
+    }
+};
+
+// Registry of per-thread probe sets. Sets live for the whole process so a
+// scraper can still read a thread's samples after it exits. Threads beyond
+// MAX_PROBE_THREADS are not recorded.
+ProbeSet* register_probe_thread();
+std::size_t probe_thread_count();
+const ProbeSet* probe_thread(std::size_t i);
+
+// Sum of every registered thread's histograms into total
+void collect_probes(ProbeSet& total);
+
+// Calling thread's probe set, registered on first use; nullptr if the registry is full
+inline ProbeSet* thread_probes() {
+    static thread_local ProbeSet* set = nullptr;
+    static thread_local bool registered = false;
+    if (__builtin_expect(!registered, 0)) {
+        set = register_probe_thread();
+        registered = true;
+    }
+    return set;
+}
+
+// Records the ticks between construction and destruction
+class ProbeTimer {
+public:
+    explicit ProbeTimer(ProbeStage stage) : stage_(stage), start_(read_tsc()) {}
+    ~ProbeTimer() {
+        std::uint64_t end = read_tsc();
+        if (ProbeSet* set = thread_probes()) (*set)[stage_].record(end - start_);
+    }
+
+    ProbeTimer(const ProbeTimer&) = delete;
+    ProbeTimer& operator=(const ProbeTimer&) = delete;
+
+private:
+    ProbeStage stage_;
+    std::uint64_t start_;
+};
+
+}  // namespace lob
+
+#define LOB_PROBE_CONCAT_(a, b) a##b
+#define LOB_PROBE_CONCAT(a, b) LOB_PROBE_CONCAT_(a, b)
+
+#ifdef LOB_ENABLE_PROBES
+// Time the rest of the enclosing scope as the given ProbeStage
+#define LOB_PROBE(stage) \
+    ::lob::ProbeTimer LOB_PROBE_CONCAT(lob_probe_, __LINE__)(::lob::ProbeStage::stage)
+#else
+#define LOB_PROBE(stage) static_cast<void>(0)
+#endif
@@ -5,14 +5,44 @@
 
 namespace lob {
 
-// Fixed-point price representation: 1 unit = 0.01 (1 cent)
-// Avoids floating-point arithmetic on the hot path
-using Price = std::uint64_t;
-using Quantity = std::uint64_t;
-using OrderId = std::uint64_t;
+// Field widths and compile-time constants of a book configuration.
+// BasicOrderBook and the structures it owns (order nodes, levels, pool,
+// index, trades and events) take a traits type; a traits type provides
+//   Price, Quantity, OrderId  unsigned integer types of the stored fields
+//   PRICE_MULTIPLIER          price units per currency unit
+//   TICK_SIZE                 price units per tick; limit prices must be
+//                             a multiple of it (a ladder band may be coarser)
+// Derive from one of the configurations below to change a single member.
+//
+// Fixed-point prices avoid floating-point arithmetic on the hot path;
+// the default configuration has 1 unit = 0.01 (1 cent).
+struct DefaultBookTraits {
+    using Price = std::uint64_t;
+    using Quantity = std::uint64_t;
+    using OrderId = std::uint64_t;
+    static constexpr Price PRICE_MULTIPLIER = 100;  // 2 decimal places
+    static constexpr Price TICK_SIZE = 1;           // any whole cent
+};
+
+// 32-bit fields: prices up to 42,949,672.95, 4.29 billion shares per order
+// and 4.29 billion order IDs per book. Order nodes, levels, trades and ID
+// index slots shrink by a quarter to a half (see order.hpp).
+struct CompactBookTraits {
+    using Price = std::uint32_t;
+    using Quantity = std::uint32_t;
+    using OrderId = std::uint32_t;
+    static constexpr Price PRICE_MULTIPLIER = 100;
+    static constexpr Price TICK_SIZE = 1;
+};
+
+// Field types of the default configuration, used by everything that is
+// not parameterised on traits (engine, journal, snapshot image, pipeline)
+using Price = DefaultBookTraits::Price;
+using Quantity = DefaultBookTraits::Quantity;
+using OrderId = DefaultBookTraits::OrderId;
 
 // Price constants
-constexpr Price PRICE_MULTIPLIER = 100;  // 2 decimal places
+constexpr Price PRICE_MULTIPLIER = DefaultBookTraits::PRICE_MULTIPLIER;
 constexpr Price INVALID_PRICE = 0;
 constexpr Price MAX_PRICE = std::numeric_limits<Price>::max();
 
@@ -21,9 +51,14 @@ enum class Side : std::uint8_t {
     Sell = 1
 };
 
+// Only Limit orders rest. Market, IOC and FOK orders match on arrival and
+// any remainder is cancelled; IOC and FOK match up to their limit price,
+// and FOK trades only if the whole quantity fills.
 enum class OrderType : std::uint8_t {
     Limit = 0,
-    Market = 1
+    Market = 1,
+    IOC = 2,  // immediate-or-cancel
+    FOK = 3   // fill-or-kill
 };
 
 enum class OrderStatus : std::uint8_t {
@@ -31,16 +66,51 @@ enum class OrderStatus : std::uint8_t {
     Active = 1,
     PartiallyFilled = 2,
     Filled = 3,
-    Cancelled = 4
+    Cancelled = 4,
+    Rejected = 5
+};
+
+// Why an order was rejected (OrderStatus::Rejected)
+enum class RejectReason : std::uint8_t {
+    None = 0,
+    PriceOutOfBand = 1,  // limit price outside the ladder band or off tick
+    PoolExhausted = 2,   // no free order slot and the pool cannot grow
+    UnknownSymbol = 3,   // MatchingEngine has no book for the symbol
+    UnknownOrder = 4,    // cancel / modify of an ID that is not resting
+    JournalFull = 5,     // journaled book could not record the input
+    DuplicateId = 6,     // external order ID is zero or already resting
+    AuctionPhase = 7,    // market, IOC or FOK order sent while the book is in an auction
+    InsufficientLiquidity = 8,  // FOK order the book cannot fill in full within its limit
+    IdsExhausted = 9            // the book has issued every ID up to BookConfig::id_limit
 };
 
-// Inline conversion helpers
-inline Price to_price(double p) {
-    return static_cast<Price>(p * PRICE_MULTIPLIER + 0.5);
+// Whether incoming orders match on arrival or accumulate for an uncross
+enum class TradingPhase : std::uint8_t {
+    Continuous = 0,
+    Auction = 1
+};
+
+// How price levels are stored on each side of the book
+enum class LevelStorage : std::uint8_t {
+    Map = 0,     // std::map — any price, O(log M) level access
+    Ladder = 1   // contiguous array over a fixed tick band, O(1) level access
+};
+
+// Inline conversion helpers, scaled by the configuration's PRICE_MULTIPLIER
+template <typename Traits = DefaultBookTraits>
+inline typename Traits::Price to_price(double p) {
+    return static_cast<typename Traits::Price>(p * Traits::PRICE_MULTIPLIER + 0.5);
+}
+
+template <typename Traits = DefaultBookTraits>
+inline double to_double(typename Traits::Price p) {
+    return static_cast<double>(p) / Traits::PRICE_MULTIPLIER;
 }
 
-inline double to_double(Price p) {
-    return static_cast<double>(p) / PRICE_MULTIPLIER;
+// True if value is representable in the narrower field type T
+template <typename T>
+constexpr bool fits_in(std::uint64_t value) {
+    return value <= std::numeric_limits<T>::max();
 }
 
 }  // namespace lob
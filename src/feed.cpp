@@ -0,0 +1,42 @@
+#include "lob/feed.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <system_error>
+
+namespace lob {
+
+FeedFile::FeedFile(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::system_error(errno, std::generic_category(), "feed open");
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        int err = errno;
+        ::close(fd);
+        throw std::system_error(err, std::generic_category(), "feed stat");
+    }
+    size_ = static_cast<std::size_t>(st.st_size);
+    if (size_ != 0) {
+        map_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map_ == MAP_FAILED) {
+            int err = errno;
+            map_ = nullptr;
+            ::close(fd);
+            throw std::system_error(err, std::generic_category(), "feed mmap");
+        }
+        // Decoded front to back, once
+        ::madvise(map_, size_, MADV_SEQUENTIAL);
+    }
+    ::close(fd);
+}
+
+FeedFile::~FeedFile() {
+    if (map_) ::munmap(map_, size_);
+}
+
+}  // namespace lob
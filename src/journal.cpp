@@ -0,0 +1,154 @@
+#include "lob/journal.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+namespace lob {
+
+static_assert(sizeof(JournalHeader) <= JOURNAL_HEADER_SIZE, "header must fit its page");
+static_assert(JOURNAL_HEADER_SIZE % sizeof(JournalRecord) == 0, "records must stay aligned");
+
+namespace {
+
+[[noreturn]] void throw_errno(const char* what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+std::size_t page_floor(std::size_t offset) {
+    return offset / SMALL_PAGE_SIZE * SMALL_PAGE_SIZE;
+}
+
+}  // namespace
+
+JournalHeader make_journal_header(const BookConfig& config) {
+    JournalHeader header{};
+    header.magic = JOURNAL_MAGIC;
+    header.version = JOURNAL_VERSION;
+    header.record_size = sizeof(JournalRecord);
+    header.pool_capacity = config.pool.capacity;
+    header.pool_max_capacity = config.pool.max_capacity;
+    header.pool_slab_size = config.pool.slab_size;
+    header.id_base = config.id_base;
+    header.id_limit = config.id_limit;
+    header.ladder_min = config.ladder.min_price;
+    header.ladder_max = config.ladder.max_price;
+    header.ladder_tick = config.ladder.tick_size;
+    header.level_storage = config.level_storage;
+    return header;
+}
+
+BookConfig book_config_from(const JournalHeader& header) {
+    BookConfig config;
+    config.pool.capacity = static_cast<std::size_t>(header.pool_capacity);
+    config.pool.max_capacity = static_cast<std::size_t>(header.pool_max_capacity);
+    config.pool.slab_size = static_cast<std::size_t>(header.pool_slab_size);
+    config.id_base = header.id_base;
+    config.id_limit = header.id_limit;
+    config.ladder = LadderRange{header.ladder_min, header.ladder_max, header.ladder_tick};
+    config.level_storage = header.level_storage;
+    return config;
+}
+
+// --- JournalWriter ---
+
+JournalWriter::JournalWriter(const std::string& path, const BookConfig& config,
+                             std::size_t max_records)
+    : capacity_(max_records) {
+    map_size_ = JOURNAL_HEADER_SIZE + max_records * sizeof(JournalRecord);
+
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) throw_errno("journal open");
+
+    // Reserve the blocks now so appends never hit ENOSPC through the mapping
+    int err = ::posix_fallocate(fd_, 0, static_cast<off_t>(map_size_));
+    if (err != 0) {
+        ::close(fd_);
+        errno = err;
+        throw_errno("journal fallocate");
+    }
+
+    map_ = ::mmap(nullptr, map_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (map_ == MAP_FAILED) {
+        map_ = nullptr;
+        ::close(fd_);
+        throw_errno("journal mmap");
+    }
+
+    JournalHeader header = make_journal_header(config);
+    std::memcpy(map_, &header, sizeof(header));
+    records_ = reinterpret_cast<JournalRecord*>(static_cast<char*>(map_) + JOURNAL_HEADER_SIZE);
+    ::msync(map_, JOURNAL_HEADER_SIZE, MS_ASYNC);
+}
+
+JournalWriter::~JournalWriter() {
+    if (map_) {
+        ::msync(map_, map_size_, MS_SYNC);
+        ::munmap(map_, map_size_);
+    }
+    if (fd_ >= 0) ::close(fd_);
+}
+
+void JournalWriter::commit() {
+    if (count_ == committed_) return;
+    std::size_t begin = page_floor(JOURNAL_HEADER_SIZE + committed_ * sizeof(JournalRecord));
+    std::size_t end = JOURNAL_HEADER_SIZE + count_ * sizeof(JournalRecord);
+    ::msync(static_cast<char*>(map_) + begin, end - begin, MS_ASYNC);
+    committed_ = count_;
+}
+
+void JournalWriter::sync() {
+    ::msync(map_, JOURNAL_HEADER_SIZE + count_ * sizeof(JournalRecord), MS_SYNC);
+    committed_ = count_;
+}
+
+// --- JournalReader ---
+
+JournalReader::JournalReader(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw_errno("journal open");
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw_errno("journal stat");
+    }
+    map_size_ = static_cast<std::size_t>(st.st_size);
+    if (map_size_ < JOURNAL_HEADER_SIZE) {
+        ::close(fd);
+        throw std::runtime_error("journal file too short");
+    }
+
+    map_ = ::mmap(nullptr, map_size_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map_ == MAP_FAILED) {
+        map_ = nullptr;
+        throw_errno("journal mmap");
+    }
+    ::madvise(map_, map_size_, MADV_SEQUENTIAL);
+
+    header_ = static_cast<const JournalHeader*>(map_);
+    if (header_->magic != JOURNAL_MAGIC || header_->version != JOURNAL_VERSION ||
+        header_->record_size != sizeof(JournalRecord)) {
+        ::munmap(map_, map_size_);
+        map_ = nullptr;
+        throw std::runtime_error("not a journal file");
+    }
+
+    records_ = reinterpret_cast<const JournalRecord*>(static_cast<const char*>(map_) +
+                                                      JOURNAL_HEADER_SIZE);
+    std::size_t slots = (map_size_ - JOURNAL_HEADER_SIZE) / sizeof(JournalRecord);
+    while (count_ < slots && records_[count_].op != JournalOp::End) ++count_;
+}
+
+JournalReader::~JournalReader() {
+    if (map_) ::munmap(map_, map_size_);
+}
+
+}  // namespace lob
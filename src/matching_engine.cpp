@@ -0,0 +1,18 @@
+#include "lob/matching_engine.hpp"
+
+#include <pthread.h>
+#include <sched.h>
+
+namespace lob {
+
+bool pin_current_thread(int core) {
+    if (core < 0 || core >= CPU_SETSIZE) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(static_cast<unsigned>(core), &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+template class BasicMatchingEngine<CallbackListener>;
+
+}  // namespace lob
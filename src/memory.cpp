@@ -0,0 +1,130 @@
+#include "lob/memory.hpp"
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <utility>
+
+namespace lob {
+
+namespace {
+
+std::size_t round_up(std::size_t bytes, std::size_t page) {
+    return (bytes + page - 1) / page * page;
+}
+
+// Prefer the given node for a range not yet faulted in. Uses the raw
+// syscall so the library does not depend on libnuma.
+bool bind_to_node(void* ptr, std::size_t size, int node) {
+#ifdef SYS_mbind
+    constexpr int MPOL_PREFERRED_MODE = 1;
+    constexpr std::size_t MASK_WORDS = 16;  // up to 1024 nodes
+    unsigned long mask[MASK_WORDS] = {};
+    auto bit = static_cast<std::size_t>(node);
+    if (bit >= MASK_WORDS * 64) return false;
+    mask[bit / 64] = 1ul << (bit % 64);
+    return syscall(SYS_mbind, ptr, size, MPOL_PREFERRED_MODE, mask, MASK_WORDS * 64 + 1, 0) == 0;
+#else
+    (void)ptr;
+    (void)size;
+    (void)node;
+    return false;
+#endif
+}
+
+}  // namespace
+
+void touch_pages(void* data, std::size_t bytes) noexcept {
+    auto* p = static_cast<volatile unsigned char*>(data);
+    for (std::size_t off = 0; off < bytes; off += SMALL_PAGE_SIZE) {
+        p[off] = p[off];
+    }
+}
+
+PageBuffer::~PageBuffer() { release(); }
+
+PageBuffer::PageBuffer(PageBuffer&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      huge_pages_(std::exchange(other.huge_pages_, false)),
+      numa_node_(std::exchange(other.numa_node_, -1)) {}
+
+PageBuffer& PageBuffer::operator=(PageBuffer&& other) noexcept {
+    if (this != &other) {
+        release();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        huge_pages_ = std::exchange(other.huge_pages_, false);
+        numa_node_ = std::exchange(other.numa_node_, -1);
+    }
+    return *this;
+}
+
+PageBuffer PageBuffer::allocate(std::size_t bytes, const PageOptions& options) noexcept {
+    PageBuffer buffer;
+    if (bytes == 0) {
+        return buffer;
+    }
+
+    // With a NUMA node the pages must be bound before they are faulted in,
+    // so prefaulting happens by hand after mbind rather than via MAP_POPULATE.
+    bool bind = options.numa_node >= 0;
+    bool touch = options.prefault && bind;
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    if (options.prefault && !bind) {
+        flags |= MAP_POPULATE;
+    }
+
+    void* ptr = MAP_FAILED;
+    std::size_t size = 0;
+
+    if (options.huge_pages) {
+        // Explicit huge pages need a reserved hugetlbfs pool; fall back to
+        // transparent huge pages when none are available.
+        size = round_up(bytes, HUGE_PAGE_SIZE);
+        ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB, -1, 0);
+        if (ptr != MAP_FAILED) {
+            buffer.huge_pages_ = true;
+        } else {
+            // MAP_POPULATE would fault the range in as small pages before
+            // the advice lands; map it empty and prefault by hand instead
+            ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags & ~MAP_POPULATE, -1, 0);
+#ifdef MADV_HUGEPAGE
+            if (ptr != MAP_FAILED) {
+                madvise(ptr, size, MADV_HUGEPAGE);
+            }
+#endif
+            touch = options.prefault;
+        }
+    } else {
+        size = round_up(bytes, SMALL_PAGE_SIZE);
+        ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+    }
+
+    if (ptr == MAP_FAILED) {
+        buffer.huge_pages_ = false;
+        return buffer;
+    }
+    buffer.data_ = ptr;
+    buffer.size_ = size;
+
+    if (bind && bind_to_node(ptr, size, options.numa_node)) {
+        buffer.numa_node_ = options.numa_node;
+    }
+    if (touch) {
+        buffer.warm_up();
+    }
+    return buffer;
+}
+
+void PageBuffer::release() noexcept {
+    if (data_) {
+        munmap(data_, size_);
+        data_ = nullptr;
+        size_ = 0;
+        huge_pages_ = false;
+        numa_node_ = -1;
+    }
+}
+
+}  // namespace lob
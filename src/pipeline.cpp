@@ -0,0 +1,7 @@
+#include "lob/pipeline.hpp"
+
+namespace lob {
+
+template class BasicBookPipeline<CallbackListener>;
+
+}  // namespace lob
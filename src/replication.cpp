@@ -0,0 +1,199 @@
+#include "lob/replication.hpp"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+
+namespace lob {
+
+namespace {
+
+[[noreturn]] void throw_errno(const char* what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+sockaddr_in to_sockaddr(const UdpEndpoint& endpoint) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(endpoint.address);
+    addr.sin_port = htons(endpoint.port);
+    return addr;
+}
+
+bool is_multicast(std::uint32_t address) { return (address >> 28) == 0xE; }
+
+// Records resent per NACK; the standby NACKs again as it catches up, so
+// a long gap is refilled in bursts its socket buffer can take
+constexpr std::uint64_t RESEND_LIMIT = 64 * REPLICATION_MAX_RECORDS;
+
+std::size_t ring_size(std::size_t capacity) {
+    std::size_t size = 64;  // a power of two above one full datagram
+    while (size < capacity) size *= 2;
+    return size;
+}
+
+}  // namespace
+
+UdpEndpoint udp_endpoint(const std::string& address, std::uint16_t port) {
+    in_addr parsed;
+    if (::inet_pton(AF_INET, address.c_str(), &parsed) != 1) {
+        throw std::invalid_argument("not an IPv4 address: " + address);
+    }
+    return UdpEndpoint{ntohl(parsed.s_addr), port};
+}
+
+// --- UdpSocket ---
+
+UdpSocket::UdpSocket(const std::string& address, std::uint16_t port) {
+    UdpEndpoint endpoint = udp_endpoint(address, port);
+    fd_ = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd_ < 0) throw_errno("replication socket");
+
+    bool group = is_multicast(endpoint.address);
+    if (group) {
+        // Every standby in the group binds the same port
+        int on = 1;
+        ::setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    }
+    sockaddr_in addr = to_sockaddr(group ? UdpEndpoint{INADDR_ANY, port} : endpoint);
+    if (::bind(fd_, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+        int err = errno;
+        ::close(fd_);
+        throw std::system_error(err, std::generic_category(), "replication bind");
+    }
+    if (group) {
+        ip_mreq membership{};
+        membership.imr_multiaddr.s_addr = htonl(endpoint.address);
+        membership.imr_interface.s_addr = htonl(INADDR_ANY);
+        if (::setsockopt(fd_, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) != 0) {
+            int err = errno;
+            ::close(fd_);
+            throw std::system_error(err, std::generic_category(), "replication join");
+        }
+    }
+}
+
+UdpSocket::~UdpSocket() {
+    if (fd_ >= 0) ::close(fd_);
+}
+
+bool UdpSocket::send(const void* data, std::size_t size, const UdpEndpoint& to) {
+    sockaddr_in addr = to_sockaddr(to);
+    return ::sendto(fd_, data, size, 0, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) ==
+           static_cast<ssize_t>(size);
+}
+
+long UdpSocket::receive(void* data, std::size_t size, UdpEndpoint& from) {
+    sockaddr_in addr{};
+    socklen_t len = sizeof(addr);
+    ssize_t n = ::recvfrom(fd_, data, size, 0, reinterpret_cast<sockaddr*>(&addr), &len);
+    if (n < 0) return -1;
+    from = UdpEndpoint{ntohl(addr.sin_addr.s_addr), ntohs(addr.sin_port)};
+    return static_cast<long>(n);
+}
+
+void UdpSocket::set_multicast(int ttl) {
+    unsigned char hops = static_cast<unsigned char>(std::clamp(ttl, 0, 255));
+    unsigned char loop = 1;
+    ::setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_TTL, &hops, sizeof(hops));
+    ::setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+}
+
+void UdpSocket::set_buffer_size(std::size_t bytes) {
+    int size = static_cast<int>(std::min<std::size_t>(bytes, 1u << 30));
+    ::setsockopt(fd_, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+    ::setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+}
+
+UdpEndpoint UdpSocket::local() const {
+    sockaddr_in addr{};
+    socklen_t len = sizeof(addr);
+    ::getsockname(fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+    return UdpEndpoint{ntohl(addr.sin_addr.s_addr), ntohs(addr.sin_port)};
+}
+
+// --- ReplicationSender ---
+
+ReplicationSender::ReplicationSender(const ReplicationConfig& config)
+    : socket_("0.0.0.0", 0), standby_(udp_endpoint(config.address, config.port)),
+      ring_(ring_size(config.retransmit_capacity)), mask_(ring_.size() - 1),
+      batch_(std::clamp<std::size_t>(config.records_per_packet, 1, REPLICATION_MAX_RECORDS)),
+      heartbeat_interval_(config.heartbeat_interval) {
+    socket_.set_buffer_size(config.socket_buffer);
+    if (is_multicast(standby_.address)) socket_.set_multicast(config.multicast_ttl);
+}
+
+void ReplicationSender::flush() {
+    if (sent_ == next_) return;
+    send_range(sent_, next_);
+    sent_ = next_;
+}
+
+void ReplicationSender::heartbeat() {
+    flush();
+    send_control(ReplicationPacketType::Heartbeat, next_, standby_);
+}
+
+std::size_t ReplicationSender::poll() {
+    std::size_t served = 0;
+    UdpEndpoint from;
+    ReplicationPacketHeader nack;
+    long size;
+    while ((size = socket_.receive(packet_, sizeof(packet_), from)) >= 0) {
+        if (static_cast<std::size_t>(size) < sizeof(nack)) continue;
+        std::memcpy(&nack, packet_, sizeof(nack));
+        if (nack.magic != REPLICATION_MAGIC || nack.type != ReplicationPacketType::Nack) continue;
+        ++stats_.nacks;
+        ++served;
+        // publish() writes the ring up to next_, sent or not, so that is
+        // where the window ends
+        std::uint64_t oldest = next_ > ring_.size() ? next_ - ring_.size() : 0;
+        if (nack.sequence < oldest) {
+            // Recovery needs a snapshot; the standby hears about it directly
+            ++stats_.unrecoverable;
+            send_control(ReplicationPacketType::Gone, oldest, from);
+            continue;
+        }
+        if (nack.sequence < sent_) {
+            std::uint64_t last = std::min(sent_, nack.sequence + RESEND_LIMIT);
+            stats_.retransmitted += last - nack.sequence;
+            send_range(nack.sequence, last);
+        }
+    }
+    return served;
+}
+
+void ReplicationSender::send_range(std::uint64_t first, std::uint64_t last) {
+    while (first < last) {
+        std::size_t count =
+            static_cast<std::size_t>(std::min<std::uint64_t>(last - first, REPLICATION_MAX_RECORDS));
+        ReplicationPacketHeader header{REPLICATION_MAGIC, ReplicationPacketType::Data, 0,
+                                       static_cast<std::uint16_t>(count), first};
+        std::memcpy(packet_, &header, sizeof(header));
+        char* out = packet_ + sizeof(header);
+        for (std::size_t i = 0; i < count; ++i) {
+            std::memcpy(out + i * sizeof(JournalRecord), &ring_[(first + i) & mask_],
+                        sizeof(JournalRecord));
+        }
+        ++stats_.packets;
+        if (!socket_.send(packet_, sizeof(header) + count * sizeof(JournalRecord), standby_)) {
+            ++stats_.send_failures;  // the standby NACKs the hole
+        }
+        first += count;
+    }
+}
+
+void ReplicationSender::send_control(ReplicationPacketType type, std::uint64_t sequence,
+                                     const UdpEndpoint& to) {
+    ReplicationPacketHeader header{REPLICATION_MAGIC, type, 0, 0, sequence};
+    if (!socket_.send(&header, sizeof(header), to)) ++stats_.send_failures;
+}
+
+}  // namespace lob
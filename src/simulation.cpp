@@ -0,0 +1,232 @@
+#include "lob/simulation.hpp"
+#include "lob/matching_engine.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace lob {
+
+// --- SimulationContext ---
+
+SimulationContext::SimulationContext(OrderBook& book, std::size_t worker, bool measure_latency,
+                                     std::size_t trade_capacity, LatencyHistogram& latency)
+    : book_(book), worker_(worker), measure_latency_(measure_latency),
+      ns_per_tick_(tsc_ns_per_tick()), latency_(latency), trade_storage_(trade_capacity),
+      trades_(trade_storage_.data(), trade_storage_.size()) {}
+
+template <typename Call>
+auto SimulationContext::timed(Call&& call) -> decltype(call()) {
+    ++inputs_;
+    if (!measure_latency_) return call();
+    std::uint64_t start = read_tsc();
+    auto result = call();
+    auto ticks = static_cast<double>(read_tsc() - start);
+    latency_.record(static_cast<std::uint64_t>(ticks * ns_per_tick_));
+    return result;
+}
+
+OrderAck SimulationContext::add_order(Side side, OrderType type, Price price,
+                                      Quantity quantity) {
+    trades_.clear();
+    return timed([&] { return book_.add_order(side, type, price, quantity, trades_); });
+}
+
+bool SimulationContext::cancel_order(OrderId order_id) {
+    return timed([&] { return book_.cancel_order(order_id); });
+}
+
+bool SimulationContext::modify_order(OrderId order_id, Quantity new_quantity) {
+    return timed([&] { return book_.modify_order(order_id, new_quantity); });
+}
+
+OrderAck SimulationContext::replace_order(OrderId order_id, Price new_price,
+                                          Quantity new_quantity) {
+    trades_.clear();
+    return timed([&] { return book_.replace_order(order_id, new_price, new_quantity, trades_); });
+}
+
+bool SimulationContext::apply(const JournalRecord& record) {
+    if (record.op == JournalOp::End) return false;
+    trades_.clear();
+    return timed([&] { return apply_journal_record(record, book_, trades_); });
+}
+
+Scenario journal_scenario(std::string path) {
+    return [path = std::move(path)](SimulationContext& context) {
+        JournalReader reader(path);
+        for (const JournalRecord& record : reader) {
+            if (!context.apply(record)) break;
+        }
+    };
+}
+
+// --- SimulationRunner ---
+
+struct SimulationRunner::Worker {
+    // This worker's share of the current run: scenarios [next, end)
+    std::mutex mutex;
+    std::size_t next = 0;
+    std::size_t end = 0;
+    bool stolen = false;  // the share was taken from another worker
+
+    std::unique_ptr<OrderBook> book;  // created on the worker by its first run
+};
+
+namespace {
+
+// Ready the book for the next scenario: nothing the last one attached may
+// outlive it
+void clear_book(OrderBook& book) {
+    book.set_trade_callback(nullptr);
+    book.set_level_deltas(nullptr);
+    book.set_level_executions(nullptr);
+    book.set_published_view(nullptr);
+    book.reset();
+}
+
+}  // namespace
+
+struct SimulationRunner::Run {
+    const std::vector<Scenario>& scenarios;
+    std::vector<ScenarioResult>& results;
+    std::vector<std::unique_ptr<SimulationStats>> stats;  // one per worker
+    std::atomic<bool> failed{false};
+    std::mutex error_mutex;
+    std::exception_ptr error;
+};
+
+SimulationRunner::SimulationRunner(const SimulationConfig& config) : config_(config) {
+    std::size_t threads = config_.threads;
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    workers_.reserve(threads);
+    for (std::size_t w = 0; w < threads; ++w) workers_.push_back(std::make_unique<Worker>());
+}
+
+SimulationRunner::~SimulationRunner() = default;
+
+std::vector<ScenarioResult> SimulationRunner::run(const std::vector<Scenario>& scenarios) {
+    std::vector<ScenarioResult> results(scenarios.size());
+    Run run{scenarios, results, {}, {}, {}, {}};
+
+    // Contiguous shares, the first scenarios.size() % threads one longer
+    std::size_t threads = workers_.size();
+    std::size_t begin = 0;
+    for (std::size_t w = 0; w < threads; ++w) {
+        std::size_t share = scenarios.size() / threads + (w < scenarios.size() % threads);
+        workers_[w]->next = begin;
+        workers_[w]->end = begin + share;
+        workers_[w]->stolen = false;
+        begin += share;
+        run.stats.push_back(std::make_unique<SimulationStats>());
+    }
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads);
+    for (std::size_t w = 0; w < threads; ++w) {
+        pool.emplace_back([this, w, &run] { work(w, run); });
+    }
+    for (std::thread& t : pool) t.join();
+
+    if (run.error) std::rethrow_exception(run.error);
+    for (const auto& worker_stats : run.stats) stats_.merge(*worker_stats);
+    return results;
+}
+
+void SimulationRunner::work(std::size_t w, Run& run) {
+    if (config_.first_core >= 0) pin_current_thread(config_.first_core + static_cast<int>(w));
+    Worker& worker = *workers_[w];
+    SimulationStats& stats = *run.stats[w];
+    try {
+        // First touch from this thread, so a NUMA-local policy lands here
+        if (!worker.book) worker.book = std::make_unique<OrderBook>(config_.book);
+        OrderBook& book = *worker.book;
+        SimulationContext context(book, w, config_.measure_latency, config_.trade_capacity,
+                                  stats.latency);
+
+        std::size_t index;
+        bool stolen;
+        while (!run.failed.load(std::memory_order_relaxed) && take(w, index, stolen)) {
+            auto start = std::chrono::steady_clock::now();
+            context.scenario_ = index;
+            context.inputs_ = 0;
+            run.scenarios[index](context);
+
+            ScenarioResult& result = run.results[index];
+            result.inputs = context.inputs_;
+            result.trades = book.total_trades();
+            result.volume = book.total_volume();
+            result.resting = book.total_orders();
+            result.wall_ns = static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start)
+                    .count());
+            result.worker = w;
+            result.stolen = stolen;
+            stats.add(result);
+            clear_book(book);
+        }
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(run.error_mutex);
+        if (!run.error) run.error = std::current_exception();
+        run.failed.store(true, std::memory_order_relaxed);
+        if (worker.book) clear_book(*worker.book);
+    }
+}
+
+bool SimulationRunner::take(std::size_t w, std::size_t& index, bool& stolen) {
+    Worker& own = *workers_[w];
+    {
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (own.next < own.end) {
+            index = own.next++;
+            stolen = own.stolen;
+            return true;
+        }
+    }
+
+    // Steal from the fullest share. Sizes are sampled one lock at a time
+    // and rechecked under the victim's lock. A stolen range is always run
+    // by its thief, so a scan that finds every share empty can stop: at
+    // worst a range in transit is not split again.
+    for (;;) {
+        std::size_t victim = w;
+        std::size_t most = 0;
+        for (std::size_t v = 0; v < workers_.size(); ++v) {
+            if (v == w) continue;
+            std::lock_guard<std::mutex> lock(workers_[v]->mutex);
+            std::size_t left = workers_[v]->end - workers_[v]->next;
+            if (left > most) {
+                most = left;
+                victim = v;
+            }
+        }
+        if (victim == w) return false;
+
+        Worker& other = *workers_[victim];
+        std::size_t first;
+        std::size_t last;
+        {
+            std::lock_guard<std::mutex> lock(other.mutex);
+            std::size_t left = other.end - other.next;
+            if (left == 0) continue;  // drained since the scan
+            std::size_t half = (left + 1) / 2;
+            last = other.end;
+            first = last - half;
+            other.end = first;
+        }
+        // Run the first stolen scenario now and keep the rest as our share
+        std::lock_guard<std::mutex> lock(own.mutex);
+        own.next = first + 1;
+        own.end = last;
+        own.stolen = true;
+        index = first;
+        stolen = true;
+        return true;
+    }
+}
+
+}  // namespace lob
@@ -0,0 +1,71 @@
+#include "lob/snapshot.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <system_error>
+
+namespace lob {
+
+SnapshotFile::SnapshotFile(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::system_error(errno, std::generic_category(), "snapshot open");
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        int err = errno;
+        ::close(fd);
+        throw std::system_error(err, std::generic_category(), "snapshot stat");
+    }
+    size_ = static_cast<std::size_t>(st.st_size);
+    if (size_ != 0) {
+        map_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map_ == MAP_FAILED) {
+            int err = errno;
+            map_ = nullptr;
+            ::close(fd);
+            throw std::system_error(err, std::generic_category(), "snapshot mmap");
+        }
+        ::madvise(map_, size_, MADV_SEQUENTIAL);
+    }
+    ::close(fd);
+}
+
+SnapshotFile::~SnapshotFile() {
+    if (map_) ::munmap(map_, size_);
+}
+
+bool write_snapshot_file(const std::string& path, const void* image, std::size_t size) {
+    // Write a temporary file and rename it over the target, so a crash
+    // mid-write never leaves a torn snapshot behind
+    std::string tmp = path + ".tmp";
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+
+    const char* p = static_cast<const char*>(image);
+    std::size_t left = size;
+    while (left > 0) {
+        ssize_t n = ::write(fd, p, left);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            ::close(fd);
+            ::unlink(tmp.c_str());
+            return false;
+        }
+        p += n;
+        left -= static_cast<std::size_t>(n);
+    }
+    bool ok = ::fsync(fd) == 0;
+    ok = ::close(fd) == 0 && ok;
+    if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+        ::unlink(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+}  // namespace lob
@@ -0,0 +1,96 @@
+#include "lob/telemetry.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <thread>
+
+namespace lob {
+
+namespace {
+
+double calibrate_tsc() {
+    using Clock = std::chrono::steady_clock;
+    auto t0 = Clock::now();
+    std::uint64_t c0 = read_tsc();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    auto t1 = Clock::now();
+    std::uint64_t c1 = read_tsc();
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+    if (c1 <= c0) return 1.0;
+    return static_cast<double>(ns) / static_cast<double>(c1 - c0);
+}
+
+std::mutex registry_mutex;
+std::atomic<ProbeSet*> registry[MAX_PROBE_THREADS];
+std::atomic<std::size_t> registry_size{0};
+
+}  // namespace
+
+double tsc_ns_per_tick() {
+    static const double ns_per_tick = calibrate_tsc();
+    return ns_per_tick;
+}
+
+std::uint64_t LatencyHistogram::percentile(double q) const {
+    std::uint64_t total = 0;
+    for (std::size_t b = 0; b < BUCKETS; ++b) total += count_at(b);
+    if (total == 0) return 0;
+
+    auto rank = static_cast<std::uint64_t>(std::ceil(q * static_cast<double>(total)));
+    if (rank == 0) rank = 1;
+    std::uint64_t seen = 0;
+    for (std::size_t b = 0; b < BUCKETS; ++b) {
+        seen += count_at(b);
+        if (seen >= rank) return bucket_floor(b);
+    }
+    return bucket_floor(BUCKETS - 1);
+}
+
+void LatencyHistogram::add_to(LatencyHistogram& total) const {
+    for (std::size_t b = 0; b < BUCKETS; ++b) {
+        if (std::uint64_t n = count_at(b)) bump(total.counts_[b], n);
+    }
+    bump(total.total_, count());
+    if (max() > total.max()) total.max_.store(max(), std::memory_order_relaxed);
+}
+
+const char* probe_stage_name(ProbeStage stage) {
+    switch (stage) {
+        case ProbeStage::AddOrder: return "add_order";
+        case ProbeStage::Match: return "match";
+        case ProbeStage::CancelOrder: return "cancel_order";
+        case ProbeStage::Dispatch: return "dispatch";
+    }
+    return "unknown";
+}
+
+ProbeSet* register_probe_thread() {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    std::size_t n = registry_size.load(std::memory_order_relaxed);
+    if (n == MAX_PROBE_THREADS) return nullptr;
+    ProbeSet* set = new ProbeSet();  // never freed: scrapers may outlive the thread
+    registry[n].store(set, std::memory_order_relaxed);
+    registry_size.store(n + 1, std::memory_order_release);
+    return set;
+}
+
+std::size_t probe_thread_count() {
+    return registry_size.load(std::memory_order_acquire);
+}
+
+const ProbeSet* probe_thread(std::size_t i) {
+    return i < probe_thread_count() ? registry[i].load(std::memory_order_relaxed) : nullptr;
+}
+
+void collect_probes(ProbeSet& total) {
+    std::size_t n = probe_thread_count();
+    for (std::size_t i = 0; i < n; ++i) {
+        const ProbeSet* set = probe_thread(i);
+        for (std::size_t s = 0; s < PROBE_STAGE_COUNT; ++s) {
+            set->stages[s].add_to(total.stages[s]);
+        }
+    }
+}
+
+}  // namespace lob
@@ -0,0 +1,238 @@
+#include <gtest/gtest.h>
+#include "lob/order_book.hpp"
+#include "test_config.hpp"
+
+#include <vector>
+
+using namespace lob;
+
+class AuctionTest : public ::testing::TestWithParam<LevelStorage> {
+protected:
+    AuctionTest() : book(test_book_config(GetParam())) {
+        book.set_trade_callback([this](const Trade& t) { seen.push_back(t); });
+        book.begin_auction();
+    }
+
+    OrderId bid(double price, Quantity qty) {
+        return book.add_order(Side::Buy, OrderType::Limit, to_price(price), qty).order_id;
+    }
+    OrderId ask(double price, Quantity qty) {
+        return book.add_order(Side::Sell, OrderType::Limit, to_price(price), qty).order_id;
+    }
+
+    OrderBook book;
+    std::vector<Trade> seen;
+};
+
+TEST_P(AuctionTest, OrdersAccumulateWithoutMatching) {
+    EXPECT_EQ(book.phase(), TradingPhase::Auction);
+    auto r = book.add_order(Side::Buy, OrderType::Limit, to_price(101.00), 100);
+    EXPECT_EQ(r.status, OrderStatus::Active);
+    r = book.add_order(Side::Sell, OrderType::Limit, to_price(99.00), 100);
+    EXPECT_EQ(r.status, OrderStatus::Active);
+    EXPECT_TRUE(r.trades.empty());
+    EXPECT_EQ(book.best_bid(), to_price(101.00));
+    EXPECT_EQ(book.best_ask(), to_price(99.00));
+    EXPECT_EQ(book.spread(), 0u);
+
+    // A replace that crosses further still only rests
+    auto amended = book.replace_order(r.order_id, to_price(98.00), 150);
+    EXPECT_TRUE(amended.trades.empty());
+    EXPECT_EQ(book.best_ask(), to_price(98.00));
+
+    auto market = book.add_order(Side::Buy, OrderType::Market, 0, 50);
+    EXPECT_EQ(market.status, OrderStatus::Rejected);
+    EXPECT_EQ(market.reject_reason, RejectReason::AuctionPhase);
+    for (OrderType type : {OrderType::IOC, OrderType::FOK}) {
+        auto immediate = book.add_order(Side::Buy, type, to_price(101.00), 50);
+        EXPECT_EQ(immediate.status, OrderStatus::Rejected);
+        EXPECT_EQ(immediate.reject_reason, RejectReason::AuctionPhase);
+    }
+    EXPECT_EQ(book.total_trades(), 0u);
+    EXPECT_EQ(book.total_orders(), 2u);
+}
+
+TEST_P(AuctionTest, UncrossMaximisesExecutedVolume) {
+    OrderId b1 = bid(101.00, 100);
+    OrderId b2 = bid(100.00, 200);
+    bid(99.00, 300);
+    OrderId a1 = ask(98.00, 150);
+    OrderId a2 = ask(100.00, 150);
+    ask(102.00, 100);
+
+    AuctionResult preview = book.indicative_uncross();
+    EXPECT_EQ(preview.price, to_price(100.00));
+    EXPECT_EQ(preview.volume, 300u);
+    EXPECT_EQ(book.total_orders(), 6u);
+
+    AuctionResult result = book.uncross();
+    EXPECT_EQ(result.price, to_price(100.00));
+    EXPECT_EQ(result.volume, 300u);
+    EXPECT_EQ(result.surplus, 0u);
+    EXPECT_EQ(result.trade_count, 3u);
+    EXPECT_EQ(book.phase(), TradingPhase::Continuous);
+
+    // Best levels first on both sides, every fill at the one price
+    ASSERT_EQ(seen.size(), 3u);
+    EXPECT_EQ(seen[0].buy_order_id, b1);
+    EXPECT_EQ(seen[0].sell_order_id, a1);
+    EXPECT_EQ(seen[0].quantity, 100u);
+    EXPECT_EQ(seen[1].buy_order_id, b2);
+    EXPECT_EQ(seen[1].sell_order_id, a1);
+    EXPECT_EQ(seen[2].buy_order_id, b2);
+    EXPECT_EQ(seen[2].sell_order_id, a2);
+    for (const Trade& t : seen) EXPECT_EQ(t.price, to_price(100.00));
+
+    EXPECT_EQ(book.best_bid(), to_price(99.00));
+    EXPECT_EQ(book.best_ask(), to_price(102.00));
+    EXPECT_EQ(book.total_orders(), 2u);
+    EXPECT_EQ(book.total_volume(), 300u);
+    ASSERT_EQ(book.bid_top().size(), 1u);
+    EXPECT_EQ(book.ask_top()[0].price, to_price(102.00));
+
+    // Back to continuous matching
+    auto r = book.add_order(Side::Buy, OrderType::Limit, to_price(102.00), 10);
+    EXPECT_EQ(r.status, OrderStatus::Filled);
+}
+
+TEST_P(AuctionTest, UncrossEmptiesSeveralLevelsInOnePass) {
+    for (double price : {102.00, 101.00, 100.00}) {
+        bid(price, 10);
+        bid(price, 5);
+    }
+    OrderId rest = bid(99.00, 50);
+    for (double price : {97.00, 98.00, 99.00}) ask(price, 15);
+
+    AuctionResult result = book.uncross();
+    EXPECT_EQ(result.volume, 45u);
+    EXPECT_EQ(book.total_volume(), 45u);
+
+    // Every crossed level on both sides went in the same uncross
+    EXPECT_EQ(book.best_bid(), to_price(99.00));
+    EXPECT_EQ(book.best_ask(), INVALID_PRICE);
+    EXPECT_EQ(book.total_orders(), 1u);
+    ASSERT_EQ(book.bid_top().size(), 1u);
+    EXPECT_EQ(book.bid_top()[0].quantity, 50u);
+    EXPECT_TRUE(book.ask_top().empty());
+    EXPECT_EQ(book.volume_at_price(Side::Buy, to_price(100.00)), 0u);
+    EXPECT_TRUE(book.cancel_order(rest));
+    EXPECT_TRUE(book.empty());
+}
+
+TEST_P(AuctionTest, SurplusSidePicksThePrice) {
+    bid(100.00, 500);
+    ask(99.00, 100);
+    ask(100.00, 100);
+    AuctionResult buy_heavy = book.indicative_uncross();
+    EXPECT_EQ(buy_heavy.price, to_price(100.00));
+    EXPECT_EQ(buy_heavy.volume, 200u);
+    EXPECT_EQ(buy_heavy.surplus, 300u);
+    EXPECT_EQ(buy_heavy.surplus_side, Side::Buy);
+
+    OrderBook other(test_book_config(GetParam()));
+    other.begin_auction();
+    other.add_order(Side::Buy, OrderType::Limit, to_price(101.00), 100);
+    other.add_order(Side::Sell, OrderType::Limit, to_price(99.00), 300);
+    AuctionResult sell_heavy = other.uncross();
+    EXPECT_EQ(sell_heavy.price, to_price(99.00));
+    EXPECT_EQ(sell_heavy.volume, 100u);
+    EXPECT_EQ(sell_heavy.surplus, 200u);
+    EXPECT_EQ(sell_heavy.surplus_side, Side::Sell);
+    EXPECT_EQ(other.volume_at_price(Side::Sell, to_price(99.00)), 200u);
+}
+
+TEST_P(AuctionTest, LeastImbalanceBeatsSurplusSide) {
+    // 104 through 107 all execute 17; only 107 leaves nothing over
+    bid(107.00, 17);
+    bid(106.00, 2);
+    bid(103.00, 16);
+    ask(104.00, 17);
+    AuctionResult result = book.indicative_uncross();
+    EXPECT_EQ(result.price, to_price(107.00));
+    EXPECT_EQ(result.volume, 17u);
+    EXPECT_EQ(result.surplus, 0u);
+
+    // 103 through 108 all execute 16; 106 and above leave 4 asks, the
+    // least, and a sell surplus takes the lowest of them
+    OrderBook other(test_book_config(GetParam()));
+    other.begin_auction();
+    other.add_order(Side::Buy, OrderType::Limit, to_price(108.00), 16);
+    other.add_order(Side::Buy, OrderType::Limit, to_price(105.00), 18);
+    other.add_order(Side::Buy, OrderType::Limit, to_price(104.00), 4);
+    other.add_order(Side::Sell, OrderType::Limit, to_price(102.00), 14);
+    other.add_order(Side::Sell, OrderType::Limit, to_price(103.00), 2);
+    other.add_order(Side::Sell, OrderType::Limit, to_price(106.00), 4);
+    AuctionResult sell_heavy = other.uncross();
+    EXPECT_EQ(sell_heavy.price, to_price(106.00));
+    EXPECT_EQ(sell_heavy.volume, 16u);
+    EXPECT_EQ(sell_heavy.surplus, 4u);
+    EXPECT_EQ(sell_heavy.surplus_side, Side::Sell);
+    EXPECT_EQ(other.best_bid(), to_price(105.00));
+    EXPECT_EQ(other.volume_at_price(Side::Sell, to_price(106.00)), 4u);
+}
+
+TEST_P(AuctionTest, SurplusEitherWayUsesTheMiddle) {
+    // 98 and 99 leave 3 bids over, 102 leaves 3 asks; between the limit
+    // prices, at the middle, the sides balance
+    bid(102.00, 10);
+    bid(99.00, 3);
+    ask(98.00, 10);
+    ask(102.00, 3);
+    AuctionResult result = book.indicative_uncross();
+    EXPECT_EQ(result.price, to_price(100.00));
+    EXPECT_EQ(result.volume, 10u);
+    EXPECT_EQ(result.surplus, 0u);
+}
+
+TEST_P(AuctionTest, BalancedRangeUsesItsMiddle) {
+    bid(102.00, 100);
+    ask(98.00, 100);
+    AuctionResult result = book.uncross();
+    EXPECT_EQ(result.price, to_price(100.00));
+    EXPECT_EQ(result.volume, 100u);
+    EXPECT_EQ(book.total_orders(), 0u);
+    EXPECT_EQ(book.best_bid(), INVALID_PRICE);
+}
+
+TEST_P(AuctionTest, TimePriorityWithinLevel) {
+    OrderId first = bid(100.00, 100);
+    OrderId second = bid(100.00, 100);
+    ask(100.00, 150);
+    book.uncross();
+    ASSERT_EQ(seen.size(), 2u);
+    EXPECT_EQ(seen[0].buy_order_id, first);
+    EXPECT_EQ(seen[0].quantity, 100u);
+    EXPECT_EQ(seen[1].buy_order_id, second);
+    EXPECT_EQ(seen[1].quantity, 50u);
+    EXPECT_EQ(book.volume_at_price(Side::Buy, to_price(100.00)), 50u);
+    EXPECT_EQ(book.order_count_at_price(Side::Buy, to_price(100.00)), 1u);
+}
+
+TEST_P(AuctionTest, NothingCrosses) {
+    bid(99.00, 100);
+    ask(101.00, 100);
+    AuctionResult result = book.uncross();
+    EXPECT_EQ(result.price, INVALID_PRICE);
+    EXPECT_EQ(result.volume, 0u);
+    EXPECT_EQ(result.trade_count, 0u);
+    EXPECT_EQ(book.phase(), TradingPhase::Continuous);
+    EXPECT_EQ(book.total_orders(), 2u);
+}
+
+TEST_P(AuctionTest, SnapshotKeepsThePhase) {
+    bid(101.00, 100);
+    ask(99.00, 60);
+    std::vector<char> image(book.snapshot_size());
+    ASSERT_EQ(book.snapshot(image.data(), image.size()), image.size());
+
+    OrderBook copy(test_book_config(GetParam()));
+    ASSERT_TRUE(copy.restore(image.data(), image.size()));
+    EXPECT_EQ(copy.phase(), TradingPhase::Auction);
+    AuctionResult result = copy.uncross();
+    EXPECT_EQ(result.volume, 60u);
+    EXPECT_EQ(result.price, to_price(101.00));
+}
+
+INSTANTIATE_TEST_SUITE_P(Storage, AuctionTest,
+                         ::testing::Values(LevelStorage::Map, LevelStorage::Ladder),
+                         level_storage_name);
@@ -0,0 +1,253 @@
+#include <gtest/gtest.h>
+#include "lob/order_book.hpp"
+
+#include <vector>
+
+using namespace lob;
+
+namespace {
+
+// Records every event the book emits
+struct RecordingListener : NullListener {
+    std::vector<Trade> trades;
+    std::vector<OrderEvent> added;
+    std::vector<OrderEvent> cancelled;
+    std::vector<OrderEvent> modified;
+    std::vector<LevelUpdate> levels;
+    std::vector<LevelExecution> executions;
+
+    void on_trade(const Trade& t) { trades.push_back(t); }
+    void on_order_added(const OrderEvent& e) { added.push_back(e); }
+    void on_order_cancelled(const OrderEvent& e) { cancelled.push_back(e); }
+    void on_order_modified(const OrderEvent& e) { modified.push_back(e); }
+    void on_level_update(const LevelUpdate& u) { levels.push_back(u); }
+    void on_level_execution(const LevelExecution& e) { executions.push_back(e); }
+};
+
+using RecordingBook = BasicOrderBook<RecordingListener>;
+
+BookConfig small_config() {
+    BookConfig config;
+    config.pool.capacity = 1000;
+    return config;
+}
+
+}  // namespace
+
+TEST(BookEventsTest, RestingOrderEmitsAddAndLevel) {
+    RecordingBook book(small_config());
+    auto r = book.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 50);
+
+    const auto& l = book.listener();
+    ASSERT_EQ(l.added.size(), 1u);
+    EXPECT_EQ(l.added[0].order_id, r.order_id);
+    EXPECT_EQ(l.added[0].remaining, 50u);
+    ASSERT_EQ(l.levels.size(), 1u);
+    EXPECT_EQ(l.levels[0].side, Side::Buy);
+    EXPECT_EQ(l.levels[0].price, to_price(100.00));
+    EXPECT_EQ(l.levels[0].total_quantity, 50u);
+    EXPECT_EQ(l.levels[0].order_count, 1u);
+}
+
+TEST(BookEventsTest, FillsEmitTradeAndLevelPerPassiveOrder) {
+    RecordingBook book(small_config());
+    book.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 30);
+    book.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 30);
+    book.listener() = RecordingListener{};
+
+    book.add_order(Side::Buy, OrderType::Market, 0, 40);
+
+    const auto& l = book.listener();
+    ASSERT_EQ(l.trades.size(), 2u);
+    ASSERT_EQ(l.levels.size(), 2u);
+    EXPECT_EQ(l.levels[0].total_quantity, 30u);
+    EXPECT_EQ(l.levels[0].order_count, 1u);
+    EXPECT_EQ(l.levels[1].total_quantity, 20u);
+    EXPECT_EQ(l.levels[1].order_count, 1u);
+    EXPECT_TRUE(l.added.empty());  // market order never rests
+}
+
+TEST(BookEventsTest, CancelEmitsRemovalOfEmptyLevel) {
+    RecordingBook book(small_config());
+    auto r = book.add_order(Side::Sell, OrderType::Limit, to_price(101.00), 25);
+    book.listener() = RecordingListener{};
+
+    ASSERT_TRUE(book.cancel_order(r.order_id));
+
+    const auto& l = book.listener();
+    ASSERT_EQ(l.cancelled.size(), 1u);
+    EXPECT_EQ(l.cancelled[0].order_id, r.order_id);
+    EXPECT_EQ(l.cancelled[0].remaining, 25u);
+    ASSERT_EQ(l.levels.size(), 1u);
+    EXPECT_EQ(l.levels[0].order_count, 0u);
+    EXPECT_EQ(l.levels[0].total_quantity, 0u);
+}
+
+TEST(BookEventsTest, ReduceEmitsModify) {
+    RecordingBook book(small_config());
+    auto r = book.add_order(Side::Buy, OrderType::Limit, to_price(99.00), 100);
+    book.listener() = RecordingListener{};
+
+    ASSERT_TRUE(book.modify_order(r.order_id, 60));
+
+    const auto& l = book.listener();
+    ASSERT_EQ(l.modified.size(), 1u);
+    EXPECT_EQ(l.modified[0].remaining, 60u);
+    ASSERT_EQ(l.levels.size(), 1u);
+    EXPECT_EQ(l.levels[0].total_quantity, 60u);
+}
+
+TEST(BookEventsTest, NullListenerBookMatches) {
+    BasicOrderBook<NullListener> book(small_config());
+    book.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 10);
+    auto r = book.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 10);
+    EXPECT_EQ(r.status, OrderStatus::Filled);
+    EXPECT_EQ(book.total_trades(), 1u);
+}
+
+TEST(BookEventsTest, LevelDeltasCoalescePerMessage) {
+    RecordingBook book(small_config());
+    std::vector<LevelUpdate> storage(8);
+    LevelDeltaBuffer deltas(storage.data(), storage.size());
+    book.set_level_deltas(&deltas);
+
+    for (int i = 0; i < 3; ++i) {
+        book.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 10);
+    }
+    book.add_order(Side::Sell, OrderType::Limit, to_price(101.00), 10);
+    ASSERT_EQ(deltas.size, 1u);  // only the last add's level
+    EXPECT_EQ(deltas.data[0].price, to_price(101.00));
+
+    // One sweep: three fills at 100 and one at 101, two deltas
+    book.listener() = RecordingListener{};
+    book.add_order(Side::Buy, OrderType::Limit, to_price(101.00), 35);
+    EXPECT_EQ(book.listener().levels.size(), 4u);  // listener sees every change
+    ASSERT_EQ(deltas.size, 2u);
+    EXPECT_EQ(deltas.data[0].side, Side::Sell);
+    EXPECT_EQ(deltas.data[0].price, to_price(100.00));
+    EXPECT_EQ(deltas.data[0].order_count, 0u);  // level removed
+    EXPECT_EQ(deltas.data[1].price, to_price(101.00));
+    EXPECT_EQ(deltas.data[1].total_quantity, 5u);
+    EXPECT_EQ(deltas.dropped, 0u);
+}
+
+TEST(BookEventsTest, LevelDeltasCoverCancelAndModify) {
+    RecordingBook book(small_config());
+    std::vector<LevelUpdate> storage(1);
+    LevelDeltaBuffer deltas(storage.data(), storage.size());
+    book.set_level_deltas(&deltas);
+
+    auto a = book.add_order(Side::Buy, OrderType::Limit, to_price(99.00), 10);
+    auto b = book.add_order(Side::Buy, OrderType::Limit, to_price(99.00), 20);
+
+    // Increase = cancel + re-add at the same level: one delta
+    ASSERT_TRUE(book.modify_order(a.order_id, 50));
+    ASSERT_EQ(deltas.size, 1u);
+    EXPECT_EQ(deltas.data[0].total_quantity, 70u);
+    EXPECT_EQ(deltas.data[0].order_count, 2u);
+
+    ASSERT_TRUE(book.cancel_order(b.order_id));
+    ASSERT_EQ(deltas.size, 1u);
+    EXPECT_EQ(deltas.data[0].total_quantity, 50u);
+
+    // A batch is one message; distinct levels beyond capacity are dropped
+    OrderRequest requests[2] = {{Side::Buy, OrderType::Limit, to_price(98.00), 5},
+                                {Side::Buy, OrderType::Limit, to_price(97.00), 5}};
+    OrderAck acks[2];
+    TradeBuffer trades;
+    book.add_orders(requests, 2, acks, trades);
+    EXPECT_EQ(deltas.size, 1u);
+    EXPECT_EQ(deltas.dropped, 1u);
+
+    book.set_level_deltas(nullptr);
+    book.cancel_order(acks[0].order_id);
+    EXPECT_EQ(deltas.dropped, 1u);  // detached buffer is left alone
+}
+
+TEST(BookEventsTest, LevelExecutionsConflateEachSweptLevel) {
+    RecordingBook book(small_config());
+    std::vector<LevelExecution> storage(8);
+    std::vector<PassiveFill> fill_storage(8);
+    ExecutionBuffer executions(storage.data(), storage.size(), fill_storage.data(),
+                               fill_storage.size());
+    book.set_level_executions(&executions);
+
+    OrderId passive[3];
+    for (OrderId& id : passive) {
+        id = book.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 10).order_id;
+    }
+    OrderId last = book.add_order(Side::Sell, OrderType::Limit, to_price(101.00), 10).order_id;
+    EXPECT_EQ(executions.size, 0u);
+
+    // Four fills over two levels: two executions, every trade still reported
+    auto r = book.add_order(Side::Buy, OrderType::Limit, to_price(101.00), 35);
+    EXPECT_EQ(r.trades.size(), 4u);
+    EXPECT_EQ(book.listener().trades.size(), 4u);
+    ASSERT_EQ(executions.size, 2u);
+    const LevelExecution& first = executions.data[0];
+    EXPECT_EQ(first.aggressor_id, r.order_id);
+    EXPECT_EQ(first.aggressor_side, Side::Buy);
+    EXPECT_EQ(first.price, to_price(100.00));
+    EXPECT_EQ(first.quantity, 30u);
+    EXPECT_EQ(first.order_count, 3u);
+    ASSERT_EQ(first.fill_count, 3u);
+    for (std::size_t i = 0; i < 3; ++i) {
+        EXPECT_EQ(first.fills[i].order_id, passive[i]);
+        EXPECT_EQ(first.fills[i].quantity, 10u);
+    }
+    const LevelExecution& second = executions.data[1];
+    EXPECT_EQ(second.price, to_price(101.00));
+    EXPECT_EQ(second.quantity, 5u);
+    ASSERT_EQ(second.fill_count, 1u);
+    EXPECT_EQ(second.fills[0].order_id, last);
+    EXPECT_EQ(executions.fill_size, 4u);
+
+    ASSERT_EQ(book.listener().executions.size(), 2u);
+    EXPECT_EQ(book.listener().executions[1].quantity, 5u);
+
+    // The next message starts a fresh list
+    book.add_order(Side::Buy, OrderType::Limit, to_price(99.00), 10);
+    EXPECT_EQ(executions.size, 0u);
+    EXPECT_EQ(executions.fill_size, 0u);
+}
+
+TEST(BookEventsTest, LevelExecutionsKeepTotalsBeyondCapacity) {
+    RecordingBook book(small_config());
+    std::vector<LevelExecution> storage(1);
+    std::vector<PassiveFill> fill_storage(2);
+    ExecutionBuffer executions(storage.data(), storage.size(), fill_storage.data(),
+                               fill_storage.size());
+    book.set_level_executions(&executions);
+    for (int i = 0; i < 3; ++i) {
+        book.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 10);
+    }
+    book.add_order(Side::Buy, OrderType::Limit, to_price(99.00), 10);
+
+    // A batch is one message: each aggressor gets its own executions
+    OrderRequest requests[2] = {{Side::Sell, OrderType::Limit, to_price(100.00), 25},
+                                {Side::Sell, OrderType::Market, 0, 15}};
+    OrderAck acks[2];
+    TradeBuffer trades;
+    book.add_orders(requests, 2, acks, trades);
+
+    ASSERT_EQ(executions.size, 1u);
+    EXPECT_EQ(executions.dropped, 2u);
+    EXPECT_EQ(executions.data[0].quantity, 25u);
+    EXPECT_EQ(executions.data[0].order_count, 3u);
+    EXPECT_EQ(executions.data[0].fill_count, 2u);
+    EXPECT_EQ(executions.fills_dropped, 3u);
+
+    // The listener sees every execution, stored or not
+    const auto& seen = book.listener().executions;
+    ASSERT_EQ(seen.size(), 3u);
+    EXPECT_EQ(seen[1].aggressor_id, acks[1].order_id);
+    EXPECT_EQ(seen[1].price, to_price(100.00));
+    EXPECT_EQ(seen[1].quantity, 5u);
+    EXPECT_EQ(seen[2].price, to_price(99.00));
+    EXPECT_EQ(seen[2].quantity, 10u);
+    EXPECT_EQ(seen[2].fill_count, 0u);
+
+    book.set_level_executions(nullptr);
+    book.add_order(Side::Sell, OrderType::Market, 0, 1);
+    EXPECT_EQ(seen.size(), 3u);
+}
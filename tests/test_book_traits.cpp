@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include "lob/order_book.hpp"
+#include "test_config.hpp"
+
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+using namespace lob;
+
+namespace {
+
+using CompactBook = BasicOrderBook<BasicCallbackListener<CompactBookTraits>, CompactBookTraits>;
+
+// Four decimal places on 32-bit fields
+struct BasisPointTraits : CompactBookTraits {
+    static constexpr Price PRICE_MULTIPLIER = 10000;
+};
+
+// Five-cent ticks on the default fields
+struct NickelTraits : DefaultBookTraits {
+    static constexpr Price TICK_SIZE = 5;
+};
+
+using NickelBook = BasicOrderBook<BasicCallbackListener<NickelTraits>, NickelTraits>;
+
+}  // namespace
+
+TEST(BookTraitsTest, CompactLayoutIsSmaller) {
+    static_assert(std::is_same<CompactBook::Price, std::uint32_t>::value, "32-bit prices");
+    static_assert(std::is_same<OrderBook::Price, Price>::value, "OrderBook keeps 64-bit fields");
+    EXPECT_EQ(sizeof(BasicOrder<CompactBookTraits>), 24u);
+    EXPECT_EQ(sizeof(BasicOrderInfo<CompactBookTraits>), 24u);
+    EXPECT_EQ(sizeof(BasicPriceLevel<CompactBookTraits>), 24u);
+    EXPECT_EQ(sizeof(BasicTrade<CompactBookTraits>), 24u);
+    EXPECT_LT(sizeof(BasicTrade<CompactBookTraits>), sizeof(Trade));
+}
+
+TEST(BookTraitsTest, PriceMultiplierComesFromTraits) {
+    EXPECT_EQ(to_price(101.25), 10125u);
+    EXPECT_EQ(to_price<CompactBookTraits>(101.25), 10125u);
+    EXPECT_EQ(to_price<BasisPointTraits>(101.2525), 1012525u);
+    EXPECT_DOUBLE_EQ(to_double<BasisPointTraits>(1012525u), 101.2525);
+}
+
+class CompactBookTest : public ::testing::TestWithParam<LevelStorage> {};
+
+TEST_P(CompactBookTest, CompactBookMatches) {
+    CompactBook book(test_book_config(GetParam()));
+    std::vector<CompactBook::Trade> seen;
+    book.set_trade_callback([&](const CompactBook::Trade& t) { seen.push_back(t); });
+
+    auto s1 = book.add_order(Side::Sell, OrderType::Limit, to_price<CompactBookTraits>(100.00), 40);
+    auto s2 = book.add_order(Side::Sell, OrderType::Limit, to_price<CompactBookTraits>(100.50), 40);
+    book.add_order(Side::Buy, OrderType::Limit, to_price<CompactBookTraits>(99.00), 10);
+    EXPECT_EQ(book.spread(), 100u);
+
+    auto r = book.add_order(Side::Buy, OrderType::Limit, to_price<CompactBookTraits>(100.50), 60);
+    EXPECT_EQ(r.status, OrderStatus::Filled);
+    ASSERT_EQ(r.trades.size(), 2u);
+    EXPECT_EQ(r.trades[0].sell_order_id, s1.order_id);
+    EXPECT_EQ(r.trades[1].sell_order_id, s2.order_id);
+    EXPECT_EQ(r.trades[1].quantity, 20u);
+    EXPECT_EQ(seen.size(), 2u);
+
+    ASSERT_EQ(book.bid_top().size(), 1u);
+    EXPECT_EQ(book.ask_top()[0].quantity, 20u);
+    EXPECT_EQ(book.volume_at_price(Side::Sell, to_price<CompactBookTraits>(100.50)), 20u);
+
+    auto ack = book.replace_order(s2.order_id, to_price<CompactBookTraits>(101.00), 50);
+    EXPECT_EQ(ack.status, OrderStatus::PartiallyFilled);
+    EXPECT_EQ(book.best_ask(), to_price<CompactBookTraits>(101.00));
+    EXPECT_TRUE(book.cancel_order(s2.order_id));
+    EXPECT_EQ(book.total_orders(), 1u);
+}
+
+TEST_P(CompactBookTest, CompactSnapshotRoundTrip) {
+    CompactBook book(test_book_config(GetParam()));
+    for (int i = 0; i < 5; ++i) {
+        book.add_order(Side::Buy, OrderType::Limit, to_price<CompactBookTraits>(99.00 - i), 10);
+        book.add_order(Side::Sell, OrderType::Limit, to_price<CompactBookTraits>(101.00 + i), 10);
+    }
+    std::vector<char> image(book.snapshot_size());
+    ASSERT_EQ(book.snapshot(image.data(), image.size()), image.size());
+
+    CompactBook copy(test_book_config(GetParam()));
+    ASSERT_TRUE(copy.restore(image.data(), image.size()));
+    EXPECT_EQ(copy.bid_depth(5), book.bid_depth(5));
+    EXPECT_EQ(copy.ask_depth(5), book.ask_depth(5));
+
+    // A full-width image with a price past 32 bits is refused, not truncated
+    OrderBook wide(test_book_config(LevelStorage::Map));
+    wide.add_order(Side::Buy, OrderType::Limit, Price{1} << 33, 10);
+    std::vector<char> wide_image(wide.snapshot_size());
+    wide.snapshot(wide_image.data(), wide_image.size());
+    CompactBook narrow(test_book_config(LevelStorage::Map));
+    EXPECT_FALSE(narrow.restore(wide_image.data(), wide_image.size()));
+}
+
+INSTANTIATE_TEST_SUITE_P(Storage, CompactBookTest,
+                         ::testing::Values(LevelStorage::Map, LevelStorage::Ladder),
+                         level_storage_name);
+
+TEST(BookTraitsTest, CompactConfigMustFit) {
+    BookConfig config = test_book_config(LevelStorage::Ladder);
+    config.ladder.max_price = Price{1} << 32;
+    EXPECT_THROW(CompactBook book(config), std::invalid_argument);
+
+    config = test_book_config(LevelStorage::Map);
+    config.id_base = OrderId{1} << 40;
+    EXPECT_THROW(CompactBook book(config), std::invalid_argument);
+    EXPECT_NO_THROW(OrderBook book(config));
+}
+
+TEST(BookTraitsTest, TickSizeComesFromTraits) {
+    NickelBook book;
+    auto off = book.add_order(Side::Sell, OrderType::Limit, to_price(100.03), 10);
+    EXPECT_EQ(off.status, OrderStatus::Rejected);
+    EXPECT_EQ(off.reject_reason, RejectReason::PriceOutOfBand);
+    auto on = book.add_order(Side::Sell, OrderType::Limit, to_price(100.05), 10);
+    EXPECT_EQ(on.status, OrderStatus::Active);
+
+    // IOC and FOK limits too; market orders carry no price
+    auto ioc = book.add_order(Side::Buy, OrderType::IOC, to_price(100.07), 5);
+    EXPECT_EQ(ioc.reject_reason, RejectReason::PriceOutOfBand);
+    EXPECT_TRUE(ioc.trades.empty());
+    auto fok = book.add_order(Side::Buy, OrderType::FOK, to_price(100.08), 5);
+    EXPECT_EQ(fok.reject_reason, RejectReason::PriceOutOfBand);
+    auto market = book.add_order(Side::Buy, OrderType::Market, 0, 5);
+    EXPECT_EQ(market.filled_quantity, 5u);
+
+    auto amend = book.replace_order(on.order_id, to_price(100.12), 10);
+    EXPECT_EQ(amend.reject_reason, RejectReason::PriceOutOfBand);
+    EXPECT_EQ(book.volume_at_price(Side::Sell, to_price(100.05)), 5u);
+    EXPECT_EQ(book.insert_order(99, Side::Buy, to_price(99.99), 10).reject_reason,
+              RejectReason::PriceOutOfBand);
+
+    // A ladder band must sit on the traits' tick
+    BookConfig config = test_book_config(LevelStorage::Ladder);
+    config.ladder.tick_size = 2;
+    EXPECT_THROW(NickelBook ladder(config), std::invalid_argument);
+    config.ladder.tick_size = 5;
+    EXPECT_NO_THROW(NickelBook ladder(config));
+}
@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+#include "lob/order_book.hpp"
+#include "test_config.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace lob;
+
+namespace {
+
+// Every field carries the same value, so a torn copy is detectable
+struct Stamp {
+    std::uint64_t words[9];
+    std::uint32_t tail;
+};
+
+}  // namespace
+
+TEST(SeqLockTest, ReadersNeverSeeTornValues) {
+    SeqLock<Stamp> lock(Stamp{});
+    std::atomic<bool> done{false};
+    std::atomic<std::uint64_t> reads{0};
+
+    std::thread reader([&] {
+        std::uint64_t last = 0;
+        while (!done.load(std::memory_order_acquire)) {
+            Stamp s;
+            if (!lock.try_load(s)) continue;
+            for (std::uint64_t w : s.words) ASSERT_EQ(w, s.words[0]);
+            ASSERT_EQ(s.tail, static_cast<std::uint32_t>(s.words[0]));
+            ASSERT_GE(s.words[0], last);  // never goes backwards
+            last = s.words[0];
+            reads.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    for (std::uint64_t i = 1; i <= 200000; ++i) {
+        Stamp s;
+        for (std::uint64_t& w : s.words) w = i;
+        s.tail = static_cast<std::uint32_t>(i);
+        lock.store(s);
+        if (i % 1024 == 0) std::this_thread::yield();  // let the reader run on one core
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+
+    EXPECT_EQ(lock.version(), 200001u);
+    EXPECT_EQ(lock.load().words[8], 200000u);
+    EXPECT_GT(reads.load(), 0u);
+}
+
+class BookViewTest : public ::testing::TestWithParam<LevelStorage> {};
+
+TEST_P(BookViewTest, PublishesAfterEveryMessage) {
+    OrderBook book(test_book_config(GetParam()));
+    PublishedBookView<DEFAULT_DEPTH_LEVELS> view;
+    book.add_order(Side::Buy, OrderType::Limit, to_price(99.00), 10);  // before publishing
+    book.set_published_view(&view);
+
+    BookView<DEFAULT_DEPTH_LEVELS> v = view.load();
+    EXPECT_EQ(v.messages, 1u);
+    EXPECT_EQ(v.best_bid, to_price(99.00));
+    EXPECT_EQ(v.best_ask, INVALID_PRICE);
+
+    book.add_order(Side::Sell, OrderType::Limit, to_price(101.00), 20);
+    book.add_order(Side::Sell, OrderType::Limit, to_price(102.00), 30);
+    auto taker = book.add_order(Side::Buy, OrderType::Limit, to_price(101.00), 25);
+    v = view.load();
+    EXPECT_EQ(v.messages, 4u);
+    EXPECT_EQ(v.best_bid, to_price(101.00));  // taker remainder rests
+    EXPECT_EQ(v.best_ask, to_price(102.00));
+    EXPECT_EQ(v.spread(), to_price(1.00));
+    EXPECT_EQ(v.total_trades, 1u);
+    EXPECT_EQ(v.total_volume, 20u);
+    ASSERT_EQ(v.bid_count, 2u);
+    EXPECT_EQ(v.bids[0].quantity, 5u);
+    EXPECT_EQ(v.bids[1].price, to_price(99.00));
+    ASSERT_EQ(v.ask_count, 1u);
+    EXPECT_EQ(v.asks[0].order_count, 1u);
+
+    book.cancel_order(taker.order_id);
+    EXPECT_EQ(view.load().best_bid, to_price(99.00));
+    EXPECT_EQ(view.version(), 5u);
+
+    // Detached: further messages are not published
+    book.set_published_view(nullptr);
+    book.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 1);
+    EXPECT_EQ(view.version(), 5u);
+}
+
+TEST_P(BookViewTest, CrossedAuctionBookHasZeroSpread) {
+    OrderBook book(test_book_config(GetParam()));
+    PublishedBookView<DEFAULT_DEPTH_LEVELS> view;
+    book.set_published_view(&view);
+    book.begin_auction();
+    book.add_order(Side::Buy, OrderType::Limit, to_price(101.00), 10);
+    book.add_order(Side::Sell, OrderType::Limit, to_price(99.00), 10);
+
+    BookView<DEFAULT_DEPTH_LEVELS> v = view.load();
+    EXPECT_EQ(v.best_bid, to_price(101.00));
+    EXPECT_EQ(v.best_ask, to_price(99.00));
+    EXPECT_EQ(v.spread(), 0);
+    EXPECT_EQ(v.spread(), book.spread());
+}
+
+TEST_P(BookViewTest, ConcurrentReaderSeesConsistentBooks) {
+    using SmallBook = BasicOrderBook<CallbackListener, DefaultBookTraits, 4>;
+    SmallBook book(test_book_config(GetParam()));
+    PublishedBookView<4> view;
+    book.set_published_view(&view);
+
+    std::atomic<bool> done{false};
+    std::thread reader([&] {
+        std::uint64_t last = 0;
+        while (!done.load(std::memory_order_acquire)) {
+            BookView<4> v = view.load();
+            ASSERT_GE(v.messages, last);
+            last = v.messages;
+            // Published books are never crossed and depth agrees with the BBO
+            if (v.best_bid != INVALID_PRICE && v.best_ask != INVALID_PRICE) {
+                ASSERT_LT(v.best_bid, v.best_ask);
+            }
+            ASSERT_EQ(v.bid_count == 0, v.best_bid == INVALID_PRICE);
+            if (v.bid_count) {
+                ASSERT_EQ(v.bids[0].price, v.best_bid);
+            }
+            for (std::uint32_t i = 1; i < v.ask_count; ++i) {
+                ASSERT_GT(v.asks[i].price, v.asks[i - 1].price);
+            }
+        }
+    });
+
+    std::vector<OrderId> ids;
+    for (std::uint64_t i = 0; i < 20000; ++i) {
+        Side side = i % 2 ? Side::Buy : Side::Sell;
+        Price price = to_price(100.00) + (i * 7919 % 41) - 20;
+        if (i % 3 == 2 && !ids.empty()) {
+            book.cancel_order(ids[i % ids.size()]);
+        } else {
+            ids.push_back(book.add_order(side, OrderType::Limit, price, 1 + i % 17).order_id);
+        }
+        if (i % 512 == 0) std::this_thread::yield();
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+    EXPECT_EQ(view.load().total_trades, book.total_trades());
+}
+
+INSTANTIATE_TEST_SUITE_P(LevelStorage, BookViewTest,
+                         ::testing::Values(LevelStorage::Map, LevelStorage::Ladder),
+                         level_storage_name);
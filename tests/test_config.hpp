@@ -0,0 +1,22 @@
+#pragma once
+
+#include "lob/order_book.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+namespace lob {
+
+// Book used by the parameterised suites: 10k orders, ladder band $50-$150
+inline BookConfig test_book_config(LevelStorage storage) {
+    BookConfig config;
+    config.pool.capacity = 10000;
+    config.level_storage = storage;
+    config.ladder = LadderRange{to_price(50.00), to_price(150.00), 1};
+    return config;
+}
+
+inline std::string level_storage_name(const ::testing::TestParamInfo<LevelStorage>& info) {
+    return info.param == LevelStorage::Ladder ? "Ladder" : "Map";
+}
+
+}  // namespace lob
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include "lob/order_book.hpp"
+#include "test_config.hpp"
+
+#include <random>
+#include <vector>
+
+using namespace lob;
+
+namespace {
+
+using SmallTopBook = BasicOrderBook<CallbackListener, DefaultBookTraits, 3>;
+
+// Cached levels as (price, quantity) pairs, for comparison with *_depth()
+template <std::size_t N>
+std::vector<std::pair<Price, Quantity>> cached(const DepthCache<N>& cache) {
+    std::vector<std::pair<Price, Quantity>> out;
+    for (const DepthLevel& level : cache) out.emplace_back(level.price, level.quantity);
+    return out;
+}
+
+}  // namespace
+
+class DepthCacheTest : public ::testing::TestWithParam<LevelStorage> {};
+
+TEST_P(DepthCacheTest, RefillsFromBookWhenTopLevelEmpties) {
+    SmallTopBook book(test_book_config(GetParam()));
+    for (int i = 0; i < 5; ++i) {
+        book.add_order(Side::Buy, OrderType::Limit, to_price(100.00) - i * 100, 10);
+    }
+    auto shallow = book.add_order(Side::Buy, OrderType::Limit, to_price(99.00), 5);
+
+    ASSERT_EQ(book.bid_top().size(), 3u);
+    EXPECT_EQ(book.bid_top()[0].price, to_price(100.00));
+    EXPECT_EQ(book.bid_top()[1].price, to_price(99.00));
+    EXPECT_EQ(book.bid_top()[1].quantity, 15u);
+    EXPECT_EQ(book.bid_top()[1].order_count, 2u);
+
+    // A level outside the cache does not displace anything
+    book.add_order(Side::Buy, OrderType::Limit, to_price(90.00), 10);
+    EXPECT_EQ(cached(book.bid_top()), book.bid_depth(3));
+
+    // Sweeping the best level pulls the fourth level in
+    book.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 10);
+    EXPECT_EQ(cached(book.bid_top()), book.bid_depth(3));
+    EXPECT_EQ(book.bid_top()[2].price, to_price(97.00));
+
+    // Cancelling inside the cache refills from below the last cached level
+    book.cancel_order(shallow.order_id);
+    EXPECT_EQ(book.bid_top()[0].quantity, 10u);
+    book.add_order(Side::Sell, OrderType::Market, 0, 10);
+    EXPECT_EQ(cached(book.bid_top()), book.bid_depth(3));
+    EXPECT_EQ(book.bid_top()[2].price, to_price(96.00));
+    EXPECT_TRUE(book.ask_top().empty());
+}
+
+TEST_P(DepthCacheTest, MatchesDepthUnderRandomFlow) {
+    // Reference book without a cache sees the same flow
+    SmallTopBook book(test_book_config(GetParam()));
+    BasicOrderBook<CallbackListener, DefaultBookTraits, 0> reference(test_book_config(GetParam()));
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<Price> price_dist(to_price(99.00), to_price(101.00));
+    std::vector<OrderId> ids;
+    for (int i = 0; i < 5000; ++i) {
+        auto action = rng() % 10;
+        if (action < 6 || ids.empty()) {
+            Side side = rng() % 2 ? Side::Buy : Side::Sell;
+            Price price = price_dist(rng);
+            Quantity qty = 1 + rng() % 50;
+            ids.push_back(book.add_order(side, OrderType::Limit, price, qty).order_id);
+            reference.add_order(side, OrderType::Limit, price, qty);
+        } else if (action < 8) {
+            OrderId id = ids[rng() % ids.size()];
+            book.cancel_order(id);
+            reference.cancel_order(id);
+        } else {
+            OrderId id = ids[rng() % ids.size()];
+            Quantity qty = 1 + rng() % 50;
+            book.modify_order(id, qty);
+            reference.modify_order(id, qty);
+        }
+        ASSERT_EQ(cached(book.bid_top()), book.bid_depth(3));
+        ASSERT_EQ(cached(book.ask_top()), book.ask_depth(3));
+    }
+
+    // Level queries agree whether served from the cache or from storage
+    for (Side side : {Side::Buy, Side::Sell}) {
+        for (Price p = to_price(98.90); p <= to_price(101.10); ++p) {
+            EXPECT_EQ(book.volume_at_price(side, p), reference.volume_at_price(side, p));
+            EXPECT_EQ(book.order_count_at_price(side, p), reference.order_count_at_price(side, p));
+        }
+    }
+}
+
+TEST_P(DepthCacheTest, RestoreRebuildsCache) {
+    SmallTopBook book(test_book_config(GetParam()));
+    for (int i = 0; i < 6; ++i) {
+        book.add_order(Side::Sell, OrderType::Limit, to_price(101.00) + i * 10, 10 + i);
+    }
+    std::vector<char> image(book.snapshot_size());
+    ASSERT_EQ(book.snapshot(image.data(), image.size()), image.size());
+
+    SmallTopBook restored(test_book_config(GetParam()));
+    ASSERT_TRUE(restored.restore(image.data(), image.size()));
+    EXPECT_EQ(cached(restored.ask_top()), book.ask_depth(3));
+    EXPECT_EQ(restored.volume_at_price(Side::Sell, to_price(101.20)), 12u);
+    EXPECT_EQ(restored.order_count_at_price(Side::Sell, to_price(101.50)), 1u);
+}
+
+INSTANTIATE_TEST_SUITE_P(LevelStorage, DepthCacheTest,
+                         ::testing::Values(LevelStorage::Map, LevelStorage::Ladder),
+                         level_storage_name);
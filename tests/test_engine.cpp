@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include "lob/matching_engine.hpp"
+#include "test_config.hpp"
+
+#include <vector>
+#include <atomic>
+
+using namespace lob;
+
+namespace {
+
+EngineConfig two_shards() {
+    EngineConfig config;
+    config.shards = {ShardConfig{0, -1}, ShardConfig{-1, -1}};
+    config.max_symbols = 64;
+    return config;
+}
+
+}  // namespace
+
+TEST(EngineTest, OrderIdsEncodeSymbol) {
+    MatchingEngine engine(two_shards());
+    engine.add_symbol(3, test_book_config(LevelStorage::Map));
+    engine.add_symbol(42, test_book_config(LevelStorage::Ladder));
+
+    auto a = engine.add_order(3, Side::Buy, OrderType::Limit, to_price(100.00), 10);
+    auto b = engine.add_order(42, Side::Buy, OrderType::Limit, to_price(100.00), 10);
+    ASSERT_EQ(a.status, OrderStatus::Active);
+    ASSERT_EQ(b.status, OrderStatus::Active);
+    EXPECT_EQ(symbol_of(a.order_id), 3u);
+    EXPECT_EQ(symbol_of(b.order_id), 42u);
+    EXPECT_EQ(a.order_id, symbol_id_base(3) + 1);
+
+    // Cancels route by ID alone, and only touch the owning book
+    EXPECT_TRUE(engine.cancel_order(b.order_id));
+    EXPECT_FALSE(engine.cancel_order(b.order_id));
+    EXPECT_EQ(engine.book(3)->total_orders(), 1u);
+    EXPECT_EQ(engine.book(42)->total_orders(), 0u);
+}
+
+TEST(EngineTest, ExhaustedSequenceDoesNotSpillIntoNextSymbol) {
+    MatchingEngine engine(two_shards());
+    OrderBook& book = engine.add_symbol(3, test_book_config(LevelStorage::Map));
+    engine.add_symbol(4, test_book_config(LevelStorage::Map));
+
+    // An ID at the top of symbol 3's range uses up its sequence
+    ASSERT_EQ(book.insert_order(symbol_id_limit(3), Side::Buy, to_price(99.00), 10).status,
+              OrderStatus::Active);
+    EXPECT_EQ(symbol_of(symbol_id_limit(3)), 3u);
+
+    auto r = engine.add_order(3, Side::Sell, OrderType::Limit, to_price(101.00), 5);
+    EXPECT_EQ(r.status, OrderStatus::Rejected);
+    EXPECT_EQ(r.reject_reason, RejectReason::IdsExhausted);
+    EXPECT_EQ(r.remaining_quantity, 5u);
+    EXPECT_EQ(book.total_orders(), 1u);
+
+    auto next = engine.add_order(4, Side::Sell, OrderType::Limit, to_price(101.00), 5);
+    EXPECT_EQ(next.order_id, symbol_id_base(4) + 1);
+}
+
+TEST(EngineTest, UnknownSymbolIsRejected) {
+    MatchingEngine engine(two_shards());
+    engine.add_symbol(1, test_book_config(LevelStorage::Map));
+
+    auto r = engine.add_order(2, Side::Sell, OrderType::Limit, to_price(100.00), 5);
+    EXPECT_EQ(r.status, OrderStatus::Rejected);
+    EXPECT_EQ(r.reject_reason, RejectReason::UnknownSymbol);
+    EXPECT_EQ(r.remaining_quantity, 5u);
+
+    auto far = engine.add_order(1000, Side::Sell, OrderType::Limit, to_price(100.00), 5);
+    EXPECT_EQ(far.reject_reason, RejectReason::UnknownSymbol);
+
+    EXPECT_FALSE(engine.cancel_order(symbol_id_base(2) + 1));
+    EXPECT_FALSE(engine.modify_order(symbol_id_base(7) + 1, 10));
+    EXPECT_FALSE(engine.cancel_order(0));
+}
+
+TEST(EngineTest, SymbolsBalanceAcrossShards) {
+    MatchingEngine engine(two_shards());
+    for (SymbolId s = 0; s < 6; ++s) engine.add_symbol(s, test_book_config(LevelStorage::Map));
+    EXPECT_EQ(engine.symbol_count(), 6u);
+    EXPECT_EQ(engine.symbols_on(0).size(), 3u);
+    EXPECT_EQ(engine.symbols_on(1).size(), 3u);
+
+    engine.add_symbol(10, 1, test_book_config(LevelStorage::Map));
+    EXPECT_EQ(engine.shard_of(10), 1u);
+
+    EXPECT_THROW(engine.add_symbol(10, test_book_config(LevelStorage::Map)),
+                 std::invalid_argument);
+    EXPECT_THROW(engine.add_symbol(64, test_book_config(LevelStorage::Map)), std::out_of_range);
+    EXPECT_THROW(engine.add_symbol(11, 2, test_book_config(LevelStorage::Map)),
+                 std::out_of_range);
+}
+
+TEST(EngineTest, WorkersOwnTheirShards) {
+    MatchingEngine engine(two_shards());
+    for (SymbolId s = 0; s < 8; ++s) engine.add_symbol(s, test_book_config(LevelStorage::Ladder));
+
+    std::atomic<int> trades{0};
+    engine.run([&](std::size_t shard) {
+        // Each worker writes only to the books of its own shard
+        for (SymbolId symbol : engine.symbols_on(shard)) {
+            for (int i = 0; i < 100; ++i) {
+                engine.add_order(symbol, Side::Sell, OrderType::Limit, to_price(100.00), 10);
+            }
+            auto r = engine.add_order(symbol, Side::Buy, OrderType::Limit, to_price(100.00), 250);
+            trades += static_cast<int>(r.trades.size());
+        }
+    });
+
+    EXPECT_EQ(trades.load(), 8 * 25);
+    for (SymbolId s = 0; s < 8; ++s) {
+        EXPECT_EQ(engine.book(s)->total_orders(), 75u);
+        EXPECT_EQ(engine.book(s)->volume_at_price(Side::Sell, to_price(100.00)), 750u);
+    }
+}
+
+TEST(EngineTest, PinRejectsInvalidCore) {
+    EXPECT_FALSE(pin_current_thread(-1));
+    EXPECT_FALSE(pin_current_thread(1 << 20));
+}
@@ -0,0 +1,280 @@
+#include <gtest/gtest.h>
+#include "lob/feed.hpp"
+#include "lob/order_book.hpp"
+#include "test_config.hpp"
+
+#include <cstdio>
+#include <string>
+#include <system_error>
+#include <vector>
+
+using namespace lob;
+
+namespace {
+
+// Wire prices carry four implied decimals
+constexpr std::uint32_t wire(double price) {
+    return static_cast<std::uint32_t>(price * FEED_PRICE_SCALE + 0.5);
+}
+
+using CompactBook = BasicOrderBook<BasicCallbackListener<CompactBookTraits>, CompactBookTraits>;
+
+}  // namespace
+
+class FeedTest : public ::testing::TestWithParam<LevelStorage> {};
+
+TEST_P(FeedTest, MessagesDriveTheBook) {
+    OrderBook book(test_book_config(GetParam()));
+    std::vector<Trade> seen;
+    book.set_trade_callback([&](const Trade& t) { seen.push_back(t); });
+
+    FeedEncoder feed;
+    feed.add_order(1001, Side::Buy, 300, wire(99.50));
+    feed.add_order(1002, Side::Buy, 200, wire(99.50));
+    feed.add_order(2001, Side::Sell, 500, wire(100.25));
+    feed.execute(1001, 100);
+    feed.execute_at(2001, 50, wire(100.20));
+    feed.cancel(1002, 150);
+    feed.remove(1002);
+
+    FeedDecoder<OrderBook> decoder(book);
+    EXPECT_EQ(decoder.decode(feed.data(), feed.size()), feed.size());
+    EXPECT_EQ(decoder.stats().messages, 7u);
+    EXPECT_EQ(decoder.stats().adds, 3u);
+    EXPECT_EQ(decoder.stats().executions, 2u);
+    EXPECT_EQ(decoder.stats().cancels, 2u);
+    EXPECT_EQ(decoder.stats().rejected, 0u);
+
+    EXPECT_EQ(book.best_bid(), to_price(99.50));
+    EXPECT_EQ(book.best_ask(), to_price(100.25));
+    EXPECT_EQ(book.volume_at_price(Side::Buy, to_price(99.50)), 200u);
+    EXPECT_EQ(book.volume_at_price(Side::Sell, to_price(100.25)), 450u);
+    EXPECT_EQ(book.total_orders(), 2u);
+
+    // Executions report the resting side only, at the printed price
+    ASSERT_EQ(seen.size(), 2u);
+    EXPECT_EQ(seen[0].buy_order_id, 1001u);
+    EXPECT_EQ(seen[0].sell_order_id, 0u);
+    EXPECT_EQ(seen[0].price, to_price(99.50));
+    EXPECT_EQ(seen[1].sell_order_id, 2001u);
+    EXPECT_EQ(seen[1].price, to_price(100.20));
+    EXPECT_EQ(book.total_volume(), 150u);
+}
+
+TEST_P(FeedTest, ExecutionEmptiesOrderAndLevel) {
+    OrderBook book(test_book_config(GetParam()));
+    FeedEncoder feed;
+    feed.add_order(7, Side::Sell, 100, wire(101.00));
+    feed.add_order(8, Side::Sell, 100, wire(102.00));
+    feed.execute(7, 60);
+    feed.execute(7, 40);
+    feed.execute(7, 10);  // already gone
+    FeedDecoder<OrderBook> decoder(book);
+    decoder.decode(feed.data(), feed.size());
+
+    EXPECT_EQ(book.best_ask(), to_price(102.00));
+    EXPECT_EQ(book.total_orders(), 1u);
+    EXPECT_EQ(book.total_volume(), 100u);
+    EXPECT_EQ(decoder.stats().rejected, 1u);
+}
+
+TEST_P(FeedTest, ReplaceLosesPriorityUnderNewReference) {
+    OrderBook book(test_book_config(GetParam()));
+    FeedEncoder feed;
+    feed.add_order(1, Side::Buy, 100, wire(99.00));
+    feed.add_order(2, Side::Buy, 100, wire(99.00));
+    feed.replace(1, 3, 150, wire(99.00));   // same price: back of the queue
+    feed.replace(2, 4, 100, wire(99.25));   // new level
+    feed.replace(9, 10, 100, wire(99.00));  // unknown
+    feed.replace(3, 4, 100, wire(99.00));   // new reference already live
+    FeedDecoder<OrderBook> decoder(book);
+    decoder.decode(feed.data(), feed.size());
+
+    EXPECT_EQ(decoder.stats().replaces, 4u);
+    EXPECT_EQ(decoder.stats().rejected, 2u);
+    EXPECT_EQ(book.best_bid(), to_price(99.25));
+    EXPECT_EQ(book.volume_at_price(Side::Buy, to_price(99.00)), 150u);
+    EXPECT_FALSE(book.cancel_order(1));
+    EXPECT_FALSE(book.cancel_order(2));
+    EXPECT_TRUE(book.cancel_order(3));
+    EXPECT_TRUE(book.cancel_order(4));
+    EXPECT_EQ(book.total_orders(), 0u);
+}
+
+TEST_P(FeedTest, PartialCancelKeepsPriority) {
+    OrderBook book(test_book_config(GetParam()));
+    std::vector<Trade> seen;
+    book.set_trade_callback([&](const Trade& t) { seen.push_back(t); });
+    FeedEncoder feed;
+    feed.add_order(1, Side::Sell, 100, wire(100.00));
+    feed.add_order(2, Side::Sell, 100, wire(100.00));
+    feed.cancel(1, 70);
+    decode_feed(feed.data(), feed.size(), book);
+    EXPECT_EQ(book.volume_at_price(Side::Sell, to_price(100.00)), 130u);
+
+    // A crossing order still fills the reduced order first
+    auto r = book.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 40);
+    ASSERT_EQ(r.trades.size(), 2u);
+    EXPECT_EQ(r.trades[0].sell_order_id, 1u);
+    EXPECT_EQ(r.trades[0].quantity, 30u);
+    EXPECT_EQ(r.trades[1].sell_order_id, 2u);
+}
+
+TEST_P(FeedTest, SnapshotOfAFeedBuiltBookRestores) {
+    OrderBook book(test_book_config(GetParam()));
+    FeedEncoder feed;
+    feed.add_order(5000, Side::Buy, 100, wire(99.50));
+    feed.add_order(9000, Side::Buy, 200, wire(99.25));
+    feed.add_order(7000, Side::Sell, 300, wire(100.50));
+    feed.replace(9000, 12000, 250, wire(99.50));
+    feed.execute(7000, 50);
+    decode_feed(feed.data(), feed.size(), book);
+
+    std::vector<char> image(book.snapshot_size());
+    ASSERT_EQ(book.snapshot(image.data(), image.size()), image.size());
+    OrderBook restored(test_book_config(GetParam()));
+    ASSERT_TRUE(restored.restore(image.data(), image.size()));
+
+    EXPECT_EQ(restored.total_orders(), book.total_orders());
+    EXPECT_EQ(restored.total_volume(), book.total_volume());
+    EXPECT_EQ(restored.bid_depth(10), book.bid_depth(10));
+    EXPECT_EQ(restored.ask_depth(10), book.ask_depth(10));
+    EXPECT_EQ(restored.order_count_at_price(Side::Buy, to_price(99.50)), 2u);
+
+    // The tail of the feed applies to both books alike
+    FeedEncoder tail;
+    tail.execute(5000, 100);
+    tail.remove(12000);
+    decode_feed(tail.data(), tail.size(), book);
+    decode_feed(tail.data(), tail.size(), restored);
+    EXPECT_EQ(restored.total_orders(), 1u);
+    EXPECT_EQ(restored.bid_depth(10), book.bid_depth(10));
+    EXPECT_EQ(restored.ask_depth(10), book.ask_depth(10));
+    EXPECT_TRUE(restored.cancel_order(7000));
+}
+
+INSTANTIATE_TEST_SUITE_P(Storage, FeedTest,
+                         ::testing::Values(LevelStorage::Map, LevelStorage::Ladder),
+                         level_storage_name);
+
+TEST(FeedDecoderTest, PartialFrameIsLeftForTheNextBuffer) {
+    OrderBook book;
+    FeedEncoder feed;
+    feed.add_order(1, Side::Buy, 100, wire(99.00));
+    feed.add_order(2, Side::Sell, 100, wire(101.00));
+
+    FeedDecoder<OrderBook> decoder(book);
+    std::size_t cut = feed.size() - 5;
+    std::size_t used = decoder.decode(feed.data(), cut);
+    EXPECT_EQ(used, 2u + feed_message_size('A'));
+    EXPECT_EQ(book.total_orders(), 1u);
+
+    // Resume from the unconsumed bytes once the rest has arrived
+    EXPECT_EQ(decoder.decode(feed.data() + used, feed.size() - used), feed.size() - used);
+    EXPECT_EQ(book.best_ask(), to_price(101.00));
+    EXPECT_EQ(decoder.stats().messages, 2u);
+}
+
+TEST(FeedDecoderTest, SkipsOtherMessagesAndSymbols) {
+    OrderBook book;
+    FeedEncoder feed(7);
+    feed.add_order(1, Side::Buy, 100, wire(99.00));
+    FeedEncoder other(8);
+    other.add_order(2, Side::Buy, 100, wire(99.50));
+
+    std::vector<char> wire_bytes(feed.buffer());
+    wire_bytes.insert(wire_bytes.end(), other.buffer().begin(), other.buffer().end());
+    // System event ('S', 12 bytes) and a truncated add
+    const char system_event[] = {0, 12, 'S', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 'O'};
+    wire_bytes.insert(wire_bytes.end(), system_event, system_event + sizeof(system_event));
+    const char short_add[] = {0, 3, 'A', 0, 7};
+    wire_bytes.insert(wire_bytes.end(), short_add, short_add + sizeof(short_add));
+
+    FeedConfig config;
+    config.locate = 7;
+    FeedDecoder<OrderBook> decoder(book, config);
+    EXPECT_EQ(decoder.decode(wire_bytes.data(), wire_bytes.size()), wire_bytes.size());
+    EXPECT_EQ(decoder.stats().messages, 4u);
+    EXPECT_EQ(decoder.stats().adds, 1u);
+    EXPECT_EQ(decoder.stats().skipped, 2u);
+    EXPECT_EQ(decoder.stats().malformed, 1u);
+    EXPECT_EQ(book.best_bid(), to_price(99.00));
+}
+
+TEST(FeedDecoderTest, DuplicateReferenceIsRejected) {
+    OrderBook book;
+    auto ack = book.insert_order(5, Side::Buy, to_price(99.00), 100);
+    EXPECT_EQ(ack.status, OrderStatus::Active);
+    EXPECT_EQ(ack.order_id, 5u);
+    ack = book.insert_order(5, Side::Sell, to_price(101.00), 100);
+    EXPECT_EQ(ack.status, OrderStatus::Rejected);
+    EXPECT_EQ(ack.reject_reason, RejectReason::DuplicateId);
+    ack = book.insert_order(0, Side::Sell, to_price(101.00), 100);
+    EXPECT_EQ(ack.reject_reason, RejectReason::DuplicateId);
+
+    // No matching: a crossing insert rests alongside the bid
+    ack = book.insert_order(6, Side::Sell, to_price(98.00), 100);
+    EXPECT_EQ(ack.status, OrderStatus::Active);
+    EXPECT_EQ(book.total_trades(), 0u);
+    EXPECT_EQ(book.total_orders(), 2u);
+}
+
+TEST(FeedDecoderTest, SubTickPricesAreMalformed) {
+    OrderBook book;
+    FeedEncoder feed;
+    feed.add_order(1, Side::Buy, 100, 995050);          // 99.505: half a tick
+    feed.add_order(2, Side::Buy, 100, 50);              // below one tick, would be 0
+    feed.add_order(3, Side::Sell, 100, wire(101.00));
+    feed.execute_at(3, 10, 1010001);                    // 101.0001
+    feed.execute_at(3, 10, 0);                          // would print at the order's price
+    feed.replace(3, 4, 100, 1009999);                   // 100.9999
+    FeedDecoder<OrderBook> decoder(book);
+    decoder.decode(feed.data(), feed.size());
+
+    EXPECT_EQ(decoder.stats().malformed, 5u);
+    EXPECT_EQ(decoder.stats().adds, 1u);
+    EXPECT_EQ(decoder.stats().executions, 0u);
+    EXPECT_EQ(decoder.stats().replaces, 0u);
+    EXPECT_EQ(book.best_bid(), INVALID_PRICE);
+    EXPECT_EQ(book.volume_at_price(Side::Sell, to_price(101.00)), 100u);
+    EXPECT_EQ(book.total_trades(), 0u);
+}
+
+TEST(FeedDecoderTest, CompactBookRejectsWideReferences) {
+    CompactBook book;
+    FeedEncoder feed;
+    feed.add_order(std::uint64_t{1} << 40, Side::Buy, 100, wire(99.00));
+    feed.add_order(12, Side::Buy, 100, wire(99.00));
+    FeedDecoder<CompactBook> decoder(book);
+    decoder.decode(feed.data(), feed.size());
+    EXPECT_EQ(decoder.stats().rejected, 1u);
+    EXPECT_EQ(book.best_bid(), to_price<CompactBookTraits>(99.00));
+    EXPECT_EQ(book.total_orders(), 1u);
+}
+
+TEST(FeedDecoderTest, DecodesMappedCapture) {
+    FeedEncoder feed;
+    for (std::uint64_t i = 1; i <= 100; ++i) {
+        feed.add_order(i, i % 2 ? Side::Buy : Side::Sell, 100,
+                       i % 2 ? wire(99.00) : wire(101.00));
+    }
+    for (std::uint64_t i = 1; i <= 100; i += 4) feed.remove(i);
+
+    std::string path = ::testing::TempDir() + "lob_feed_capture";
+    std::FILE* out = std::fopen(path.c_str(), "wb");
+    ASSERT_NE(out, nullptr);
+    ASSERT_EQ(std::fwrite(feed.data(), 1, feed.size(), out), feed.size());
+    std::fclose(out);
+
+    OrderBook book;
+    {
+        FeedFile file(path);
+        ASSERT_EQ(file.size(), feed.size());
+        EXPECT_EQ(decode_feed(file.data(), file.size(), book), file.size());
+    }
+    EXPECT_EQ(book.total_orders(), 75u);
+    EXPECT_EQ(book.volume_at_price(Side::Buy, to_price(99.00)), 2500u);
+    std::remove(path.c_str());
+
+    EXPECT_THROW(FeedFile missing(path), std::system_error);
+}
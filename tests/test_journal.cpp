@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+#include "lob/journal.hpp"
+#include "lob/pipeline.hpp"
+#include "test_config.hpp"
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace lob;
+
+namespace {
+
+std::string journal_path(const char* name) {
+    return ::testing::TempDir() + "lob_" + name + ".journal";
+}
+
+// Random adds (of every order type), crossing orders, cancels, modifies
+// and replaces
+void drive(JournaledBook& jb, std::size_t steps) {
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<Price> price_dist(to_price(99.00), to_price(101.00));
+    std::uniform_int_distribution<Quantity> qty_dist(1, 200);
+    std::vector<OrderId> ids;
+    TradeBuffer trades;
+    for (std::size_t i = 0; i < steps; ++i) {
+        auto action = rng() % 10;
+        if (action < 6 || ids.empty()) {
+            Side side = rng() % 2 ? Side::Buy : Side::Sell;
+            OrderType type = action == 0   ? OrderType::Market
+                             : action == 1 ? OrderType::IOC
+                             : action == 2 ? OrderType::FOK
+                                           : OrderType::Limit;
+            OrderAck ack = jb.add_order(side, type, price_dist(rng), qty_dist(rng), trades);
+            trades.clear();
+            if (ack.order_id != 0) ids.push_back(ack.order_id);
+        } else if (action < 8) {
+            jb.cancel_order(ids[rng() % ids.size()]);
+        } else if (action < 9) {
+            jb.modify_order(ids[rng() % ids.size()], qty_dist(rng));
+        } else {
+            jb.replace_order(ids[rng() % ids.size()], price_dist(rng), qty_dist(rng), trades);
+            trades.clear();
+        }
+    }
+}
+
+}  // namespace
+
+TEST(JournalTest, ReplayRebuildsIdenticalBook) {
+    std::string path = journal_path("replay");
+    BookConfig config = test_book_config(LevelStorage::Ladder);
+    {
+        JournaledBook original(path, config, 10000, 64);
+        drive(original, 5000);
+        original.journal().sync();
+
+        JournalReader reader(path);
+        EXPECT_EQ(reader.size(), 5000u);
+        OrderBook rebuilt(book_config_from(reader.header()));
+        EXPECT_EQ(replay_journal(reader, rebuilt), 5000u);
+
+        OrderBook& live = original.book();
+        EXPECT_EQ(rebuilt.total_orders(), live.total_orders());
+        EXPECT_EQ(rebuilt.total_trades(), live.total_trades());
+        EXPECT_EQ(rebuilt.total_volume(), live.total_volume());
+        EXPECT_EQ(rebuilt.bid_depth(1000), live.bid_depth(1000));
+        EXPECT_EQ(rebuilt.ask_depth(1000), live.ask_depth(1000));
+
+        // Same next ID and timestamp: a sweep produces identical trades
+        auto a = live.add_order(Side::Buy, OrderType::Market, 0, 1000);
+        auto b = rebuilt.add_order(Side::Buy, OrderType::Market, 0, 1000);
+        EXPECT_EQ(a.order_id, b.order_id);
+        ASSERT_EQ(a.trades.size(), b.trades.size());
+        for (std::size_t i = 0; i < a.trades.size(); ++i) {
+            EXPECT_EQ(a.trades[i].sell_order_id, b.trades[i].sell_order_id);
+            EXPECT_EQ(a.trades[i].timestamp, b.trades[i].timestamp);
+        }
+    }
+    std::remove(path.c_str());
+}
+
+TEST(JournalTest, ReplayIncludesAuctionPhases) {
+    std::string path = journal_path("auction");
+    BookConfig config = test_book_config(LevelStorage::Map);
+    {
+        JournaledBook original(path, config, 10000, 64);
+        ASSERT_TRUE(original.begin_auction());
+        drive(original, 500);
+        TradeBuffer trades;
+        AuctionResult live_result = original.uncross(trades);
+        drive(original, 500);
+        original.journal().sync();
+
+        JournalReader reader(path);
+        OrderBook rebuilt(book_config_from(reader.header()));
+        replay_journal(reader, rebuilt);
+        OrderBook& live = original.book();
+        EXPECT_GT(live_result.volume, 0u);
+        EXPECT_EQ(rebuilt.phase(), TradingPhase::Continuous);
+        EXPECT_EQ(rebuilt.total_trades(), live.total_trades());
+        EXPECT_EQ(rebuilt.total_volume(), live.total_volume());
+        EXPECT_EQ(rebuilt.bid_depth(1000), live.bid_depth(1000));
+        EXPECT_EQ(rebuilt.ask_depth(1000), live.ask_depth(1000));
+    }
+    std::remove(path.c_str());
+}
+
+TEST(JournalTest, HeaderCarriesBookConfig) {
+    std::string path = journal_path("header");
+    BookConfig config = test_book_config(LevelStorage::Ladder);
+    config.pool.max_capacity = 20000;
+    config.id_base = OrderId{5} << 40;
+    config.id_limit = (OrderId{6} << 40) - 1;
+    { JournalWriter writer(path, config, 16); }
+
+    JournalReader reader(path);
+    BookConfig restored = book_config_from(reader.header());
+    EXPECT_EQ(restored.level_storage, LevelStorage::Ladder);
+    EXPECT_EQ(restored.ladder.min_price, config.ladder.min_price);
+    EXPECT_EQ(restored.ladder.max_price, config.ladder.max_price);
+    EXPECT_EQ(restored.pool.capacity, config.pool.capacity);
+    EXPECT_EQ(restored.pool.max_capacity, 20000u);
+    EXPECT_EQ(restored.id_base, config.id_base);
+    EXPECT_EQ(restored.id_limit, config.id_limit);
+    EXPECT_EQ(reader.size(), 0u);
+    std::remove(path.c_str());
+}
+
+TEST(JournalTest, FullJournalRejectsWithoutApplying) {
+    std::string path = journal_path("full");
+    {
+        JournaledBook jb(path, test_book_config(LevelStorage::Map), 2);
+        TradeBuffer trades;
+        auto first = jb.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 10, trades);
+        EXPECT_EQ(first.status, OrderStatus::Active);
+        EXPECT_TRUE(jb.cancel_order(first.order_id));
+
+        auto third = jb.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 10, trades);
+        EXPECT_EQ(third.status, OrderStatus::Rejected);
+        EXPECT_EQ(third.reject_reason, RejectReason::JournalFull);
+        EXPECT_TRUE(jb.book().empty());
+        EXPECT_TRUE(jb.journal().full());
+    }
+    std::remove(path.c_str());
+}
+
+TEST(JournalTest, RejectsForeignFile) {
+    std::string path = journal_path("foreign");
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    ASSERT_NE(f, nullptr);
+    std::vector<char> junk(JOURNAL_HEADER_SIZE, 'x');
+    std::fwrite(junk.data(), 1, junk.size(), f);
+    std::fclose(f);
+
+    EXPECT_THROW(JournalReader reader(path), std::runtime_error);
+    EXPECT_THROW(JournalReader reader(path + ".missing"), std::system_error);
+    std::remove(path.c_str());
+}
+
+TEST(JournalTest, PipelineJournalsOnMatchingThread) {
+    std::string path = journal_path("pipeline");
+    BookConfig config = test_book_config(LevelStorage::Map);
+    JournalWriter journal(path, config, 1000);
+
+    PipelineConfig pc;
+    pc.ingress_capacity = 64;
+    pc.egress_capacity = 256;
+    pc.yield_when_idle = true;
+    pc.journal = &journal;
+    BookPipeline pipeline(config, pc);
+    pipeline.start();
+    for (std::uint64_t tag = 1; tag <= 20; ++tag) {
+        Side side = tag % 2 ? Side::Buy : Side::Sell;
+        auto command = OrderCommand::add(tag, side, OrderType::Limit, to_price(100.00), 5);
+        while (!pipeline.submit(command)) std::this_thread::yield();
+    }
+    pipeline.stop();
+
+    JournalReader reader(path);
+    EXPECT_EQ(reader.size(), 20u);
+    OrderBook rebuilt(book_config_from(reader.header()));
+    replay_journal(reader, rebuilt);
+    EXPECT_EQ(rebuilt.total_trades(), pipeline.book().total_trades());
+    EXPECT_EQ(rebuilt.total_orders(), pipeline.book().total_orders());
+    std::remove(path.c_str());
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include "lob/level_bitmap.hpp"
+#include "lob/order_book.hpp"
+
+#include <random>
+#include <set>
+
+using namespace lob;
+
+TEST(LevelBitmapTest, DepthGrowsWithSlots) {
+    EXPECT_EQ(LevelBitmap(64).depth(), 1u);
+    EXPECT_EQ(LevelBitmap(65).depth(), 2u);
+    EXPECT_EQ(LevelBitmap(64 * 64).depth(), 2u);
+    EXPECT_EQ(LevelBitmap(64 * 64 * 64).depth(), 3u);
+    EXPECT_EQ(LevelBitmap(64 * 64 * 64 + 1).depth(), 4u);
+}
+
+TEST(LevelBitmapTest, EmptyAndEdges) {
+    LevelBitmap bits(300000);
+    EXPECT_EQ(bits.find_next(0), LevelBitmap::npos);
+    EXPECT_EQ(bits.find_prev(299999), LevelBitmap::npos);
+
+    bits.set(0);
+    bits.set(299999);
+    EXPECT_EQ(bits.find_next(1), 299999u);
+    EXPECT_EQ(bits.find_prev(299998), 0u);
+    EXPECT_EQ(bits.find_next(300000), LevelBitmap::npos);
+    EXPECT_EQ(bits.find_prev(0), 0u);
+
+    bits.clear(0);
+    EXPECT_FALSE(bits.test(0));
+    EXPECT_EQ(bits.find_prev(299998), LevelBitmap::npos);
+    EXPECT_EQ(bits.find_next(0), 299999u);
+}
+
+TEST(LevelBitmapTest, MatchesOrderedSetUnderRandomOps) {
+    constexpr std::size_t SLOTS = 70000;  // three layers, partial top words
+    LevelBitmap bits(SLOTS);
+    std::set<std::size_t> live;
+    std::mt19937 rng(17);
+    for (int step = 0; step < 20000; ++step) {
+        std::size_t slot = rng() % SLOTS;
+        if (rng() % 3 == 0 && !live.empty()) {
+            auto it = live.lower_bound(slot);
+            if (it == live.end()) it = live.begin();
+            bits.clear(*it);
+            live.erase(it);
+        } else {
+            bits.set(slot);
+            live.insert(slot);
+        }
+
+        std::size_t probe = rng() % SLOTS;
+        auto next = live.lower_bound(probe);
+        ASSERT_EQ(bits.find_next(probe), next == live.end() ? LevelBitmap::npos : *next);
+        auto after = live.upper_bound(probe);
+        ASSERT_EQ(bits.find_prev(probe),
+                  after == live.begin() ? LevelBitmap::npos : *std::prev(after));
+        ASSERT_EQ(bits.test(probe), live.count(probe) == 1);
+    }
+}
+
+TEST(LevelBitmapTest, WideLadderSweepsAcrossSparseLevels) {
+    // Million-tick band with a handful of levels far apart
+    BookConfig config;
+    config.pool.capacity = 1000;
+    config.level_storage = LevelStorage::Ladder;
+    config.ladder = LadderRange{1, 1'000'000, 1};
+    OrderBook book(config);
+    for (Price p : {Price{500'000}, Price{750'000}, Price{999'999}}) {
+        book.add_order(Side::Sell, OrderType::Limit, p, 10);
+    }
+    for (Price p : {Price{1}, Price{200'000}, Price{499'999}}) {
+        book.add_order(Side::Buy, OrderType::Limit, p, 10);
+    }
+
+    auto sweep = book.add_order(Side::Buy, OrderType::Limit, 999'999, 35);
+    ASSERT_EQ(sweep.trades.size(), 3u);
+    EXPECT_EQ(sweep.trades[1].price, 750'000u);
+    EXPECT_EQ(sweep.trades[2].price, 999'999u);
+    EXPECT_EQ(book.best_ask(), INVALID_PRICE);
+    EXPECT_EQ(book.best_bid(), 999'999u);  // remainder rests
+
+    book.add_order(Side::Sell, OrderType::Market, 0, 5);
+    EXPECT_EQ(book.best_bid(), 499'999u);
+    book.add_order(Side::Sell, OrderType::Market, 0, 20);
+    EXPECT_EQ(book.best_bid(), 1u);
+}
@@ -1,16 +1,18 @@
 #include <gtest/gtest.h>
 #include "lob/order_book.hpp"
+#include "test_config.hpp"
 
 using namespace lob;
 
-class MatchingEngineTest : public ::testing::Test {
+// Every test runs against both map- and ladder-backed books
+class MatchingEngineTest : public ::testing::TestWithParam<LevelStorage> {
 protected:
-    OrderBook book{10000};
+    OrderBook book{test_book_config(GetParam())};
 };
 
 // --- Exact Match ---
 
-TEST_F(MatchingEngineTest, ExactMatchBuyIntoSell) {
+TEST_P(MatchingEngineTest, ExactMatchBuyIntoSell) {
     book.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 100);
     auto result = book.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 100);
 
@@ -22,7 +24,7 @@ TEST_F(MatchingEngineTest, ExactMatchBuyIntoSell) {
     EXPECT_EQ(book.total_orders(), 0u);
 }
 
-TEST_F(MatchingEngineTest, ExactMatchSellIntoBid) {
+TEST_P(MatchingEngineTest, ExactMatchSellIntoBid) {
     book.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 100);
     auto result = book.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 100);
 
@@ -33,7 +35,7 @@ TEST_F(MatchingEngineTest, ExactMatchSellIntoBid) {
 
 // --- Partial Fills ---
 
-TEST_F(MatchingEngineTest, PartialFillAggressorRests) {
+TEST_P(MatchingEngineTest, PartialFillAggressorRests) {
     book.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 50);
     auto result = book.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 100);
 
@@ -44,7 +46,7 @@ TEST_F(MatchingEngineTest, PartialFillAggressorRests) {
     EXPECT_EQ(book.best_bid(), to_price(100.00));
 }
 
-TEST_F(MatchingEngineTest, PartialFillPassiveRests) {
+TEST_P(MatchingEngineTest, PartialFillPassiveRests) {
     book.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 200);
     auto result = book.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 80);
 
@@ -56,7 +58,7 @@ TEST_F(MatchingEngineTest, PartialFillPassiveRests) {
 
 // --- Price-Time Priority ---
 
-TEST_F(MatchingEngineTest, PriceTimePriorityFIFO) {
+TEST_P(MatchingEngineTest, PriceTimePriorityFIFO) {
     // Two sells at same price — first one should fill first
     auto r1 = book.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 50);
     auto r2 = book.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 50);
@@ -68,7 +70,7 @@ TEST_F(MatchingEngineTest, PriceTimePriorityFIFO) {
     EXPECT_EQ(book.total_orders(), 1u);  // second sell remains
 }
 
-TEST_F(MatchingEngineTest, PricePriority) {
+TEST_P(MatchingEngineTest, PricePriority) {
     // Sell at 100 and 101 — buy at 101 should hit the 100 first
     auto r_100 = book.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 50);
     auto r_101 = book.add_order(Side::Sell, OrderType::Limit, to_price(101.00), 50);
@@ -81,7 +83,7 @@ TEST_F(MatchingEngineTest, PricePriority) {
     EXPECT_EQ(book.total_orders(), 1u);  // 101 sell remains
 }
 
-TEST_F(MatchingEngineTest, SweepMultipleLevels) {
+TEST_P(MatchingEngineTest, SweepMultipleLevels) {
     book.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 30);
     book.add_order(Side::Sell, OrderType::Limit, to_price(101.00), 30);
     book.add_order(Side::Sell, OrderType::Limit, to_price(102.00), 30);
@@ -100,7 +102,7 @@ TEST_F(MatchingEngineTest, SweepMultipleLevels) {
 
 // --- Market Orders ---
 
-TEST_F(MatchingEngineTest, MarketBuyFills) {
+TEST_P(MatchingEngineTest, MarketBuyFills) {
     book.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 100);
     auto result = book.add_order(Side::Buy, OrderType::Market, 0, 100);
 
@@ -109,7 +111,7 @@ TEST_F(MatchingEngineTest, MarketBuyFills) {
     EXPECT_EQ(book.total_orders(), 0u);
 }
 
-TEST_F(MatchingEngineTest, MarketSellFills) {
+TEST_P(MatchingEngineTest, MarketSellFills) {
     book.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 100);
     auto result = book.add_order(Side::Sell, OrderType::Market, 0, 100);
 
@@ -117,7 +119,7 @@ TEST_F(MatchingEngineTest, MarketSellFills) {
     EXPECT_EQ(result.filled_quantity, 100u);
 }
 
-TEST_F(MatchingEngineTest, MarketOrderPartialFillCancelsRemainder) {
+TEST_P(MatchingEngineTest, MarketOrderPartialFillCancelsRemainder) {
     book.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 30);
     auto result = book.add_order(Side::Buy, OrderType::Market, 0, 100);
 
@@ -128,16 +130,125 @@ TEST_F(MatchingEngineTest, MarketOrderPartialFillCancelsRemainder) {
     EXPECT_EQ(book.total_orders(), 0u);
 }
 
-TEST_F(MatchingEngineTest, MarketOrderIntoEmptyBook) {
+TEST_P(MatchingEngineTest, MarketOrderIntoEmptyBook) {
     auto result = book.add_order(Side::Buy, OrderType::Market, 0, 100);
     EXPECT_EQ(result.status, OrderStatus::Cancelled);
     EXPECT_EQ(result.filled_quantity, 0u);
     EXPECT_EQ(book.total_orders(), 0u);
 }
 
+// --- IOC / FOK ---
+
+TEST_P(MatchingEngineTest, IocFillsUpToLimitAndCancelsRest) {
+    book.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 100);
+    book.add_order(Side::Sell, OrderType::Limit, to_price(101.00), 50);
+    book.add_order(Side::Sell, OrderType::Limit, to_price(102.00), 80);
+    std::size_t slots = book.pool().size();
+
+    auto result = book.add_order(Side::Buy, OrderType::IOC, to_price(101.00), 200);
+    EXPECT_EQ(result.status, OrderStatus::Cancelled);
+    EXPECT_NE(result.order_id, 0u);
+    EXPECT_EQ(result.filled_quantity, 150u);
+    EXPECT_EQ(result.remaining_quantity, 50u);
+    ASSERT_EQ(result.trades.size(), 2u);
+    EXPECT_EQ(result.trades[0].buy_order_id, result.order_id);
+    EXPECT_EQ(result.trades[1].price, to_price(101.00));
+
+    // The remainder rests nowhere: the 102.00 ask is all that is left
+    EXPECT_EQ(book.total_orders(), 1u);
+    EXPECT_EQ(book.bid_levels(), 0u);
+    EXPECT_EQ(book.best_ask(), to_price(102.00));
+    EXPECT_EQ(book.pool().size(), slots - 2);
+}
+
+TEST_P(MatchingEngineTest, IocThatFillsInFull) {
+    book.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 100);
+    auto result = book.add_order(Side::Sell, OrderType::IOC, to_price(99.00), 60);
+    EXPECT_EQ(result.status, OrderStatus::Filled);
+    EXPECT_EQ(result.filled_quantity, 60u);
+    EXPECT_EQ(book.volume_at_price(Side::Buy, to_price(100.00)), 40u);
+
+    // Nothing crossing: cancelled outright, but the ID is still used up
+    auto miss = book.add_order(Side::Sell, OrderType::IOC, to_price(100.50), 10);
+    EXPECT_EQ(miss.status, OrderStatus::Cancelled);
+    EXPECT_EQ(miss.order_id, result.order_id + 1);
+    EXPECT_EQ(miss.filled_quantity, 0u);
+    EXPECT_EQ(book.ask_levels(), 0u);
+    EXPECT_EQ(book.total_orders(), 1u);
+}
+
+TEST_P(MatchingEngineTest, FokRejectsWithoutTouchingTheBook) {
+    book.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 100);
+    book.add_order(Side::Sell, OrderType::Limit, to_price(101.00), 50);
+    book.add_order(Side::Sell, OrderType::Limit, to_price(103.00), 500);
+
+    // 150 is available at 101.00 or better; more only beyond the limit
+    auto result = book.add_order(Side::Buy, OrderType::FOK, to_price(102.00), 151);
+    EXPECT_EQ(result.status, OrderStatus::Rejected);
+    EXPECT_EQ(result.reject_reason, RejectReason::InsufficientLiquidity);
+    EXPECT_EQ(result.order_id, 0u);
+    EXPECT_EQ(result.remaining_quantity, 151u);
+    EXPECT_TRUE(result.trades.empty());
+    EXPECT_EQ(book.total_trades(), 0u);
+    EXPECT_EQ(book.volume_at_price(Side::Sell, to_price(100.00)), 100u);
+
+    auto filled = book.add_order(Side::Buy, OrderType::FOK, to_price(102.00), 150);
+    EXPECT_EQ(filled.status, OrderStatus::Filled);
+    EXPECT_EQ(filled.filled_quantity, 150u);
+    EXPECT_EQ(filled.trades.size(), 2u);
+    EXPECT_EQ(book.best_ask(), to_price(103.00));
+}
+
+TEST_P(MatchingEngineTest, FokSellAgainstBids) {
+    book.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 100);
+    book.add_order(Side::Buy, OrderType::Limit, to_price(99.00), 100);
+    auto short_of = book.add_order(Side::Sell, OrderType::FOK, to_price(99.50), 101);
+    EXPECT_EQ(short_of.reject_reason, RejectReason::InsufficientLiquidity);
+    auto result = book.add_order(Side::Sell, OrderType::FOK, to_price(99.00), 200);
+    EXPECT_EQ(result.status, OrderStatus::Filled);
+    EXPECT_EQ(book.total_orders(), 0u);
+
+    auto empty = book.add_order(Side::Sell, OrderType::FOK, to_price(99.00), 1);
+    EXPECT_EQ(empty.reject_reason, RejectReason::InsufficientLiquidity);
+}
+
+TEST_P(MatchingEngineTest, FokIgnoresLazilyCancelledOrders) {
+    BookConfig config = test_book_config(GetParam());
+    config.lazy_cancel = true;
+    OrderBook lazy(config);
+    lazy.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 50);
+    auto dead = lazy.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 50);
+    lazy.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 50);
+    lazy.cancel_order(dead.order_id);
+    ASSERT_EQ(lazy.tombstones(), 1u);
+
+    auto result = lazy.add_order(Side::Buy, OrderType::FOK, to_price(100.00), 101);
+    EXPECT_EQ(result.reject_reason, RejectReason::InsufficientLiquidity);
+    result = lazy.add_order(Side::Buy, OrderType::FOK, to_price(100.00), 100);
+    EXPECT_EQ(result.status, OrderStatus::Filled);
+    EXPECT_EQ(lazy.total_orders(), 0u);
+}
+
+TEST_P(MatchingEngineTest, NonRestingOrdersNeedNoPoolSlot) {
+    BookConfig config = test_book_config(GetParam());
+    config.pool.capacity = 2;
+    OrderBook small(config);
+    small.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 10);
+    small.add_order(Side::Sell, OrderType::Limit, to_price(101.00), 10);
+    ASSERT_EQ(small.pool().available(), 0u);
+
+    EXPECT_EQ(small.add_order(Side::Buy, OrderType::IOC, to_price(100.00), 5).status,
+              OrderStatus::Filled);
+    EXPECT_EQ(small.add_order(Side::Buy, OrderType::FOK, to_price(101.00), 10).status,
+              OrderStatus::Filled);
+    EXPECT_EQ(small.add_order(Side::Buy, OrderType::Market, 0, 1).status, OrderStatus::Filled);
+    EXPECT_EQ(small.total_volume(), 16u);
+    EXPECT_EQ(small.volume_at_price(Side::Sell, to_price(101.00)), 4u);
+}
+
 // --- Crossing Orders ---
 
-TEST_F(MatchingEngineTest, BuyAboveAskCrosses) {
+TEST_P(MatchingEngineTest, BuyAboveAskCrosses) {
     book.add_order(Side::Sell, OrderType::Limit, to_price(99.00), 100);
     auto result = book.add_order(Side::Buy, OrderType::Limit, to_price(101.00), 100);
 
@@ -146,7 +257,7 @@ TEST_F(MatchingEngineTest, BuyAboveAskCrosses) {
     EXPECT_EQ(result.trades[0].price, to_price(99.00));
 }
 
-TEST_F(MatchingEngineTest, SellBelowBidCrosses) {
+TEST_P(MatchingEngineTest, SellBelowBidCrosses) {
     book.add_order(Side::Buy, OrderType::Limit, to_price(101.00), 100);
     auto result = book.add_order(Side::Sell, OrderType::Limit, to_price(99.00), 100);
 
@@ -157,7 +268,7 @@ TEST_F(MatchingEngineTest, SellBelowBidCrosses) {
 
 // --- No Match (orders rest) ---
 
-TEST_F(MatchingEngineTest, NoMatchBuyBelowAsk) {
+TEST_P(MatchingEngineTest, NoMatchBuyBelowAsk) {
     book.add_order(Side::Sell, OrderType::Limit, to_price(101.00), 100);
     auto result = book.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 100);
 
@@ -166,9 +277,49 @@ TEST_F(MatchingEngineTest, NoMatchBuyBelowAsk) {
     EXPECT_EQ(book.total_orders(), 2u);
 }
 
+// --- Caller-Supplied Trade Buffer ---
+
+TEST_P(MatchingEngineTest, TradeBufferReceivesFills) {
+    auto r1 = book.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 30);
+    auto r2 = book.add_order(Side::Sell, OrderType::Limit, to_price(101.00), 30);
+
+    Trade storage[4];
+    TradeBuffer trades(storage, 4);
+    auto ack = book.add_order(Side::Buy, OrderType::Market, 0, 50, trades);
+
+    EXPECT_EQ(ack.status, OrderStatus::Filled);
+    EXPECT_EQ(ack.filled_quantity, 50u);
+    EXPECT_EQ(ack.trade_count, 2u);
+    ASSERT_EQ(trades.size, 2u);
+    EXPECT_EQ(trades.data[0].sell_order_id, r1.order_id);
+    EXPECT_EQ(trades.data[0].quantity, 30u);
+    EXPECT_EQ(trades.data[1].sell_order_id, r2.order_id);
+    EXPECT_EQ(trades.data[1].quantity, 20u);
+}
+
+TEST_P(MatchingEngineTest, TradeBufferOverflowStillExecutes) {
+    for (int i = 0; i < 3; ++i) {
+        book.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 10);
+    }
+
+    Trade storage[2];
+    TradeBuffer trades(storage, 2);
+    auto ack = book.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 30, trades);
+
+    EXPECT_EQ(ack.status, OrderStatus::Filled);
+    EXPECT_EQ(ack.trade_count, 3u);
+    EXPECT_EQ(trades.size, 2u);
+    EXPECT_EQ(trades.dropped, 1u);
+    EXPECT_EQ(book.total_orders(), 0u);
+
+    trades.clear();
+    EXPECT_EQ(trades.size, 0u);
+    EXPECT_EQ(trades.dropped, 0u);
+}
+
 // --- Trade Callback ---
 
-TEST_F(MatchingEngineTest, TradeCallbackFires) {
+TEST_P(MatchingEngineTest, TradeCallbackFires) {
     std::vector<Trade> recorded_trades;
     book.set_trade_callback([&](const Trade& t) {
         recorded_trades.push_back(t);
@@ -183,7 +334,7 @@ TEST_F(MatchingEngineTest, TradeCallbackFires) {
 
 // --- Statistics ---
 
-TEST_F(MatchingEngineTest, TradeCountAndVolume) {
+TEST_P(MatchingEngineTest, TradeCountAndVolume) {
     book.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 100);
     book.add_order(Side::Sell, OrderType::Limit, to_price(101.00), 200);
 
@@ -195,7 +346,7 @@ TEST_F(MatchingEngineTest, TradeCountAndVolume) {
 
 // --- Stress: Multiple Orders at Same Price ---
 
-TEST_F(MatchingEngineTest, MultipleOrdersSamePriceFIFO) {
+TEST_P(MatchingEngineTest, MultipleOrdersSamePriceFIFO) {
     std::vector<OrderId> sell_ids;
     for (int i = 0; i < 5; ++i) {
         auto r = book.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 10);
@@ -217,16 +368,27 @@ TEST_F(MatchingEngineTest, MultipleOrdersSamePriceFIFO) {
     EXPECT_EQ(book.volume_at_price(Side::Sell, to_price(100.00)), 25u);
 }
 
+TEST_P(MatchingEngineTest, CancelAfterPartialFillUpdatesLevel) {
+    auto r1 = book.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 100);
+    book.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 100);
+    book.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 40);
+
+    EXPECT_EQ(book.volume_at_price(Side::Sell, to_price(100.00)), 160u);
+    EXPECT_TRUE(book.cancel_order(r1.order_id));
+    EXPECT_EQ(book.volume_at_price(Side::Sell, to_price(100.00)), 100u);
+    EXPECT_EQ(book.order_count_at_price(Side::Sell, to_price(100.00)), 1u);
+}
+
 // --- Edge Cases ---
 
-TEST_F(MatchingEngineTest, ZeroQuantityEdge) {
+TEST_P(MatchingEngineTest, ZeroQuantityEdge) {
     // Should place a resting order with 0 remaining...
     // In a real system you'd reject this, but testing the edge
     auto result = book.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 100);
     EXPECT_EQ(result.status, OrderStatus::Active);
 }
 
-TEST_F(MatchingEngineTest, BidAskUpdateAfterTrade) {
+TEST_P(MatchingEngineTest, BidAskUpdateAfterTrade) {
     book.add_order(Side::Buy, OrderType::Limit, to_price(99.00), 100);
     book.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 100);
     book.add_order(Side::Sell, OrderType::Limit, to_price(101.00), 100);
@@ -237,3 +399,7 @@ TEST_F(MatchingEngineTest, BidAskUpdateAfterTrade) {
     book.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 100);
     EXPECT_EQ(book.best_bid(), to_price(99.00));
 }
+
+INSTANTIATE_TEST_SUITE_P(LevelStorage, MatchingEngineTest,
+                         ::testing::Values(LevelStorage::Map, LevelStorage::Ladder),
+                         level_storage_name);
@@ -1,16 +1,22 @@
 #include <gtest/gtest.h>
 #include "lob/order_book.hpp"
+#include "test_config.hpp"
+
+#include <memory>
+#include <random>
+#include <vector>
 
 using namespace lob;
 
-class OrderBookTest : public ::testing::Test {
+// Every test runs against both map- and ladder-backed books
+class OrderBookTest : public ::testing::TestWithParam<LevelStorage> {
 protected:
-    OrderBook book{10000};
+    OrderBook book{test_book_config(GetParam())};
 };
 
 // --- Basic Order Placement ---
 
-TEST_F(OrderBookTest, AddBuyLimitOrder) {
+TEST_P(OrderBookTest, AddBuyLimitOrder) {
     auto result = book.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 50);
     EXPECT_EQ(result.status, OrderStatus::Active);
     EXPECT_EQ(result.remaining_quantity, 50u);
@@ -19,14 +25,14 @@ TEST_F(OrderBookTest, AddBuyLimitOrder) {
     EXPECT_EQ(book.bid_levels(), 1u);
 }
 
-TEST_F(OrderBookTest, AddSellLimitOrder) {
+TEST_P(OrderBookTest, AddSellLimitOrder) {
     auto result = book.add_order(Side::Sell, OrderType::Limit, to_price(101.00), 30);
     EXPECT_EQ(result.status, OrderStatus::Active);
     EXPECT_EQ(book.total_orders(), 1u);
     EXPECT_EQ(book.ask_levels(), 1u);
 }
 
-TEST_F(OrderBookTest, MultipleBidLevels) {
+TEST_P(OrderBookTest, MultipleBidLevels) {
     book.add_order(Side::Buy, OrderType::Limit, to_price(99.00), 100);
     book.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 200);
     book.add_order(Side::Buy, OrderType::Limit, to_price(98.00), 150);
@@ -35,7 +41,7 @@ TEST_F(OrderBookTest, MultipleBidLevels) {
     EXPECT_EQ(book.best_bid(), to_price(100.00));
 }
 
-TEST_F(OrderBookTest, MultipleAskLevels) {
+TEST_P(OrderBookTest, MultipleAskLevels) {
     book.add_order(Side::Sell, OrderType::Limit, to_price(101.00), 100);
     book.add_order(Side::Sell, OrderType::Limit, to_price(102.00), 200);
     book.add_order(Side::Sell, OrderType::Limit, to_price(100.50), 150);
@@ -46,20 +52,20 @@ TEST_F(OrderBookTest, MultipleAskLevels) {
 
 // --- Market Data Queries ---
 
-TEST_F(OrderBookTest, SpreadCalculation) {
+TEST_P(OrderBookTest, SpreadCalculation) {
     book.add_order(Side::Buy, OrderType::Limit, to_price(99.50), 100);
     book.add_order(Side::Sell, OrderType::Limit, to_price(100.50), 100);
 
     EXPECT_EQ(book.spread(), to_price(1.00));
 }
 
-TEST_F(OrderBookTest, EmptyBookReturnsInvalidPrice) {
+TEST_P(OrderBookTest, EmptyBookReturnsInvalidPrice) {
     EXPECT_EQ(book.best_bid(), INVALID_PRICE);
     EXPECT_EQ(book.best_ask(), INVALID_PRICE);
     EXPECT_EQ(book.spread(), INVALID_PRICE);
 }
 
-TEST_F(OrderBookTest, VolumeAtPrice) {
+TEST_P(OrderBookTest, VolumeAtPrice) {
     book.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 100);
     book.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 200);
 
@@ -67,7 +73,7 @@ TEST_F(OrderBookTest, VolumeAtPrice) {
     EXPECT_EQ(book.volume_at_price(Side::Buy, to_price(99.00)), 0u);
 }
 
-TEST_F(OrderBookTest, OrderCountAtPrice) {
+TEST_P(OrderBookTest, OrderCountAtPrice) {
     book.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 100);
     book.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 200);
     book.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 50);
@@ -75,7 +81,7 @@ TEST_F(OrderBookTest, OrderCountAtPrice) {
     EXPECT_EQ(book.order_count_at_price(Side::Buy, to_price(100.00)), 3u);
 }
 
-TEST_F(OrderBookTest, DepthSnapshot) {
+TEST_P(OrderBookTest, DepthSnapshot) {
     book.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 100);
     book.add_order(Side::Buy, OrderType::Limit, to_price(99.00), 200);
     book.add_order(Side::Buy, OrderType::Limit, to_price(98.00), 300);
@@ -90,7 +96,7 @@ TEST_F(OrderBookTest, DepthSnapshot) {
 
 // --- Cancel and Modify ---
 
-TEST_F(OrderBookTest, CancelOrder) {
+TEST_P(OrderBookTest, CancelOrder) {
     auto result = book.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 100);
     EXPECT_EQ(book.total_orders(), 1u);
 
@@ -100,22 +106,592 @@ TEST_F(OrderBookTest, CancelOrder) {
     EXPECT_EQ(book.bid_levels(), 0u);
 }
 
-TEST_F(OrderBookTest, CancelNonExistentOrder) {
+TEST_P(OrderBookTest, CancelNonExistentOrder) {
     bool cancelled = book.cancel_order(99999);
     EXPECT_FALSE(cancelled);
 }
 
-TEST_F(OrderBookTest, ModifyReduceQuantity) {
+TEST_P(OrderBookTest, ModifyReduceQuantity) {
     auto result = book.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 500);
     bool modified = book.modify_order(result.order_id, 300);
     EXPECT_TRUE(modified);
     EXPECT_EQ(book.volume_at_price(Side::Buy, to_price(100.00)), 300u);
 }
 
-TEST_F(OrderBookTest, CancelRemovesPriceLevel) {
+TEST_P(OrderBookTest, CancelRemovesPriceLevel) {
     auto r1 = book.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 100);
     EXPECT_EQ(book.bid_levels(), 1u);
 
     book.cancel_order(r1.order_id);
     EXPECT_EQ(book.bid_levels(), 0u);
 }
+
+TEST_P(OrderBookTest, ExhaustedPoolRejects) {
+    BookConfig config = test_book_config(GetParam());
+    config.pool.capacity = 2;
+    OrderBook small(config);
+
+    small.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 10);
+    small.add_order(Side::Buy, OrderType::Limit, to_price(99.00), 10);
+    auto r = small.add_order(Side::Buy, OrderType::Limit, to_price(98.00), 10);
+
+    EXPECT_EQ(r.status, OrderStatus::Rejected);
+    EXPECT_EQ(r.reject_reason, RejectReason::PoolExhausted);
+    EXPECT_EQ(small.total_orders(), 2u);
+}
+
+TEST_P(OrderBookTest, GrowablePoolKeepsAccepting) {
+    BookConfig config = test_book_config(GetParam());
+    config.pool.capacity = 8;
+    config.pool.max_capacity = 64;
+    config.pool.slab_size = 8;
+    OrderBook growing(config);
+
+    std::vector<OrderId> ids;
+    for (int i = 0; i < 64; ++i) {
+        auto r = growing.add_order(Side::Sell, OrderType::Limit, to_price(100.00) + i, 10);
+        ASSERT_EQ(r.status, OrderStatus::Active);
+        ids.push_back(r.order_id);
+    }
+    EXPECT_EQ(growing.total_orders(), 64u);
+    EXPECT_EQ(growing.pool().slab_count(), 8u);
+
+    // Orders placed before growth are still reachable through the index
+    EXPECT_TRUE(growing.cancel_order(ids.front()));
+    EXPECT_EQ(growing.best_ask(), to_price(100.00) + 1);
+}
+
+TEST_P(OrderBookTest, WarmUpLeavesBookUsable) {
+    BookConfig config = test_book_config(GetParam());
+    config.pool.pages.numa_node = 0;
+    config.warm_up = true;
+    OrderBook warm(config);
+    EXPECT_TRUE(warm.empty());
+
+    auto resting = warm.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 100);
+    warm.warm_up();  // safe on a live book: contents are untouched
+    EXPECT_EQ(warm.best_bid(), to_price(100.00));
+    EXPECT_EQ(warm.volume_at_price(Side::Buy, to_price(100.00)), 100u);
+
+    auto hit = warm.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 40);
+    EXPECT_EQ(hit.status, OrderStatus::Filled);
+    EXPECT_TRUE(warm.cancel_order(resting.order_id));
+    EXPECT_TRUE(warm.empty());
+}
+
+TEST_P(OrderBookTest, BatchApisMatchSequentialCalls) {
+    OrderBook batched(test_book_config(GetParam()));
+    OrderBook sequential(test_book_config(GetParam()));
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<Price> price_dist(to_price(99.00), to_price(101.00));
+    std::uniform_int_distribution<Quantity> qty_dist(1, 100);
+    std::vector<OrderRequest> requests;
+    for (int i = 0; i < 200; ++i) {
+        Side side = (i % 2 == 0) ? Side::Buy : Side::Sell;
+        OrderType type = (i % 17 == 0) ? OrderType::Market : OrderType::Limit;
+        requests.push_back({side, type, price_dist(rng), qty_dist(rng)});
+    }
+    requests[5].price = to_price(500.00);  // out of band when ladder-backed
+
+    std::vector<OrderAck> acks(requests.size());
+    std::vector<Trade> storage(1000);
+    TradeBuffer trades(storage.data(), storage.size());
+    batched.add_orders(requests.data(), requests.size(), acks.data(), trades);
+
+    std::vector<Trade> expected_trades;
+    std::vector<OrderId> ids;
+    for (std::size_t i = 0; i < requests.size(); ++i) {
+        const OrderRequest& r = requests[i];
+        auto result = sequential.add_order(r.side, r.type, r.price, r.quantity);
+        EXPECT_EQ(acks[i].order_id, result.order_id);
+        EXPECT_EQ(acks[i].status, result.status);
+        EXPECT_EQ(acks[i].filled_quantity, result.filled_quantity);
+        EXPECT_EQ(acks[i].reject_reason, result.reject_reason);
+        EXPECT_EQ(acks[i].trade_count, result.trades.size());
+        expected_trades.insert(expected_trades.end(), result.trades.begin(), result.trades.end());
+        if (result.order_id != 0) ids.push_back(result.order_id);
+    }
+    ASSERT_EQ(trades.size, expected_trades.size());
+    for (std::size_t i = 0; i < trades.size; ++i) {
+        EXPECT_EQ(trades.data[i].buy_order_id, expected_trades[i].buy_order_id);
+        EXPECT_EQ(trades.data[i].sell_order_id, expected_trades[i].sell_order_id);
+        EXPECT_EQ(trades.data[i].quantity, expected_trades[i].quantity);
+    }
+
+    // Cancel every other ID, including ones already filled, plus an unknown ID
+    std::vector<OrderId> cancels;
+    for (std::size_t i = 0; i < ids.size(); i += 2) cancels.push_back(ids[i]);
+    cancels.push_back(999999);
+    std::unique_ptr<bool[]> results(new bool[cancels.size()]);
+    std::size_t cancelled = batched.cancel_orders(cancels.data(), cancels.size(), results.get());
+
+    std::size_t expected_cancelled = 0;
+    for (std::size_t i = 0; i < cancels.size(); ++i) {
+        bool ok = sequential.cancel_order(cancels[i]);
+        EXPECT_EQ(results[i], ok);
+        expected_cancelled += ok ? 1 : 0;
+    }
+    EXPECT_EQ(cancelled, expected_cancelled);
+    EXPECT_FALSE(results[cancels.size() - 1]);
+
+    EXPECT_EQ(batched.total_orders(), sequential.total_orders());
+    EXPECT_EQ(batched.bid_depth(100), sequential.bid_depth(100));
+    EXPECT_EQ(batched.ask_depth(100), sequential.ask_depth(100));
+}
+
+TEST_P(OrderBookTest, DepthIntoCallerArray) {
+    book.add_order(Side::Buy, OrderType::Limit, to_price(99.00), 10);
+    book.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 20);
+    book.add_order(Side::Buy, OrderType::Limit, to_price(98.00), 30);
+    book.add_order(Side::Sell, OrderType::Limit, to_price(101.00), 40);
+
+    std::pair<Price, Quantity> out[2];
+    ASSERT_EQ(book.bid_depth(out, 2), 2u);
+    EXPECT_EQ(out[0], std::make_pair(to_price(100.00), Quantity{20}));
+    EXPECT_EQ(out[1], std::make_pair(to_price(99.00), Quantity{10}));
+
+    ASSERT_EQ(book.ask_depth(out, 2), 1u);
+    EXPECT_EQ(out[0], std::make_pair(to_price(101.00), Quantity{40}));
+}
+
+// --- Cancel / Replace ---
+
+TEST_P(OrderBookTest, ReplaceKeepsIdAndRequeues) {
+    auto a = book.add_order(Side::Buy, OrderType::Limit, to_price(99.00), 10);
+    auto b = book.add_order(Side::Buy, OrderType::Limit, to_price(98.00), 10);
+    std::size_t pool_used = book.pool().size();
+
+    // Move a behind b at 98.00 with a larger size
+    auto moved = book.replace_order(a.order_id, to_price(98.00), 30);
+    EXPECT_EQ(moved.order_id, a.order_id);
+    EXPECT_EQ(moved.status, OrderStatus::Active);
+    EXPECT_EQ(moved.remaining_quantity, 30u);
+    EXPECT_EQ(book.pool().size(), pool_used);
+    EXPECT_EQ(book.bid_levels(), 1u);
+    EXPECT_EQ(book.volume_at_price(Side::Buy, to_price(98.00)), 40u);
+
+    auto hit = book.add_order(Side::Sell, OrderType::Market, 0, 15);
+    ASSERT_EQ(hit.trades.size(), 2u);
+    EXPECT_EQ(hit.trades[0].buy_order_id, b.order_id);  // b kept priority
+    EXPECT_EQ(hit.trades[1].buy_order_id, a.order_id);
+    EXPECT_TRUE(book.cancel_order(a.order_id));
+    EXPECT_TRUE(book.empty());
+}
+
+TEST_P(OrderBookTest, ReplaceAcrossSpreadMatchesFirst) {
+    auto bid = book.add_order(Side::Buy, OrderType::Limit, to_price(99.00), 50);
+    book.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 20);
+    book.add_order(Side::Sell, OrderType::Limit, to_price(101.00), 20);
+
+    std::vector<Trade> storage(8);
+    TradeBuffer trades(storage.data(), storage.size());
+    OrderAck ack = book.replace_order(bid.order_id, to_price(100.00), 50, trades);
+    EXPECT_EQ(ack.order_id, bid.order_id);
+    EXPECT_EQ(ack.status, OrderStatus::PartiallyFilled);
+    EXPECT_EQ(ack.filled_quantity, 20u);
+    EXPECT_EQ(ack.remaining_quantity, 30u);
+    ASSERT_EQ(ack.trade_count, 1u);
+    EXPECT_EQ(trades.data[0].buy_order_id, bid.order_id);
+    EXPECT_EQ(book.best_bid(), to_price(100.00));
+    EXPECT_EQ(book.best_ask(), to_price(101.00));
+
+    // Crossing for everything left fills it and retires the ID
+    auto filled = book.replace_order(bid.order_id, to_price(101.00), 40);
+    EXPECT_EQ(filled.status, OrderStatus::Filled);
+    EXPECT_EQ(filled.filled_quantity, 20u);
+    EXPECT_FALSE(book.cancel_order(bid.order_id));
+    EXPECT_EQ(book.total_orders(), 0u);
+}
+
+TEST_P(OrderBookTest, ReplaceEdgeCases) {
+    auto a = book.add_order(Side::Sell, OrderType::Limit, to_price(101.00), 10);
+    auto b = book.add_order(Side::Sell, OrderType::Limit, to_price(101.00), 10);
+
+    // Same-price reduce keeps priority
+    auto reduced = book.replace_order(a.order_id, to_price(101.00), 4);
+    EXPECT_EQ(reduced.status, OrderStatus::Active);
+    EXPECT_EQ(reduced.remaining_quantity, 4u);
+    auto hit = book.add_order(Side::Buy, OrderType::Limit, to_price(101.00), 2);
+    EXPECT_EQ(hit.trades[0].sell_order_id, a.order_id);
+
+    // At or below the filled amount cancels
+    auto gone = book.replace_order(a.order_id, to_price(102.00), 2);
+    EXPECT_EQ(gone.status, OrderStatus::Cancelled);
+    EXPECT_FALSE(book.cancel_order(a.order_id));
+
+    auto unknown = book.replace_order(a.order_id, to_price(101.00), 10);
+    EXPECT_EQ(unknown.status, OrderStatus::Rejected);
+    EXPECT_EQ(unknown.reject_reason, RejectReason::UnknownOrder);
+
+    if (GetParam() == LevelStorage::Ladder) {
+        auto outside = book.replace_order(b.order_id, to_price(200.00), 10);
+        EXPECT_EQ(outside.status, OrderStatus::Rejected);
+        EXPECT_EQ(outside.reject_reason, RejectReason::PriceOutOfBand);
+        EXPECT_EQ(book.volume_at_price(Side::Sell, to_price(101.00)), 10u);  // untouched
+    }
+}
+
+TEST_P(OrderBookTest, ModifyIncreaseKeepsId) {
+    auto a = book.add_order(Side::Buy, OrderType::Limit, to_price(99.00), 10);
+    auto b = book.add_order(Side::Buy, OrderType::Limit, to_price(99.00), 10);
+    ASSERT_TRUE(book.modify_order(a.order_id, 25));
+    EXPECT_EQ(book.volume_at_price(Side::Buy, to_price(99.00)), 35u);
+
+    auto hit = book.add_order(Side::Sell, OrderType::Market, 0, 12);
+    EXPECT_EQ(hit.trades[0].buy_order_id, b.order_id);  // increase lost priority
+    EXPECT_EQ(hit.trades[1].buy_order_id, a.order_id);
+    EXPECT_TRUE(book.cancel_order(a.order_id));
+}
+
+// --- Pre-trade Estimates ---
+
+TEST_P(OrderBookTest, CostToFillWalksLevels) {
+    book.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 10);
+    book.add_order(Side::Sell, OrderType::Limit, to_price(100.05), 20);
+    book.add_order(Side::Sell, OrderType::Limit, to_price(101.00), 30);
+    book.add_order(Side::Buy, OrderType::Limit, to_price(99.00), 5);
+
+    auto part = book.cost_to_fill(Side::Buy, 25);
+    EXPECT_EQ(part.filled, 25u);
+    EXPECT_EQ(part.cost, 10u * to_price(100.00) + 15u * to_price(100.05));
+    EXPECT_EQ(part.worst_price, to_price(100.05));
+    EXPECT_EQ(part.levels, 2u);
+    EXPECT_DOUBLE_EQ(book.price_for_quantity(Side::Buy, 25),
+                     static_cast<double>(part.cost) / 25.0);
+
+    auto all = book.cost_to_fill(Side::Buy, 1000);  // more than the side holds
+    EXPECT_EQ(all.filled, 60u);
+    EXPECT_EQ(all.worst_price, to_price(101.00));
+    EXPECT_EQ(all.levels, 3u);
+
+    auto sell = book.cost_to_fill(Side::Sell, 5);
+    EXPECT_EQ(sell.cost, 5u * to_price(99.00));
+    EXPECT_EQ(book.total_orders(), 4u);  // nothing was touched
+
+    book.add_order(Side::Sell, OrderType::Market, 0, 5);
+    auto none = book.cost_to_fill(Side::Sell, 5);
+    EXPECT_EQ(none.filled, 0u);
+    EXPECT_EQ(none.worst_price, INVALID_PRICE);
+    EXPECT_EQ(book.price_for_quantity(Side::Sell, 5), 0.0);
+    EXPECT_EQ(book.cost_to_fill(Side::Buy, 0).levels, 0u);
+
+    // Levels at both ends of the ladder band
+    book.add_order(Side::Sell, OrderType::Limit, to_price(150.00), 7);
+    book.add_order(Side::Buy, OrderType::Limit, to_price(50.00), 3);
+    book.add_order(Side::Buy, OrderType::Limit, to_price(50.01), 3);
+    EXPECT_EQ(book.cost_to_fill(Side::Buy, 67).worst_price, to_price(150.00));
+    EXPECT_EQ(book.cost_to_fill(Side::Buy, 99).filled, 67u);
+    auto bids = book.cost_to_fill(Side::Sell, 10);
+    EXPECT_EQ(bids.filled, 6u);
+    EXPECT_EQ(bids.cost, 3u * to_price(50.00) + 3u * to_price(50.01));
+    EXPECT_EQ(bids.worst_price, to_price(50.00));
+}
+
+TEST_P(OrderBookTest, CostToFillMatchesDepthWalk) {
+    std::mt19937_64 rng(7);
+    std::vector<OrderId> live;
+    for (int i = 0; i < 3000; ++i) {
+        std::uint64_t roll = rng() % 10;
+        if (roll < 2 && !live.empty()) {
+            std::size_t k = rng() % live.size();
+            book.cancel_order(live[k]);
+            live[k] = live.back();
+            live.pop_back();
+            continue;
+        }
+        // Sparse levels on both sides of 100.00, with occasional crossing
+        Side side = rng() % 2 ? Side::Buy : Side::Sell;
+        Price offset = to_price(0.01) * (rng() % 400);
+        Price price = side == Side::Buy ? to_price(99.50) - offset : to_price(100.50) + offset;
+        if (roll == 9) price = side == Side::Buy ? to_price(101.00) : to_price(99.00);
+        auto r = book.add_order(side, OrderType::Limit, price, 1 + rng() % 50);
+        if (r.remaining_quantity > 0) live.push_back(r.order_id);
+    }
+
+    for (Side side : {Side::Buy, Side::Sell}) {
+        auto depth = side == Side::Buy ? book.ask_depth(100000) : book.bid_depth(100000);
+        for (Quantity qty : {1u, 7u, 60u, 500u, 5000u, 100000u, 10000000u}) {
+            FillEstimate expected;
+            for (const auto& [price, size] : depth) {
+                if (expected.filled == qty) break;
+                Quantity take = std::min(size, qty - expected.filled);
+                expected.filled += take;
+                expected.cost += take * price;
+                expected.worst_price = price;
+                ++expected.levels;
+            }
+            auto got = book.cost_to_fill(side, qty);
+            EXPECT_EQ(got.filled, expected.filled) << qty;
+            EXPECT_EQ(got.cost, expected.cost) << qty;
+            EXPECT_EQ(got.worst_price, expected.worst_price) << qty;
+            EXPECT_EQ(got.levels, expected.levels) << qty;
+        }
+    }
+}
+
+// --- Lazy Cancel ---
+
+TEST_P(OrderBookTest, LazyCancelLeavesTombstone) {
+    BookConfig config = test_book_config(GetParam());
+    config.lazy_cancel = true;
+    OrderBook lazy(config);
+    auto a = lazy.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 10);
+    auto b = lazy.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 20);
+    auto c = lazy.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 30);
+
+    EXPECT_TRUE(lazy.cancel_order(b.order_id));
+    EXPECT_FALSE(lazy.cancel_order(b.order_id));
+    EXPECT_EQ(lazy.tombstones(), 1u);
+    EXPECT_EQ(lazy.total_orders(), 2u);
+    EXPECT_EQ(lazy.volume_at_price(Side::Sell, to_price(100.00)), 40u);
+    EXPECT_EQ(lazy.order_count_at_price(Side::Sell, to_price(100.00)), 2u);
+    EXPECT_EQ(lazy.ask_top()[0].quantity, 40u);
+
+    // Matching steps over the tombstone and frees it
+    auto r = lazy.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 35);
+    ASSERT_EQ(r.trades.size(), 2u);
+    EXPECT_EQ(r.trades[0].sell_order_id, a.order_id);
+    EXPECT_EQ(r.trades[1].sell_order_id, c.order_id);
+    EXPECT_EQ(r.trades[1].quantity, 25u);
+    EXPECT_EQ(lazy.tombstones(), 0u);
+    EXPECT_EQ(lazy.volume_at_price(Side::Sell, to_price(100.00)), 5u);
+}
+
+TEST_P(OrderBookTest, LazyCancelOfLastLiveOrderDropsLevel) {
+    BookConfig config = test_book_config(GetParam());
+    config.lazy_cancel = true;
+    OrderBook lazy(config);
+    auto a = lazy.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 10);
+    auto b = lazy.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 10);
+    lazy.add_order(Side::Buy, OrderType::Limit, to_price(99.00), 10);
+
+    EXPECT_TRUE(lazy.cancel_order(a.order_id));
+    EXPECT_EQ(lazy.tombstones(), 1u);
+    EXPECT_TRUE(lazy.cancel_order(b.order_id));
+    EXPECT_EQ(lazy.tombstones(), 0u);
+    EXPECT_EQ(lazy.best_bid(), to_price(99.00));
+    EXPECT_EQ(lazy.bid_levels(), 1u);
+}
+
+TEST_P(OrderBookTest, LazyCancelCompactsWhenPoolRunsOut) {
+    BookConfig config = test_book_config(GetParam());
+    config.lazy_cancel = true;
+    config.pool.capacity = 4;
+    OrderBook lazy(config);
+    std::vector<OrderId> ids;
+    for (int i = 0; i < 4; ++i) {
+        ids.push_back(lazy.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 10).order_id);
+    }
+    lazy.cancel_order(ids[0]);
+    lazy.cancel_order(ids[2]);
+    EXPECT_EQ(lazy.tombstones(), 2u);
+    EXPECT_EQ(lazy.compact(), 2u);
+    EXPECT_EQ(lazy.compact(), 0u);
+
+    lazy.cancel_order(ids[1]);
+    auto r = lazy.add_order(Side::Sell, OrderType::Limit, to_price(101.00), 10);
+    auto s = lazy.add_order(Side::Sell, OrderType::Limit, to_price(102.00), 10);
+    auto t = lazy.add_order(Side::Sell, OrderType::Limit, to_price(103.00), 10);
+    EXPECT_EQ(r.status, OrderStatus::Active);
+    EXPECT_EQ(s.status, OrderStatus::Active);
+    EXPECT_EQ(t.status, OrderStatus::Active);  // took the tombstone's slot
+    EXPECT_EQ(lazy.tombstones(), 0u);
+    auto u = lazy.add_order(Side::Sell, OrderType::Limit, to_price(104.00), 10);
+    EXPECT_EQ(u.reject_reason, RejectReason::PoolExhausted);
+
+    // Snapshots carry live orders only
+    std::vector<char> image(lazy.snapshot_size());
+    ASSERT_EQ(lazy.snapshot(image.data(), image.size()), image.size());
+    OrderBook copy(test_book_config(GetParam()));
+    ASSERT_TRUE(copy.restore(image.data(), image.size()));
+    EXPECT_EQ(copy.total_orders(), 4u);
+}
+
+TEST_P(OrderBookTest, LazyCancelMatchesEagerCancel) {
+    BookConfig config = test_book_config(GetParam());
+    OrderBook eager(config);
+    config.lazy_cancel = true;
+    OrderBook lazy(config);
+
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<Price> price_dist(to_price(99.00), to_price(101.00));
+    std::vector<OrderId> ids;
+    std::size_t trades = 0;
+    for (int i = 0; i < 5000; ++i) {
+        auto roll = rng() % 10;
+        if (roll < 5 || ids.empty()) {
+            Side side = rng() % 2 ? Side::Buy : Side::Sell;
+            Price price = price_dist(rng);
+            Quantity qty = 1 + rng() % 100;
+            auto e = eager.add_order(side, OrderType::Limit, price, qty);
+            auto l = lazy.add_order(side, OrderType::Limit, price, qty);
+            ASSERT_EQ(e.trades.size(), l.trades.size());
+            for (std::size_t k = 0; k < e.trades.size(); ++k) {
+                EXPECT_EQ(e.trades[k].buy_order_id, l.trades[k].buy_order_id);
+                EXPECT_EQ(e.trades[k].sell_order_id, l.trades[k].sell_order_id);
+                EXPECT_EQ(e.trades[k].quantity, l.trades[k].quantity);
+            }
+            trades += e.trades.size();
+            ids.push_back(e.order_id);
+        } else if (roll < 9) {
+            OrderId id = ids[rng() % ids.size()];
+            EXPECT_EQ(eager.cancel_order(id), lazy.cancel_order(id));
+        } else {
+            OrderId id = ids[rng() % ids.size()];
+            Price price = price_dist(rng);
+            EXPECT_EQ(eager.replace_order(id, price, 50).trades.size(),
+                      lazy.replace_order(id, price, 50).trades.size());
+        }
+        if (i % 1000 == 999) lazy.compact();
+    }
+    EXPECT_GT(trades, 0u);
+    EXPECT_EQ(eager.total_orders(), lazy.total_orders());
+    EXPECT_EQ(eager.total_volume(), lazy.total_volume());
+    EXPECT_EQ(eager.bid_depth(1000), lazy.bid_depth(1000));
+    EXPECT_EQ(eager.ask_depth(1000), lazy.ask_depth(1000));
+}
+
+// --- Introspection ---
+
+TEST_P(OrderBookTest, OccupancyStatsDescribeQueues) {
+    for (int i = 0; i < 5; ++i) book.add_order(Side::Buy, OrderType::Limit, to_price(99.00), 10);
+    book.add_order(Side::Buy, OrderType::Limit, to_price(98.50), 10);
+    for (int i = 0; i < 2; ++i) book.add_order(Side::Sell, OrderType::Limit, to_price(101.00), 10);
+    auto gone = book.add_order(Side::Sell, OrderType::Limit, to_price(102.00), 10);
+    book.cancel_order(gone.order_id);
+
+    OccupancyStats stats = book.occupancy_stats();
+    EXPECT_EQ(stats.orders, 8u);
+    EXPECT_EQ(stats.pool_high_water, 9u);
+    EXPECT_EQ(stats.pool_capacity, 10000u);
+    EXPECT_EQ(stats.bid_levels, 2u);
+    EXPECT_EQ(stats.ask_levels, 1u);
+    EXPECT_EQ(stats.max_queue_depth, 5u);
+    EXPECT_DOUBLE_EQ(stats.mean_queue_depth, 8.0 / 3.0);
+    EXPECT_EQ(stats.queue_depth[0], 1u);  // 1 order
+    EXPECT_EQ(stats.queue_depth[1], 1u);  // 2-3
+    EXPECT_EQ(stats.queue_depth[2], 1u);  // 4-7
+    EXPECT_EQ(stats.bid_low, to_price(98.50));
+    EXPECT_EQ(stats.bid_high, to_price(99.00));
+    EXPECT_EQ(stats.ask_low, to_price(101.00));
+    EXPECT_EQ(stats.ask_high, to_price(101.00));
+    EXPECT_GT(stats.index_load, 0.0);
+    EXPECT_GE(stats.mean_probe, 1.0);
+    EXPECT_EQ(stats.ladder_ticks, GetParam() == LevelStorage::Ladder ? 10001u : 0u);
+
+    BookMemoryStats memory = book.memory_stats();
+    EXPECT_GE(memory.pool, 10000 * (sizeof(Order) + sizeof(OrderInfo)));
+    EXPECT_GE(memory.index, stats.index_slots * (sizeof(OrderId) + sizeof(OrderHandle)));
+    EXPECT_GT(memory.bid_levels, 0u);
+    EXPECT_EQ(memory.total(),
+              memory.pool + memory.index + memory.bid_levels + memory.ask_levels + memory.book);
+}
+
+TEST_P(OrderBookTest, OccupancyOfEmptyBook) {
+    OccupancyStats stats = book.occupancy_stats();
+    EXPECT_EQ(stats.orders, 0u);
+    EXPECT_EQ(stats.pool_high_water, 0u);
+    EXPECT_EQ(stats.max_queue_depth, 0u);
+    EXPECT_EQ(stats.mean_queue_depth, 0.0);
+    EXPECT_EQ(stats.bid_low, INVALID_PRICE);
+    EXPECT_EQ(stats.ask_high, INVALID_PRICE);
+    if (GetParam() == LevelStorage::Map) {
+        EXPECT_EQ(book.memory_stats().bid_levels, 0u);
+    }
+}
+
+// --- Reset ---
+
+TEST_P(OrderBookTest, ResetReturnsToFreshBook) {
+    BookConfig config = test_book_config(GetParam());
+    config.lazy_cancel = true;
+    OrderBook used(config);
+    OrderBook fresh(config);
+    auto drive = [](OrderBook& b) {
+        std::vector<OrderId> ids;
+        for (int i = 0; i < 50; ++i) {
+            Side side = i % 2 ? Side::Buy : Side::Sell;
+            ids.push_back(b.add_order(side, OrderType::Limit, to_price(99.50 + (i % 7) * 0.25),
+                                      static_cast<Quantity>(10 + i))
+                              .order_id);
+        }
+        for (std::size_t i = 0; i < ids.size(); i += 3) b.cancel_order(ids[i]);
+        b.begin_auction();
+        b.add_order(Side::Sell, OrderType::Limit, to_price(99.00), 40);
+    };
+    drive(used);
+    EXPECT_GT(used.tombstones(), 0u);
+    used.reset();
+
+    EXPECT_EQ(used.total_orders(), 0u);
+    EXPECT_EQ(used.tombstones(), 0u);
+    EXPECT_EQ(used.total_trades(), 0u);
+    EXPECT_EQ(used.total_volume(), 0u);
+    EXPECT_EQ(used.bid_levels(), 0u);
+    EXPECT_EQ(used.ask_levels(), 0u);
+    EXPECT_EQ(used.best_bid(), INVALID_PRICE);
+    EXPECT_EQ(used.bid_top().size(), 0u);
+    EXPECT_EQ(used.phase(), TradingPhase::Continuous);
+    EXPECT_EQ(used.occupancy_stats().index_load, 0.0);
+
+    // Driven again, it is indistinguishable from a new book
+    drive(used);
+    drive(fresh);
+    used.uncross();
+    fresh.uncross();
+    auto a = used.add_order(Side::Buy, OrderType::Market, 0, 300);
+    auto b = fresh.add_order(Side::Buy, OrderType::Market, 0, 300);
+    EXPECT_EQ(a.order_id, b.order_id);
+    EXPECT_EQ(a.filled_quantity, b.filled_quantity);
+    EXPECT_EQ(used.total_trades(), fresh.total_trades());
+    EXPECT_EQ(used.bid_depth(100), fresh.bid_depth(100));
+    EXPECT_EQ(used.ask_depth(100), fresh.ask_depth(100));
+}
+
+TEST_P(OrderBookTest, ResetClearsDepthScans) {
+    // Old levels a tick or two above the new ask, inside one ladder scan block
+    for (int i = 1; i <= 5; ++i) {
+        book.add_order(Side::Sell, OrderType::Limit, to_price(95.00) + static_cast<Price>(i), 100);
+    }
+    book.reset();
+    book.add_order(Side::Sell, OrderType::Limit, to_price(95.00), 5);
+
+    // Only the new ask is liquidity: the old levels' totals are gone
+    FillEstimate estimate = book.cost_to_fill(Side::Buy, 10);
+    EXPECT_EQ(estimate.filled, 5u);
+    EXPECT_EQ(estimate.worst_price, to_price(95.00));
+    EXPECT_EQ(estimate.levels, 1u);
+
+    auto fok = book.add_order(Side::Buy, OrderType::FOK, to_price(200.00), 10);
+    EXPECT_EQ(fok.status, OrderStatus::Rejected);
+    EXPECT_EQ(fok.reject_reason, RejectReason::InsufficientLiquidity);
+    EXPECT_TRUE(fok.trades.empty());
+    EXPECT_EQ(book.volume_at_price(Side::Sell, to_price(95.00)), 5u);
+}
+
+TEST_P(OrderBookTest, IdLimitRejectsOnceExhausted) {
+    BookConfig config = test_book_config(GetParam());
+    config.id_base = 100;
+    config.id_limit = 102;
+    OrderBook limited(config);
+    EXPECT_EQ(limited.add_order(Side::Sell, OrderType::Limit, to_price(101.00), 10).order_id, 101u);
+    EXPECT_EQ(limited.add_order(Side::Buy, OrderType::Market, 0, 4).order_id, 102u);
+
+    // Aggressors need an ID too, even though they never rest
+    for (OrderType type : {OrderType::Limit, OrderType::Market}) {
+        auto r = limited.add_order(Side::Buy, type, to_price(101.00), 5);
+        EXPECT_EQ(r.status, OrderStatus::Rejected);
+        EXPECT_EQ(r.reject_reason, RejectReason::IdsExhausted);
+        EXPECT_TRUE(r.trades.empty());
+    }
+    EXPECT_EQ(limited.volume_at_price(Side::Sell, to_price(101.00)), 6u);
+
+    // reset() starts the sequence over
+    limited.reset();
+    EXPECT_EQ(limited.add_order(Side::Buy, OrderType::Limit, to_price(99.00), 1).order_id, 101u);
+}
+
+INSTANTIATE_TEST_SUITE_P(LevelStorage, OrderBookTest,
+                         ::testing::Values(LevelStorage::Map, LevelStorage::Ladder),
+                         level_storage_name);
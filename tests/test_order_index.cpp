@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include "lob/order_index.hpp"
+
+#include <vector>
+#include <algorithm>
+#include <random>
+
+using namespace lob;
+
+TEST(OrderIndexTest, EmptyIndex) {
+    OrderIndex index(100);
+    EXPECT_TRUE(index.empty());
+    EXPECT_EQ(index.capacity(), 100u);
+    EXPECT_GE(index.slot_count(), 200u);
+    EXPECT_EQ(index.find(1), NULL_HANDLE);
+    EXPECT_EQ(index.erase(1), NULL_HANDLE);
+}
+
+TEST(OrderIndexTest, ZeroIdIsNeverPresent) {
+    // 0 is the empty-slot key; it must not match a free slot
+    OrderIndex index(16);
+    EXPECT_EQ(index.find(0), NULL_HANDLE);
+    EXPECT_EQ(index.erase(0), NULL_HANDLE);
+    EXPECT_FALSE(index.insert(0, 3));
+    EXPECT_TRUE(index.empty());
+}
+
+TEST(OrderIndexTest, InsertFindErase) {
+    OrderIndex index(10);
+
+    EXPECT_TRUE(index.insert(1, 10));
+    EXPECT_TRUE(index.insert(2, 20));
+    EXPECT_EQ(index.size(), 2u);
+    EXPECT_EQ(index.find(1), 10u);
+    EXPECT_EQ(index.find(2), 20u);
+
+    EXPECT_EQ(index.erase(1), 10u);
+    EXPECT_EQ(index.find(1), NULL_HANDLE);
+    EXPECT_EQ(index.find(2), 20u);
+    EXPECT_EQ(index.size(), 1u);
+}
+
+TEST(OrderIndexTest, RejectsDuplicateAndOverflow) {
+    OrderIndex index(2);
+
+    EXPECT_TRUE(index.insert(7, 0));
+    EXPECT_FALSE(index.insert(7, 1));
+    EXPECT_TRUE(index.insert(8, 1));
+    EXPECT_FALSE(index.insert(9, 2));  // at capacity
+    EXPECT_EQ(index.size(), 2u);
+}
+
+TEST(OrderIndexTest, RandomChurnMatchesReference) {
+    // Dense IDs with random erase order exercise backward-shift deletion
+    constexpr std::size_t N = 5000;
+    OrderIndex index(N);
+    std::vector<OrderId> live;
+
+    // Handle for ID i is i - 1
+    for (std::size_t i = 0; i < N; ++i) {
+        OrderId id = static_cast<OrderId>(i + 1);
+        ASSERT_TRUE(index.insert(id, static_cast<OrderHandle>(i)));
+        live.push_back(id);
+    }
+
+    std::mt19937 rng(7);
+    std::shuffle(live.begin(), live.end(), rng);
+    std::vector<OrderId> erased(live.begin(), live.begin() + N / 2);
+    live.erase(live.begin(), live.begin() + N / 2);
+
+    for (OrderId id : erased) {
+        ASSERT_EQ(index.erase(id), static_cast<OrderHandle>(id - 1));
+    }
+    for (OrderId id : erased) {
+        EXPECT_EQ(index.find(id), NULL_HANDLE);
+    }
+    for (OrderId id : live) {
+        EXPECT_EQ(index.find(id), static_cast<OrderHandle>(id - 1));
+    }
+    EXPECT_EQ(index.size(), N - N / 2);
+}
+
+TEST(OrderIndexTest, ProbeStatsCoverEveryEntry) {
+    OrderIndex index(1000);
+    EXPECT_EQ(index.probe_stats().max, 0u);
+    for (OrderId id = 1; id <= 1000; ++id) index.insert(id, static_cast<OrderHandle>(id));
+    EXPECT_DOUBLE_EQ(index.load_factor(), 1000.0 / static_cast<double>(index.slot_count()));
+    IndexProbeStats stats = index.probe_stats();
+    EXPECT_GE(stats.mean, 1.0);
+    EXPECT_GE(stats.max, 1u);
+    EXPECT_LE(stats.mean, static_cast<double>(stats.max));
+    // At most half full, linear probing keeps the average short
+    EXPECT_LT(stats.mean, 2.0);
+}
@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 #include "lob/order_pool.hpp"
 
+#include <cstdint>
+#include <vector>
+
 using namespace lob;
 
 TEST(OrderPoolTest, BasicAllocation) {
@@ -9,8 +12,8 @@ TEST(OrderPoolTest, BasicAllocation) {
     EXPECT_EQ(pool.size(), 0u);
     EXPECT_EQ(pool.available(), 100u);
 
-    Order* o = pool.allocate();
-    ASSERT_NE(o, nullptr);
+    OrderHandle h = pool.allocate();
+    ASSERT_NE(h, NULL_HANDLE);
     EXPECT_EQ(pool.size(), 1u);
     EXPECT_EQ(pool.available(), 99u);
 }
@@ -18,8 +21,9 @@ TEST(OrderPoolTest, BasicAllocation) {
 TEST(OrderPoolTest, AllocateAndDeallocate) {
     OrderPool pool(10);
 
-    Order* o1 = pool.allocate();
-    Order* o2 = pool.allocate();
+    OrderHandle o1 = pool.allocate();
+    OrderHandle o2 = pool.allocate();
+    EXPECT_NE(o1, o2);
     EXPECT_EQ(pool.size(), 2u);
 
     pool.deallocate(o1);
@@ -34,10 +38,10 @@ TEST(OrderPoolTest, AllocateAndDeallocate) {
 TEST(OrderPoolTest, ReusesMemory) {
     OrderPool pool(2);
 
-    Order* o1 = pool.allocate();
+    OrderHandle o1 = pool.allocate();
     pool.deallocate(o1);
 
-    Order* o2 = pool.allocate();
+    OrderHandle o2 = pool.allocate();
     // Should reuse the same slot
     EXPECT_EQ(o1, o2);
 }
@@ -50,20 +54,125 @@ TEST(OrderPoolTest, ExhaustsCapacity) {
     pool.allocate();
     EXPECT_EQ(pool.available(), 0u);
 
-    EXPECT_THROW(pool.allocate(), std::runtime_error);
+    EXPECT_EQ(pool.allocate(), NULL_HANDLE);  // error code, no exception
+    EXPECT_EQ(pool.size(), 3u);
 }
 
 TEST(OrderPoolTest, AllocatedOrderIsReset) {
     OrderPool pool(10);
 
-    Order* o = pool.allocate();
-    o->id = 42;
-    o->price = 10000;
-    o->quantity = 500;
-    pool.deallocate(o);
+    OrderHandle h = pool.allocate();
+    pool[h].id = 42;
+    pool[h].remaining = 500;
+    pool.info(h).price = 10000;
+    pool.info(h).quantity = 500;
+    pool.deallocate(h);
+
+    OrderHandle h2 = pool.allocate();
+    EXPECT_EQ(pool[h2].id, 0u);
+    EXPECT_EQ(pool[h2].remaining, 0u);
+    EXPECT_EQ(pool[h2].next, NULL_HANDLE);
+    EXPECT_EQ(pool.info(h2).price, INVALID_PRICE);
+    EXPECT_EQ(pool.info(h2).quantity, 0u);
+}
+
+TEST(OrderPoolTest, NodesShareCacheLines) {
+    OrderPool pool(4);
+    EXPECT_EQ(sizeof(Order), 32u);
+    EXPECT_EQ(alignof(Order), 32u);
+
+    OrderHandle a = pool.allocate();
+    OrderHandle b = pool.allocate();
+    auto addr_a = reinterpret_cast<std::uintptr_t>(&pool[a]);
+    auto addr_b = reinterpret_cast<std::uintptr_t>(&pool[b]);
+    EXPECT_EQ(addr_a % 32, 0u);
+    EXPECT_EQ(addr_a > addr_b ? addr_a - addr_b : addr_b - addr_a, 32u);
+}
+
+TEST(OrderPoolTest, GrowsBySlabsWithoutMovingOrders) {
+    PoolConfig config;
+    config.capacity = 4;
+    config.max_capacity = 12;
+    config.slab_size = 4;
+    OrderPool pool(config);
+    EXPECT_TRUE(pool.growable());
+    EXPECT_EQ(pool.slab_count(), 1u);
+
+    OrderHandle first = pool.allocate();
+    Order* first_addr = &pool[first];
+    pool[first].id = 99;
+
+    for (int i = 1; i < 12; ++i) {
+        ASSERT_NE(pool.allocate(), NULL_HANDLE);
+    }
+    EXPECT_EQ(pool.capacity(), 12u);
+    EXPECT_EQ(pool.slab_count(), 3u);
+    EXPECT_EQ(&pool[first], first_addr);
+    EXPECT_EQ(pool[first].id, 99u);
+
+    EXPECT_EQ(pool.allocate(), NULL_HANDLE);  // growth limit reached
+}
+
+TEST(OrderPoolTest, HugePageBackingFallsBack) {
+    // Explicit huge pages may not be reserved on this host; the pool must
+    // still come up (on transparent huge pages) and hand out usable slots.
+    PoolConfig config;
+    config.capacity = 1000;
+    config.pages.huge_pages = true;
+    config.pages.prefault = true;
+    OrderPool pool(config);
+
+    OrderHandle h = pool.allocate();
+    ASSERT_NE(h, NULL_HANDLE);
+    pool[h].remaining = 5;
+    pool.info(h).quantity = 5;
+    EXPECT_EQ(pool[h].remaining, 5u);
+}
+
+TEST(OrderPoolTest, NumaNodeAndWarmUpKeepContents) {
+    // Node 0 exists on any NUMA-capable host; binding is best effort
+    // elsewhere, so only the reported node is checked for consistency.
+    PoolConfig config;
+    config.capacity = 1000;
+    config.pages.numa_node = 0;
+    config.pages.prefault = true;
+    OrderPool pool(config);
+
+    OrderHandle h = pool.allocate();
+    ASSERT_NE(h, NULL_HANDLE);
+    pool[h].id = 42;
+    pool[h].remaining = 7;
+
+    pool.warm_up();
+    EXPECT_EQ(pool[h].id, 42u);
+    EXPECT_EQ(pool[h].remaining, 7u);
+}
+
+TEST(OrderPoolTest, PageBufferReportsNumaBinding) {
+    PageOptions options;
+    options.numa_node = 0;
+    PageBuffer buffer = PageBuffer::allocate(SMALL_PAGE_SIZE * 4, options);
+    ASSERT_TRUE(buffer);
+    EXPECT_TRUE(buffer.numa_node() == 0 || buffer.numa_node() == -1);
 
-    Order* o2 = pool.allocate();
-    EXPECT_EQ(o2->id, 0u);
-    EXPECT_EQ(o2->price, INVALID_PRICE);
-    EXPECT_EQ(o2->quantity, 0u);
+    PageBuffer unbound = PageBuffer::allocate(SMALL_PAGE_SIZE, PageOptions());
+    EXPECT_EQ(unbound.numa_node(), -1);
+}
+
+TEST(OrderPoolTest, HighWaterTracksPeakOccupancy) {
+    OrderPool pool(100);
+    std::vector<OrderHandle> held;
+    for (int i = 0; i < 10; ++i) held.push_back(pool.allocate());
+    EXPECT_EQ(pool.high_water(), 10u);
+    for (int i = 0; i < 6; ++i) {
+        pool.deallocate(held.back());
+        held.pop_back();
+    }
+    // Reuse comes off the free list, so the mark holds until a new peak
+    for (int i = 0; i < 6; ++i) held.push_back(pool.allocate());
+    EXPECT_EQ(pool.high_water(), 10u);
+    held.push_back(pool.allocate());
+    EXPECT_EQ(pool.high_water(), 11u);
+    EXPECT_EQ(pool.size(), 11u);
+    EXPECT_GE(pool.memory_bytes(), 100 * (sizeof(Order) + sizeof(OrderInfo)));
 }
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include "lob/pipeline.hpp"
+#include "test_config.hpp"
+
+#include <thread>
+#include <vector>
+
+using namespace lob;
+
+namespace {
+
+PipelineConfig test_pipeline_config() {
+    PipelineConfig config;
+    config.ingress_capacity = 64;
+    config.egress_capacity = 64;
+    config.yield_when_idle = true;  // tests may share one core
+    return config;
+}
+
+// Drain until the ack for tag arrives, collecting trades on the way
+CommandAck wait_for_ack(BookPipeline& pipeline, std::uint64_t tag, std::vector<Trade>* trades) {
+    EgressEvent event;
+    for (;;) {
+        if (!pipeline.poll(event)) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (event.type == EgressType::Fill) {
+            if (trades) trades->push_back(event.trade);
+        } else if (event.ack.tag == tag) {
+            return event.ack;
+        }
+    }
+}
+
+}  // namespace
+
+TEST(PipelineTest, CommandsRoundTripThroughMatchingThread) {
+    BookPipeline pipeline(test_book_config(LevelStorage::Ladder), test_pipeline_config());
+    pipeline.start();
+
+    ASSERT_TRUE(pipeline.submit(
+        OrderCommand::add(1, Side::Sell, OrderType::Limit, to_price(100.00), 30)));
+    CommandAck resting = wait_for_ack(pipeline, 1, nullptr);
+    EXPECT_EQ(resting.command, CommandType::Add);
+    EXPECT_EQ(resting.status, OrderStatus::Active);
+    EXPECT_NE(resting.order_id, 0u);
+
+    std::vector<Trade> trades;
+    ASSERT_TRUE(pipeline.submit(
+        OrderCommand::add(2, Side::Buy, OrderType::Limit, to_price(100.00), 10)));
+    CommandAck hit = wait_for_ack(pipeline, 2, &trades);
+    EXPECT_EQ(hit.status, OrderStatus::Filled);
+    EXPECT_EQ(hit.trade_count, 1u);
+    ASSERT_EQ(trades.size(), 1u);
+    EXPECT_EQ(trades[0].sell_order_id, resting.order_id);
+    EXPECT_EQ(trades[0].quantity, 10u);
+
+    ASSERT_TRUE(pipeline.submit(OrderCommand::modify(3, resting.order_id, 25)));
+    CommandAck modified = wait_for_ack(pipeline, 3, nullptr);
+    EXPECT_EQ(modified.status, OrderStatus::Active);
+    EXPECT_EQ(modified.remaining_quantity, 15u);  // 10 of the 25 already filled
+
+    ASSERT_TRUE(pipeline.submit(OrderCommand::replace(4, resting.order_id, to_price(100.50), 30)));
+    CommandAck replaced = wait_for_ack(pipeline, 4, nullptr);
+    EXPECT_EQ(replaced.command, CommandType::Replace);
+    EXPECT_EQ(replaced.order_id, resting.order_id);
+    EXPECT_EQ(replaced.remaining_quantity, 20u);
+
+    ASSERT_TRUE(pipeline.submit(OrderCommand::cancel(5, resting.order_id)));
+    EXPECT_EQ(wait_for_ack(pipeline, 5, nullptr).status, OrderStatus::Cancelled);
+
+    ASSERT_TRUE(pipeline.submit(OrderCommand::cancel(6, resting.order_id)));
+    CommandAck missing = wait_for_ack(pipeline, 6, nullptr);
+    EXPECT_EQ(missing.status, OrderStatus::Rejected);
+    EXPECT_EQ(missing.reject_reason, RejectReason::UnknownOrder);
+
+    pipeline.stop();
+    EXPECT_EQ(pipeline.commands_processed(), 6u);
+    EXPECT_TRUE(pipeline.book().empty());
+}
+
+TEST(PipelineTest, StopDrainsSubmittedCommands) {
+    PipelineConfig config = test_pipeline_config();
+    config.egress_capacity = 1024;
+    BookPipeline pipeline(test_book_config(LevelStorage::Map), config);
+    pipeline.start();
+
+    // Stream more commands than the ingress ring holds, consuming acks as we go
+    std::size_t acks = 0;
+    EgressEvent event;
+    for (std::uint64_t tag = 1; tag <= 500; ++tag) {
+        auto command = OrderCommand::add(tag, Side::Buy, OrderType::Limit, to_price(99.00), 1);
+        while (!pipeline.submit(command)) {
+            if (pipeline.poll(event) && event.type == EgressType::Ack) ++acks;
+        }
+    }
+    pipeline.stop();
+    while (pipeline.poll(event)) {
+        if (event.type == EgressType::Ack) ++acks;
+    }
+
+    EXPECT_EQ(acks, 500u);
+    EXPECT_EQ(pipeline.egress_dropped(), 0u);
+    EXPECT_EQ(pipeline.book().total_orders(), 500u);
+    EXPECT_EQ(pipeline.book().volume_at_price(Side::Buy, to_price(99.00)), 500u);
+}
+
+TEST(PipelineTest, ModifyAckReportsWhatIsLeftResting) {
+    BookPipeline pipeline(test_book_config(LevelStorage::Map), test_pipeline_config());
+    pipeline.start();
+    ASSERT_TRUE(pipeline.submit(
+        OrderCommand::add(1, Side::Sell, OrderType::Limit, to_price(100.00), 30)));
+    OrderId id = wait_for_ack(pipeline, 1, nullptr).order_id;
+    ASSERT_TRUE(pipeline.submit(
+        OrderCommand::add(2, Side::Buy, OrderType::Limit, to_price(100.00), 12)));
+    wait_for_ack(pipeline, 2, nullptr);
+
+    ASSERT_TRUE(pipeline.submit(OrderCommand::modify(3, id, 40)));
+    CommandAck grown = wait_for_ack(pipeline, 3, nullptr);
+    EXPECT_EQ(grown.status, OrderStatus::Active);
+    EXPECT_EQ(grown.remaining_quantity, 28u);
+
+    // At or below the filled amount the modify cancels
+    ASSERT_TRUE(pipeline.submit(OrderCommand::modify(4, id, 12)));
+    CommandAck gone = wait_for_ack(pipeline, 4, nullptr);
+    EXPECT_EQ(gone.status, OrderStatus::Cancelled);
+    EXPECT_EQ(gone.remaining_quantity, 0u);
+
+    pipeline.stop();
+    EXPECT_TRUE(pipeline.book().empty());
+}
+
+TEST(PipelineTest, AckCountsTradesBeyondTheBuffer) {
+    PipelineConfig config = test_pipeline_config();
+    config.max_trades_per_order = 2;
+    BookPipeline pipeline(test_book_config(LevelStorage::Ladder), config);
+    pipeline.start();
+    for (std::uint64_t tag = 1; tag <= 5; ++tag) {
+        ASSERT_TRUE(pipeline.submit(
+            OrderCommand::add(tag, Side::Sell, OrderType::Limit, to_price(100.00), 10)));
+        wait_for_ack(pipeline, tag, nullptr);
+    }
+
+    std::vector<Trade> trades;
+    ASSERT_TRUE(pipeline.submit(OrderCommand::add(6, Side::Buy, OrderType::Market, 0, 50)));
+    CommandAck sweep = wait_for_ack(pipeline, 6, &trades);
+    EXPECT_EQ(sweep.status, OrderStatus::Filled);
+    EXPECT_EQ(sweep.filled_quantity, 50u);
+    EXPECT_EQ(sweep.trade_count, 5u);
+    EXPECT_EQ(sweep.trades_dropped, 3u);
+    EXPECT_EQ(trades.size(), sweep.trade_count - sweep.trades_dropped);
+
+    pipeline.stop();
+    EXPECT_TRUE(pipeline.book().empty());
+}
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include "lob/price_ladder.hpp"
+#include "lob/order_book.hpp"
+
+#include <vector>
+
+using namespace lob;
+
+TEST(PriceLadderTest, EmptyLadder) {
+    PriceLadder ladder(Side::Sell, 10000, 10100, 1);
+    EXPECT_EQ(ladder.size(), 0u);
+    EXPECT_EQ(ladder.capacity(), 101u);
+    EXPECT_EQ(ladder.best(), nullptr);
+    EXPECT_EQ(ladder.find(10050), nullptr);
+}
+
+TEST(PriceLadderTest, ContainsRespectsBandAndTick) {
+    PriceLadder ladder(Side::Buy, 10000, 10100, 5);
+    EXPECT_TRUE(ladder.contains(10000));
+    EXPECT_TRUE(ladder.contains(10005));
+    EXPECT_TRUE(ladder.contains(10100));
+    EXPECT_FALSE(ladder.contains(10003));
+    EXPECT_FALSE(ladder.contains(9995));
+    EXPECT_FALSE(ladder.contains(10105));
+}
+
+TEST(PriceLadderTest, InvalidBandThrows) {
+    EXPECT_THROW(PriceLadder(Side::Buy, 10100, 10000, 1), std::invalid_argument);
+    EXPECT_THROW(PriceLadder(Side::Buy, 10000, 10100, 0), std::invalid_argument);
+    EXPECT_THROW(PriceLadder(Side::Buy, 10000, 10101, 5), std::invalid_argument);
+}
+
+TEST(PriceLadderTest, AskBestIsLowest) {
+    PriceLadder ladder(Side::Sell, 10000, 10999, 1);
+    ladder.get_or_insert(10500);
+    ladder.get_or_insert(10200);
+    ladder.get_or_insert(10800);
+
+    ASSERT_NE(ladder.best(), nullptr);
+    EXPECT_EQ(ladder.best()->price, 10200u);
+    EXPECT_EQ(ladder.size(), 3u);
+}
+
+TEST(PriceLadderTest, BidBestIsHighest) {
+    PriceLadder ladder(Side::Buy, 10000, 10999, 1);
+    ladder.get_or_insert(10500);
+    ladder.get_or_insert(10200);
+    ladder.get_or_insert(10800);
+
+    ASSERT_NE(ladder.best(), nullptr);
+    EXPECT_EQ(ladder.best()->price, 10800u);
+}
+
+TEST(PriceLadderTest, EraseBestSkipsGapsAcrossWords) {
+    // Levels 700 ticks apart span many bitmap words
+    PriceLadder asks(Side::Sell, 10000, 11999, 1);
+    asks.get_or_insert(10001);
+    asks.get_or_insert(10700);
+    asks.get_or_insert(11999);
+
+    asks.erase(*asks.best());
+    EXPECT_EQ(asks.best()->price, 10700u);
+    asks.erase(*asks.best());
+    EXPECT_EQ(asks.best()->price, 11999u);
+    asks.erase(*asks.best());
+    EXPECT_EQ(asks.best(), nullptr);
+
+    PriceLadder bids(Side::Buy, 10000, 11999, 1);
+    bids.get_or_insert(10000);
+    bids.get_or_insert(10700);
+    bids.get_or_insert(11998);
+
+    bids.erase(*bids.best());
+    EXPECT_EQ(bids.best()->price, 10700u);
+    bids.erase(*bids.best());
+    EXPECT_EQ(bids.best()->price, 10000u);
+    bids.erase(*bids.best());
+    EXPECT_EQ(bids.best(), nullptr);
+}
+
+TEST(PriceLadderTest, EraseNonBestKeepsCursor) {
+    PriceLadder ladder(Side::Sell, 10000, 10999, 1);
+    ladder.get_or_insert(10100);
+    PriceLevel& mid = ladder.get_or_insert(10300);
+
+    ladder.erase(mid);
+    EXPECT_EQ(ladder.best()->price, 10100u);
+    EXPECT_EQ(ladder.find(10300), nullptr);
+    EXPECT_EQ(ladder.size(), 1u);
+}
+
+TEST(PriceLadderTest, ForEachLevelBestToWorst) {
+    PriceLadder ladder(Side::Buy, 10000, 10999, 1);
+    ladder.get_or_insert(10100);
+    ladder.get_or_insert(10900);
+    ladder.get_or_insert(10500);
+
+    std::vector<Price> prices;
+    ladder.for_each_level(2, [&](const PriceLevel& level) { prices.push_back(level.price); });
+    ASSERT_EQ(prices.size(), 2u);
+    EXPECT_EQ(prices[0], 10900u);
+    EXPECT_EQ(prices[1], 10500u);
+}
+
+TEST(PriceLadderTest, BookRejectsLimitOutsideBand) {
+    BookConfig config;
+    config.pool.capacity = 100;
+    config.level_storage = LevelStorage::Ladder;
+    config.ladder = LadderRange{to_price(90.00), to_price(110.00), 5};
+    OrderBook book(config);
+
+    auto out_of_band = book.add_order(Side::Buy, OrderType::Limit, to_price(120.00), 10);
+    EXPECT_EQ(out_of_band.status, OrderStatus::Rejected);
+    EXPECT_EQ(out_of_band.remaining_quantity, 10u);
+    EXPECT_EQ(out_of_band.reject_reason, RejectReason::PriceOutOfBand);
+
+    auto off_tick = book.add_order(Side::Buy, OrderType::Limit, to_price(100.01), 10);
+    EXPECT_EQ(off_tick.status, OrderStatus::Rejected);
+    EXPECT_EQ(book.total_orders(), 0u);
+
+    auto ok = book.add_order(Side::Buy, OrderType::Limit, to_price(100.05), 10);
+    EXPECT_EQ(ok.status, OrderStatus::Active);
+    EXPECT_EQ(book.best_bid(), to_price(100.05));
+}
@@ -5,13 +5,14 @@ using namespace lob;
 
 class PriceLevelTest : public ::testing::Test {
 protected:
-    Order orders[5];
+    OrderPool pool{5};
+    OrderHandle orders[5];
 
     void SetUp() override {
         for (int i = 0; i < 5; ++i) {
-            orders[i].reset();
-            orders[i].id = static_cast<OrderId>(i + 1);
-            orders[i].quantity = 100;
+            orders[i] = pool.allocate();
+            pool[orders[i]].id = static_cast<OrderId>(i + 1);
+            pool[orders[i]].remaining = 100;
         }
     }
 };
@@ -21,75 +22,75 @@ TEST_F(PriceLevelTest, EmptyLevel) {
     EXPECT_TRUE(level.empty());
     EXPECT_EQ(level.total_quantity, 0u);
     EXPECT_EQ(level.order_count, 0u);
-    EXPECT_EQ(level.front(), nullptr);
+    EXPECT_EQ(level.front(), NULL_HANDLE);
 }
 
 TEST_F(PriceLevelTest, AddSingleOrder) {
     PriceLevel level(10000);
-    level.add_order(&orders[0]);
+    level.add_order(pool, orders[0]);
 
     EXPECT_FALSE(level.empty());
     EXPECT_EQ(level.total_quantity, 100u);
     EXPECT_EQ(level.order_count, 1u);
-    EXPECT_EQ(level.front(), &orders[0]);
+    EXPECT_EQ(level.front(), orders[0]);
 }
 
 TEST_F(PriceLevelTest, FIFOOrdering) {
     PriceLevel level(10000);
-    level.add_order(&orders[0]);
-    level.add_order(&orders[1]);
-    level.add_order(&orders[2]);
+    level.add_order(pool, orders[0]);
+    level.add_order(pool, orders[1]);
+    level.add_order(pool, orders[2]);
 
     // Front should be the first order added
-    EXPECT_EQ(level.front(), &orders[0]);
-    EXPECT_EQ(level.front()->next, &orders[1]);
-    EXPECT_EQ(level.front()->next->next, &orders[2]);
+    EXPECT_EQ(level.front(), orders[0]);
+    EXPECT_EQ(pool[level.front()].next, orders[1]);
+    EXPECT_EQ(pool[pool[level.front()].next].next, orders[2]);
     EXPECT_EQ(level.total_quantity, 300u);
     EXPECT_EQ(level.order_count, 3u);
 }
 
 TEST_F(PriceLevelTest, RemoveHead) {
     PriceLevel level(10000);
-    level.add_order(&orders[0]);
-    level.add_order(&orders[1]);
+    level.add_order(pool, orders[0]);
+    level.add_order(pool, orders[1]);
 
-    level.remove_order(&orders[0]);
-    EXPECT_EQ(level.front(), &orders[1]);
+    level.remove_order(pool, orders[0]);
+    EXPECT_EQ(level.front(), orders[1]);
     EXPECT_EQ(level.total_quantity, 100u);
     EXPECT_EQ(level.order_count, 1u);
 }
 
 TEST_F(PriceLevelTest, RemoveTail) {
     PriceLevel level(10000);
-    level.add_order(&orders[0]);
-    level.add_order(&orders[1]);
+    level.add_order(pool, orders[0]);
+    level.add_order(pool, orders[1]);
 
-    level.remove_order(&orders[1]);
-    EXPECT_EQ(level.front(), &orders[0]);
-    EXPECT_EQ(level.front()->next, nullptr);
+    level.remove_order(pool, orders[1]);
+    EXPECT_EQ(level.front(), orders[0]);
+    EXPECT_EQ(pool[level.front()].next, NULL_HANDLE);
     EXPECT_EQ(level.order_count, 1u);
 }
 
 TEST_F(PriceLevelTest, RemoveMiddle) {
     PriceLevel level(10000);
-    level.add_order(&orders[0]);
-    level.add_order(&orders[1]);
-    level.add_order(&orders[2]);
+    level.add_order(pool, orders[0]);
+    level.add_order(pool, orders[1]);
+    level.add_order(pool, orders[2]);
 
-    level.remove_order(&orders[1]);
-    EXPECT_EQ(level.front(), &orders[0]);
-    EXPECT_EQ(level.front()->next, &orders[2]);
+    level.remove_order(pool, orders[1]);
+    EXPECT_EQ(level.front(), orders[0]);
+    EXPECT_EQ(pool[level.front()].next, orders[2]);
     EXPECT_EQ(level.order_count, 2u);
     EXPECT_EQ(level.total_quantity, 200u);
 }
 
 TEST_F(PriceLevelTest, RemoveAllOrders) {
     PriceLevel level(10000);
-    level.add_order(&orders[0]);
-    level.add_order(&orders[1]);
+    level.add_order(pool, orders[0]);
+    level.add_order(pool, orders[1]);
 
-    level.remove_order(&orders[0]);
-    level.remove_order(&orders[1]);
+    level.remove_order(pool, orders[0]);
+    level.remove_order(pool, orders[1]);
 
     EXPECT_TRUE(level.empty());
     EXPECT_EQ(level.total_quantity, 0u);
@@ -98,9 +99,45 @@ TEST_F(PriceLevelTest, RemoveAllOrders) {
 
 TEST_F(PriceLevelTest, QuantityTracksPartialFills) {
     PriceLevel level(10000);
-    orders[0].quantity = 500;
-    orders[0].filled_quantity = 200;  // remaining = 300
+    pool[orders[0]].remaining = 300;  // 500 ordered, 200 already filled
 
-    level.add_order(&orders[0]);
+    level.add_order(pool, orders[0]);
     EXPECT_EQ(level.total_quantity, 300u);
 }
+
+TEST_F(PriceLevelTest, TracksLevelBackReference) {
+    PriceLevel level(10000);
+    level.add_order(pool, orders[0]);
+    level.add_order(pool, orders[1]);
+    EXPECT_EQ(pool[orders[0]].level, &level);
+    EXPECT_EQ(pool[orders[1]].level, &level);
+
+    level.remove_order(pool, orders[0]);
+    EXPECT_EQ(pool[orders[0]].level, nullptr);
+    EXPECT_EQ(pool[orders[1]].level, &level);
+}
+
+TEST_F(PriceLevelTest, KillOrderKeepsLinks) {
+    PriceLevel level(10000);
+    level.add_order(pool, orders[0]);
+    level.add_order(pool, orders[1]);
+    level.add_order(pool, orders[2]);
+
+    level.kill_order(pool[orders[1]]);
+    EXPECT_EQ(level.total_quantity, 200u);
+    EXPECT_EQ(level.order_count, 2u);
+    EXPECT_EQ(pool[orders[1]].remaining, 0u);
+    EXPECT_EQ(pool[orders[0]].next, orders[1]);  // still linked
+    EXPECT_EQ(pool[orders[1]].level, &level);
+
+    // Unlinking the tombstone leaves the totals alone
+    level.unlink(pool, orders[1]);
+    EXPECT_EQ(pool[orders[0]].next, orders[2]);
+    EXPECT_EQ(level.total_quantity, 200u);
+
+    // A level whose live orders are all gone is empty while tombstones remain
+    level.kill_order(pool[orders[0]]);
+    level.kill_order(pool[orders[2]]);
+    EXPECT_TRUE(level.empty());
+    EXPECT_EQ(level.front(), orders[0]);
+}
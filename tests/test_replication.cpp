@@ -0,0 +1,260 @@
+#include <gtest/gtest.h>
+#include "lob/replication.hpp"
+#include "test_config.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace lob;
+
+namespace {
+
+std::string journal_path(const char* name) {
+    return ::testing::TempDir() + "lob_" + name + ".journal";
+}
+
+ReplicationConfig standby_at(std::uint16_t port) {
+    ReplicationConfig config;
+    config.port = port;
+    config.nack_interval = std::chrono::nanoseconds(0);
+    config.heartbeat_interval = std::chrono::nanoseconds(0);
+    return config;
+}
+
+// Random adds, crossing orders, cancels, modifies and an auction; after()
+// runs between inputs
+template <typename After>
+void drive(ReplicatedBook& primary, std::size_t steps, unsigned seed, After&& after) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<Price> price_dist(to_price(99.00), to_price(101.00));
+    std::uniform_int_distribution<Quantity> qty_dist(1, 200);
+    std::vector<OrderId> ids;
+    TradeBuffer trades;
+    for (std::size_t i = 0; i < steps; ++i) {
+        if (i == steps / 2) primary.begin_auction();
+        if (i == steps / 2 + 20) primary.uncross(trades);
+        auto action = rng() % 10;
+        if (action < 6 || ids.empty()) {
+            Side side = rng() % 2 ? Side::Buy : Side::Sell;
+            OrderAck ack = primary.add_order(side, OrderType::Limit, price_dist(rng),
+                                             qty_dist(rng), trades);
+            if (ack.order_id != 0) ids.push_back(ack.order_id);
+        } else if (action < 8) {
+            primary.cancel_order(ids[rng() % ids.size()]);
+        } else if (action < 9) {
+            primary.modify_order(ids[rng() % ids.size()], qty_dist(rng));
+        } else {
+            primary.replace_order(ids[rng() % ids.size()], price_dist(rng), qty_dist(rng), trades);
+        }
+        trades.clear();
+        after();
+    }
+}
+
+// Poll until the standby has applied `target` records or two seconds pass
+template <typename Receiver, typename Step>
+bool catch_up(Receiver& standby, std::uint64_t target, Step&& step) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (standby.next_sequence() < target && !standby.lost() &&
+           std::chrono::steady_clock::now() < deadline) {
+        step();
+        standby.poll();
+    }
+    return standby.next_sequence() == target;
+}
+
+void expect_same_book(OrderBook& standby, OrderBook& primary) {
+    EXPECT_EQ(standby.total_orders(), primary.total_orders());
+    EXPECT_EQ(standby.total_trades(), primary.total_trades());
+    EXPECT_EQ(standby.total_volume(), primary.total_volume());
+    EXPECT_EQ(standby.bid_depth(1000), primary.bid_depth(1000));
+    EXPECT_EQ(standby.ask_depth(1000), primary.ask_depth(1000));
+    EXPECT_EQ(standby.phase(), primary.phase());
+
+    // The standby can take over: it assigns the primary's next ID
+    auto a = primary.add_order(Side::Buy, OrderType::Market, 0, 500);
+    auto b = standby.add_order(Side::Buy, OrderType::Market, 0, 500);
+    EXPECT_EQ(a.order_id, b.order_id);
+    EXPECT_EQ(a.trades.size(), b.trades.size());
+}
+
+// Forwards the primary's datagrams to the standby, dropping the ones
+// chosen by drop(index), and the standby's NACKs back to the primary
+class LossyRelay {
+public:
+    explicit LossyRelay(std::uint16_t standby_port)
+        : socket_("127.0.0.1", 0), standby_port_(standby_port) {}
+
+    std::uint16_t port() const { return socket_.local().port; }
+
+    template <typename Drop>
+    void pump(std::uint16_t primary_port, Drop&& drop) {
+        char packet[REPLICATION_MAX_PACKET];
+        UdpEndpoint from;
+        long size;
+        while ((size = socket_.receive(packet, sizeof(packet), from)) >= 0) {
+            if (from.port == standby_port_) {
+                socket_.send(packet, static_cast<std::size_t>(size),
+                             udp_endpoint("127.0.0.1", primary_port));
+                continue;
+            }
+            ReplicationPacketHeader header;
+            std::memcpy(&header, packet, sizeof(header));
+            if (header.type == ReplicationPacketType::Data && drop(data_seen_++)) continue;
+            socket_.send(packet, static_cast<std::size_t>(size),
+                         udp_endpoint("127.0.0.1", standby_port_));
+        }
+    }
+
+private:
+    UdpSocket socket_;
+    std::uint16_t standby_port_;
+    std::size_t data_seen_ = 0;
+};
+
+}  // namespace
+
+class ReplicationTest : public ::testing::TestWithParam<LevelStorage> {};
+
+TEST_P(ReplicationTest, StandbyMirrorsPrimary) {
+    std::string path = journal_path("replicated");
+    BookConfig config = test_book_config(GetParam());
+    {
+        OrderBook standby_book(config);
+        ReplicationReceiver<OrderBook> standby(standby_book, standby_at(0));
+        ReplicatedBook primary(path, config, 10000, standby_at(standby.local().port));
+
+        drive(primary, 2000, 3, [&] { standby.poll(); });
+        std::uint64_t journaled = primary.journal().size();
+        EXPECT_EQ(primary.sender().next_sequence(), journaled);
+        ASSERT_TRUE(catch_up(standby, journaled, [&] { primary.idle(); }));
+        EXPECT_EQ(standby.stats().applied, journaled);
+        EXPECT_EQ(standby.stats().gaps, 0u);
+        expect_same_book(standby_book, primary.book());
+    }
+    std::remove(path.c_str());
+}
+
+TEST_P(ReplicationTest, LostDatagramsAreResentOnNack) {
+    std::string path = journal_path("replicated_loss");
+    BookConfig config = test_book_config(GetParam());
+    {
+        OrderBook standby_book(config);
+        ReplicationReceiver<OrderBook> standby(standby_book, standby_at(0));
+        LossyRelay relay(standby.local().port);
+        ReplicationConfig link = standby_at(relay.port());
+        link.records_per_packet = 8;
+        ReplicatedBook primary(path, config, 10000, link);
+
+        // Drop one datagram early on, and the last two so only heartbeats
+        // reveal the missing tail
+        drive(primary, 400, 5, [] {});
+        primary.flush();
+        std::uint64_t journaled = primary.journal().size();
+        std::uint64_t first_sends = primary.sender().stats().packets;
+        std::uint16_t primary_port = primary.sender().local().port;
+        auto drop = [&](std::size_t i) {
+            return i == 3 || (i + 2 >= first_sends && i < first_sends);
+        };
+        ASSERT_TRUE(catch_up(standby, journaled, [&] {
+            relay.pump(primary_port, drop);
+            primary.idle();
+        }));
+        EXPECT_GT(standby.stats().gaps, 0u);
+        EXPECT_GT(standby.stats().nacks, 0u);
+        EXPECT_GT(primary.sender().stats().retransmitted, 0u);
+        EXPECT_FALSE(standby.lost());
+        expect_same_book(standby_book, primary.book());
+    }
+    std::remove(path.c_str());
+}
+
+INSTANTIATE_TEST_SUITE_P(Storage, ReplicationTest,
+                         ::testing::Values(LevelStorage::Map, LevelStorage::Ladder),
+                         level_storage_name);
+
+TEST(ReplicationSenderTest, OverrunStandbyIsToldItIsLost) {
+    OrderBook standby_book;
+    ReplicationReceiver<OrderBook> standby(standby_book, standby_at(0));
+    LossyRelay relay(standby.local().port);
+    ReplicationConfig link = standby_at(relay.port());
+    link.retransmit_capacity = 64;
+    link.records_per_packet = 4;
+    ReplicationSender sender(link);
+
+    JournalRecord add{JournalOp::Add, Side::Buy, OrderType::Limit, {}, 0, to_price(99.00), 10};
+    for (int i = 0; i < 200; ++i) sender.publish(add);
+    relay.pump(sender.local().port, [](std::size_t i) { return i == 0; });
+    standby.poll();  // everything after the hole is dropped, and NACKed
+    EXPECT_EQ(standby.next_sequence(), 0u);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (!standby.lost() && std::chrono::steady_clock::now() < deadline) {
+        relay.pump(sender.local().port, [](std::size_t) { return false; });
+        sender.poll();
+        standby.poll();
+    }
+    EXPECT_TRUE(standby.lost());
+    EXPECT_GT(sender.stats().unrecoverable, 0u);
+    EXPECT_EQ(standby_book.total_orders(), 0u);
+}
+
+TEST(ReplicationSenderTest, NackWindowEndsAtTheLastPublishedRecord) {
+    // A fake standby that NACKs by hand. 66 records through a 64-slot ring
+    // four at a time: 64 are sent, 64 and 65 wait in slots 0 and 1.
+    UdpSocket standby("127.0.0.1", 0);
+    ReplicationConfig link = standby_at(standby.local().port);
+    link.retransmit_capacity = 64;
+    link.records_per_packet = 4;
+    ReplicationSender sender(link);
+    for (Quantity i = 0; i < 66; ++i) {
+        sender.publish({JournalOp::Add, Side::Buy, OrderType::Limit, {}, 0, to_price(99.00), i});
+    }
+    ASSERT_EQ(sender.next_sequence(), 66u);
+
+    char packet[REPLICATION_MAX_PACKET];
+    UdpEndpoint from;
+    auto reply_to = [&](std::uint64_t sequence) {
+        while (standby.receive(packet, sizeof(packet), from) >= 0) {}
+        ReplicationPacketHeader nack{REPLICATION_MAGIC, ReplicationPacketType::Nack, 0, 0,
+                                     sequence};
+        standby.send(&nack, sizeof(nack), udp_endpoint("127.0.0.1", sender.local().port));
+        ReplicationPacketHeader header{};
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (std::chrono::steady_clock::now() < deadline) {
+            sender.poll();
+            if (standby.receive(packet, sizeof(packet), from) >= 0) {
+                std::memcpy(&header, packet, sizeof(header));
+                break;
+            }
+        }
+        return header;
+    };
+
+    // Slots 0 and 1 hold 64 and 65 now, so 0 and 1 are gone
+    ReplicationPacketHeader gone = reply_to(0);
+    EXPECT_EQ(gone.type, ReplicationPacketType::Gone);
+    EXPECT_EQ(gone.sequence, 2u);
+    EXPECT_EQ(sender.stats().unrecoverable, 1u);
+
+    ReplicationPacketHeader resent = reply_to(2);
+    ASSERT_EQ(resent.type, ReplicationPacketType::Data);
+    EXPECT_EQ(resent.sequence, 2u);
+    EXPECT_EQ(resent.count, REPLICATION_MAX_RECORDS);  // 2..63, first datagram
+    JournalRecord first;
+    std::memcpy(&first, packet + sizeof(resent), sizeof(first));
+    EXPECT_EQ(first.quantity, 2u);
+}
+
+TEST(ReplicationSenderTest, RejectsNonNumericAddress) {
+    EXPECT_EQ(udp_endpoint("10.1.2.3", 7).address, 0x0a010203u);
+    EXPECT_THROW(udp_endpoint("standby.local", 7), std::invalid_argument);
+    ReplicationConfig config;
+    config.address = "not an address";
+    EXPECT_THROW(ReplicationSender sender(config), std::invalid_argument);
+}
@@ -0,0 +1,228 @@
+#include <gtest/gtest.h>
+#include "lob/simulation.hpp"
+#include "test_config.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace lob;
+
+namespace {
+
+// Random adds, crossing orders, cancels and modifies from one seed; the
+// length varies with the seed so shares take uneven time
+void random_day(SimulationContext& context, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<Price> price_dist(to_price(99.00), to_price(101.00));
+    std::uniform_int_distribution<Quantity> qty_dist(1, 200);
+    std::vector<OrderId> ids;
+    std::size_t steps = 200 + (seed % 5) * 300;
+    for (std::size_t i = 0; i < steps; ++i) {
+        auto action = rng() % 10;
+        if (action < 6 || ids.empty()) {
+            Side side = rng() % 2 ? Side::Buy : Side::Sell;
+            OrderAck ack =
+                context.add_order(side, OrderType::Limit, price_dist(rng), qty_dist(rng));
+            if (ack.order_id != 0) ids.push_back(ack.order_id);
+        } else if (action < 8) {
+            context.cancel_order(ids[rng() % ids.size()]);
+        } else if (action < 9) {
+            context.modify_order(ids[rng() % ids.size()], qty_dist(rng));
+        } else {
+            context.replace_order(ids[rng() % ids.size()], price_dist(rng), qty_dist(rng));
+        }
+    }
+}
+
+std::vector<Scenario> random_days(std::size_t count) {
+    std::vector<Scenario> scenarios;
+    for (std::size_t i = 0; i < count; ++i) {
+        auto seed = static_cast<unsigned>(i + 1);
+        scenarios.push_back([seed](SimulationContext& context) { random_day(context, seed); });
+    }
+    return scenarios;
+}
+
+SimulationConfig runner_config(LevelStorage storage, std::size_t threads) {
+    SimulationConfig config;
+    config.threads = threads;
+    config.book = test_book_config(storage);
+    return config;
+}
+
+}  // namespace
+
+class SimulationTest : public ::testing::TestWithParam<LevelStorage> {};
+
+TEST_P(SimulationTest, TotalsDoNotDependOnThreadCount) {
+    std::vector<Scenario> scenarios = random_days(24);
+    SimulationRunner serial(runner_config(GetParam(), 1));
+    SimulationRunner parallel(runner_config(GetParam(), 4));
+    std::vector<ScenarioResult> one = serial.run(scenarios);
+    std::vector<ScenarioResult> four = parallel.run(scenarios);
+    EXPECT_EQ(parallel.threads(), 4u);
+
+    ASSERT_EQ(one.size(), scenarios.size());
+    ASSERT_EQ(four.size(), scenarios.size());
+    for (std::size_t i = 0; i < scenarios.size(); ++i) {
+        EXPECT_EQ(one[i].inputs, four[i].inputs);
+        EXPECT_EQ(one[i].trades, four[i].trades);
+        EXPECT_EQ(one[i].volume, four[i].volume);
+        EXPECT_EQ(one[i].resting, four[i].resting);
+        EXPECT_EQ(one[i].worker, 0u);
+    }
+    EXPECT_GT(one[0].trades, 0u);
+
+    const SimulationStats& a = serial.stats();
+    const SimulationStats& b = parallel.stats();
+    EXPECT_EQ(a.scenarios, scenarios.size());
+    EXPECT_EQ(b.scenarios, scenarios.size());
+    EXPECT_EQ(a.inputs, b.inputs);
+    EXPECT_EQ(a.trades, b.trades);
+    EXPECT_EQ(a.volume, b.volume);
+    EXPECT_EQ(a.resting, b.resting);
+    EXPECT_EQ(a.steals, 0u);
+    EXPECT_EQ(a.latency.count(), a.inputs);
+    EXPECT_EQ(b.latency.count(), b.inputs);
+}
+
+TEST_P(SimulationTest, EachScenarioSeesAFreshBook) {
+    // Scenario 0 on a runner's reused book matches a book built for it
+    OrderBook fresh(test_book_config(GetParam()));
+    SimulationRunner runner(runner_config(GetParam(), 1));
+    std::vector<OrderId> first_ids;
+    std::vector<Scenario> scenarios(3, [&first_ids](SimulationContext& context) {
+        EXPECT_EQ(context.book().total_orders(), 0u);
+        EXPECT_EQ(context.book().total_trades(), 0u);
+        first_ids.push_back(
+            context.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 10).order_id);
+        context.book().set_trade_callback([](const Trade&) {});
+        context.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 4);
+        EXPECT_EQ(context.trades().size, 1u);
+    });
+    runner.run(scenarios);
+    runner.run(scenarios);
+
+    OrderId expected = fresh.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 10).order_id;
+    ASSERT_EQ(first_ids.size(), 6u);
+    for (OrderId id : first_ids) EXPECT_EQ(id, expected);
+    EXPECT_EQ(runner.stats().scenarios, 6u);
+    EXPECT_EQ(runner.stats().inputs, 12u);
+    EXPECT_EQ(runner.stats().trades, 6u);
+    EXPECT_EQ(runner.stats().resting, 6u);
+}
+
+TEST_P(SimulationTest, JournalScenarioReplaysARecordedDay) {
+    std::string path = ::testing::TempDir() + "lob_simulation_day.journal";
+    BookConfig config = test_book_config(GetParam());
+    std::uint64_t trades;
+    std::uint64_t volume;
+    std::size_t resting;
+    {
+        JournaledBook day(path, config, 10000);
+        std::mt19937 rng(9);
+        TradeBuffer discard;
+        std::vector<OrderId> ids;
+        for (int i = 0; i < 500; ++i) {
+            if (rng() % 4 == 0 && !ids.empty()) {
+                day.cancel_order(ids[rng() % ids.size()]);
+                continue;
+            }
+            Side side = rng() % 2 ? Side::Buy : Side::Sell;
+            Price price = to_price(99.00) + static_cast<Price>(rng() % 200);
+            auto qty = static_cast<Quantity>(1 + rng() % 100);
+            OrderAck ack = day.add_order(side, OrderType::Limit, price, qty, discard);
+            discard.clear();
+            if (ack.order_id != 0) ids.push_back(ack.order_id);
+        }
+        day.journal().commit();
+        trades = day.book().total_trades();
+        volume = day.book().total_volume();
+        resting = day.book().total_orders();
+    }
+
+    SimulationRunner runner(runner_config(GetParam(), 3));
+    std::vector<Scenario> days(5, journal_scenario(path));
+    std::vector<ScenarioResult> results = runner.run(days);
+    for (const ScenarioResult& r : results) {
+        EXPECT_EQ(r.trades, trades);
+        EXPECT_EQ(r.volume, volume);
+        EXPECT_EQ(r.resting, resting);
+        EXPECT_EQ(r.inputs, 500u);
+    }
+    EXPECT_EQ(runner.stats().volume, 5 * volume);
+    std::remove(path.c_str());
+}
+
+INSTANTIATE_TEST_SUITE_P(Storage, SimulationTest,
+                         ::testing::Values(LevelStorage::Map, LevelStorage::Ladder),
+                         level_storage_name);
+
+TEST(SimulationRunnerTest, IdleWorkersStealFromABusyOne) {
+    // Two workers with shares {0..3} and {4..7}. Scenario 0 holds worker 0
+    // until the other seven are done, so worker 1 must steal 1..3; the rest
+    // wait for it to start, so worker 1 cannot steal scenario 0 itself.
+    SimulationRunner runner(runner_config(LevelStorage::Map, 2));
+    std::atomic<bool> started{false};
+    std::atomic<int> finished{0};
+    auto wait_for = [](auto&& done) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (!done() && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+    };
+    std::vector<Scenario> scenarios;
+    scenarios.push_back([&](SimulationContext&) {
+        started = true;
+        wait_for([&] { return finished.load() == 7; });
+    });
+    for (int i = 1; i < 8; ++i) {
+        scenarios.push_back([&](SimulationContext& context) {
+            wait_for([&] { return started.load(); });
+            context.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 1);
+            ++finished;
+        });
+    }
+    std::vector<ScenarioResult> results = runner.run(scenarios);
+    EXPECT_EQ(finished.load(), 7);
+    EXPECT_EQ(results[0].worker, 0u);
+    EXPECT_FALSE(results[0].stolen);
+    for (std::size_t i = 1; i < 4; ++i) {
+        EXPECT_EQ(results[i].worker, 1u);
+        EXPECT_TRUE(results[i].stolen);
+    }
+    for (std::size_t i = 4; i < 8; ++i) {
+        EXPECT_EQ(results[i].worker, 1u);
+        EXPECT_FALSE(results[i].stolen);
+    }
+    EXPECT_EQ(runner.stats().steals, 3u);
+    EXPECT_EQ(runner.stats().resting, 7u);
+}
+
+TEST(SimulationRunnerTest, ScenarioFailureStopsTheRun) {
+    SimulationRunner runner(runner_config(LevelStorage::Map, 2));
+    std::vector<Scenario> scenarios = random_days(6);
+    scenarios[2] = [](SimulationContext& context) {
+        context.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 1);
+        throw std::runtime_error("bad symbol-day");
+    };
+    EXPECT_THROW(runner.run(scenarios), std::runtime_error);
+    EXPECT_EQ(runner.stats().scenarios, 0u);
+
+    // The runner and its books are still usable afterwards
+    std::vector<ScenarioResult> results = runner.run(random_days(4));
+    EXPECT_EQ(runner.stats().scenarios, 4u);
+    EXPECT_EQ(results.size(), 4u);
+}
+
+TEST(SimulationRunnerTest, MissingJournalThrows) {
+    SimulationRunner runner(runner_config(LevelStorage::Map, 1));
+    std::vector<Scenario> scenarios{journal_scenario("/nonexistent/day.journal")};
+    EXPECT_THROW(runner.run(scenarios), std::exception);
+}
@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+#include "lob/order_book.hpp"
+#include "lob/journal.hpp"
+#include "test_config.hpp"
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace lob;
+
+namespace {
+
+std::string temp_path(const char* name) {
+    return ::testing::TempDir() + "lob_" + name;
+}
+
+std::vector<char> take_snapshot(const OrderBook& book) {
+    std::vector<char> image(book.snapshot_size());
+    EXPECT_EQ(book.snapshot(image.data(), image.size()), image.size());
+    return image;
+}
+
+}  // namespace
+
+class SnapshotTest : public ::testing::TestWithParam<LevelStorage> {};
+
+TEST_P(SnapshotTest, RestorePreservesTimePriorityAndCounters) {
+    OrderBook book(test_book_config(GetParam()));
+    auto first = book.add_order(Side::Sell, OrderType::Limit, to_price(101.00), 10);
+    auto second = book.add_order(Side::Sell, OrderType::Limit, to_price(101.00), 20);
+    book.add_order(Side::Sell, OrderType::Limit, to_price(102.00), 30);
+    book.add_order(Side::Buy, OrderType::Limit, to_price(99.00), 40);
+    book.add_order(Side::Buy, OrderType::Limit, to_price(101.00), 5);  // partial fill of first
+    auto third = book.add_order(Side::Sell, OrderType::Limit, to_price(101.00), 15);
+    book.cancel_order(second.order_id);
+
+    std::vector<char> image = take_snapshot(book);
+    OrderBook restored(test_book_config(GetParam()));
+    ASSERT_TRUE(restored.restore(image.data(), image.size()));
+
+    EXPECT_EQ(restored.total_orders(), book.total_orders());
+    EXPECT_EQ(restored.total_trades(), book.total_trades());
+    EXPECT_EQ(restored.total_volume(), book.total_volume());
+    EXPECT_EQ(restored.bid_depth(10), book.bid_depth(10));
+    EXPECT_EQ(restored.ask_depth(10), book.ask_depth(10));
+    EXPECT_EQ(restored.order_count_at_price(Side::Sell, to_price(101.00)), 2u);
+
+    // Sweep both books: same FIFO order, same new ID, same timestamps
+    auto live = book.add_order(Side::Buy, OrderType::Market, 0, 100);
+    auto again = restored.add_order(Side::Buy, OrderType::Market, 0, 100);
+    EXPECT_EQ(again.order_id, live.order_id);
+    ASSERT_EQ(again.trades.size(), 3u);
+    ASSERT_EQ(live.trades.size(), 3u);
+    EXPECT_EQ(again.trades[0].sell_order_id, first.order_id);
+    EXPECT_EQ(again.trades[0].quantity, 5u);
+    EXPECT_EQ(again.trades[1].sell_order_id, third.order_id);
+    for (std::size_t i = 0; i < 3; ++i) {
+        EXPECT_EQ(again.trades[i].sell_order_id, live.trades[i].sell_order_id);
+        EXPECT_EQ(again.trades[i].timestamp, live.trades[i].timestamp);
+    }
+
+    EXPECT_EQ(restored.total_orders(), book.total_orders());
+    EXPECT_FALSE(restored.cancel_order(first.order_id));  // filled by the sweep
+}
+
+TEST_P(SnapshotTest, RejectsUnusableImages) {
+    OrderBook book(test_book_config(GetParam()));
+    book.add_order(Side::Buy, OrderType::Limit, to_price(99.00), 40);
+    std::vector<char> image = take_snapshot(book);
+
+    char small[8];
+    EXPECT_EQ(book.snapshot(small, sizeof(small)), 0u);
+
+    // Target must be empty
+    EXPECT_FALSE(book.restore(image.data(), image.size()));
+
+    OrderBook target(test_book_config(GetParam()));
+    EXPECT_FALSE(target.restore(image.data(), image.size() - 1));
+
+    std::vector<char> bad = image;
+    bad[0] ^= 1;
+    EXPECT_FALSE(target.restore(bad.data(), bad.size()));
+
+    // Level storage must match the image
+    LevelStorage other = GetParam() == LevelStorage::Map ? LevelStorage::Ladder : LevelStorage::Map;
+    OrderBook mismatched(test_book_config(other));
+    EXPECT_FALSE(mismatched.restore(image.data(), image.size()));
+
+    EXPECT_TRUE(target.empty());
+    EXPECT_TRUE(target.restore(image.data(), image.size()));
+}
+
+TEST_P(SnapshotTest, DuplicateIdIsRejectedBeforeAnythingIsApplied) {
+    OrderBook book(test_book_config(GetParam()));
+    book.add_order(Side::Buy, OrderType::Limit, to_price(99.00), 40);
+    book.add_order(Side::Sell, OrderType::Limit, to_price(101.00), 10);
+    book.add_order(Side::Sell, OrderType::Limit, to_price(102.00), 20);
+    std::vector<char> image = take_snapshot(book);
+
+    // Give the last ask the bid's ID; every record is valid on its own
+    std::vector<char> bad = image;
+    char* records = bad.data() + sizeof(SnapshotHeader);
+    std::memcpy(records + 2 * sizeof(SnapshotOrder) + offsetof(SnapshotOrder, id),
+                records + offsetof(SnapshotOrder, id), sizeof(OrderId));
+
+    OrderBook target(test_book_config(GetParam()));
+    EXPECT_FALSE(target.restore(bad.data(), bad.size()));
+    EXPECT_TRUE(target.empty());
+    EXPECT_EQ(target.best_bid(), INVALID_PRICE);
+    EXPECT_EQ(target.best_ask(), INVALID_PRICE);
+    EXPECT_TRUE(target.ask_depth(10).empty());
+
+    ASSERT_TRUE(target.restore(image.data(), image.size()));
+    EXPECT_EQ(target.ask_depth(10), book.ask_depth(10));
+    EXPECT_EQ(target.bid_depth(10), book.bid_depth(10));
+}
+
+TEST_P(SnapshotTest, FileRoundTripAndTailReplay) {
+    std::string journal = temp_path("snapshot.journal");
+    std::string snap = temp_path("snapshot.image");
+    BookConfig config = test_book_config(GetParam());
+
+    JournaledBook live(journal, config, 20000);
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<Price> price_dist(to_price(99.00), to_price(101.00));
+    std::vector<OrderId> ids;
+    TradeBuffer trades;
+    auto drive = [&](int steps) {
+        for (int i = 0; i < steps; ++i) {
+            if (rng() % 3 != 0 || ids.empty()) {
+                Side side = rng() % 2 ? Side::Buy : Side::Sell;
+                OrderAck ack = live.add_order(side, OrderType::Limit, price_dist(rng),
+                                              1 + rng() % 50, trades);
+                trades.clear();
+                ids.push_back(ack.order_id);
+            } else {
+                live.cancel_order(ids[rng() % ids.size()]);
+            }
+        }
+    };
+
+    drive(3000);
+    ASSERT_TRUE(live.save_snapshot(snap));
+    drive(2000);
+    live.journal().sync();
+
+    JournalReader reader(journal);
+    OrderBook recovered(book_config_from(reader.header()));
+    EXPECT_EQ(recover(recovered, snap, reader), 2000u);
+
+    EXPECT_EQ(recovered.total_orders(), live.book().total_orders());
+    EXPECT_EQ(recovered.total_trades(), live.book().total_trades());
+    EXPECT_EQ(recovered.bid_depth(1000), live.book().bid_depth(1000));
+    EXPECT_EQ(recovered.ask_depth(1000), live.book().ask_depth(1000));
+    auto a = live.book().add_order(Side::Sell, OrderType::Limit, to_price(1.00), 7);
+    auto b = recovered.add_order(Side::Sell, OrderType::Limit, to_price(1.00), 7);
+    EXPECT_EQ(a.order_id, b.order_id);
+    EXPECT_EQ(a.status, b.status);
+
+    std::remove(journal.c_str());
+    std::remove(snap.c_str());
+}
+
+INSTANTIATE_TEST_SUITE_P(LevelStorage, SnapshotTest,
+                         ::testing::Values(LevelStorage::Map, LevelStorage::Ladder),
+                         level_storage_name);
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include "lob/spsc_ring.hpp"
+
+#include <thread>
+#include <cstdint>
+
+using namespace lob;
+
+TEST(SpscRingTest, CapacityRoundsUpToPowerOfTwo) {
+    SpscRing<std::uint64_t> ring(100);
+    EXPECT_EQ(ring.capacity(), 128u);
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(SpscRingTest, FifoUntilFull) {
+    SpscRing<std::uint64_t> ring(4);
+    for (std::uint64_t i = 0; i < 4; ++i) EXPECT_TRUE(ring.try_push(i));
+    EXPECT_FALSE(ring.try_push(99));
+    EXPECT_EQ(ring.size(), 4u);
+
+    std::uint64_t out = 0;
+    for (std::uint64_t i = 0; i < 4; ++i) {
+        ASSERT_TRUE(ring.try_pop(out));
+        EXPECT_EQ(out, i);
+    }
+    EXPECT_FALSE(ring.try_pop(out));
+}
+
+TEST(SpscRingTest, WrapsAround) {
+    SpscRing<std::uint64_t> ring(4);
+    std::uint64_t out = 0;
+    for (std::uint64_t i = 0; i < 100; ++i) {
+        ASSERT_TRUE(ring.try_push(i));
+        ASSERT_TRUE(ring.try_pop(out));
+        EXPECT_EQ(out, i);
+    }
+}
+
+TEST(SpscRingTest, IndicesOnSeparateCacheLines) {
+    EXPECT_GE(sizeof(SpscRing<std::uint64_t>), 3 * CACHE_LINE_SIZE);
+    EXPECT_EQ(alignof(SpscRing<std::uint64_t>), CACHE_LINE_SIZE);
+}
+
+TEST(SpscRingTest, ProducerConsumerThreadsSeeEveryItemInOrder) {
+    constexpr std::uint64_t COUNT = 200000;
+    SpscRing<std::uint64_t> ring(64);
+
+    std::thread producer([&] {
+        for (std::uint64_t i = 1; i <= COUNT; ++i) {
+            while (!ring.try_push(i)) std::this_thread::yield();
+        }
+    });
+
+    std::uint64_t expected = 1;
+    std::uint64_t value = 0;
+    while (expected <= COUNT) {
+        if (ring.try_pop(value)) {
+            ASSERT_EQ(value, expected);
+            ++expected;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    EXPECT_TRUE(ring.empty());
+}
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include "lob/order_book.hpp"
+#include "lob/telemetry.hpp"
+
+#include <thread>
+
+using namespace lob;
+
+TEST(LatencyHistogramTest, BucketsAreContinuousAndBounded) {
+    // Exact below 32, then every bucket's floor maps back to itself
+    for (std::uint64_t v = 0; v < 64; ++v) {
+        EXPECT_EQ(LatencyHistogram::bucket_of(v), v);
+    }
+    for (std::size_t b = 0; b < LatencyHistogram::BUCKETS; ++b) {
+        std::uint64_t floor = LatencyHistogram::bucket_floor(b);
+        ASSERT_EQ(LatencyHistogram::bucket_of(floor), b);
+        if (floor > 0) {
+            ASSERT_EQ(LatencyHistogram::bucket_of(floor - 1), b - 1);
+        }
+    }
+    EXPECT_EQ(LatencyHistogram::bucket_of(~std::uint64_t{0}), LatencyHistogram::BUCKETS - 1);
+
+    // Relative error stays within 1/32
+    for (std::uint64_t v : {100ull, 1000ull, 123456ull, 987654321ull}) {
+        std::uint64_t floor = LatencyHistogram::bucket_floor(LatencyHistogram::bucket_of(v));
+        EXPECT_LE(floor, v);
+        EXPECT_LE(static_cast<double>(v - floor), static_cast<double>(v) / 32.0);
+    }
+}
+
+TEST(LatencyHistogramTest, PercentilesAndMerge) {
+    LatencyHistogram h;
+    EXPECT_EQ(h.percentile(0.5), 0u);
+    for (std::uint64_t v = 1; v <= 1000; ++v) h.record(v);
+    EXPECT_EQ(h.count(), 1000u);
+    EXPECT_EQ(h.max(), 1000u);
+    EXPECT_EQ(h.percentile(0.0), 1u);
+    EXPECT_NEAR(static_cast<double>(h.percentile(0.5)), 500.0, 500.0 / 32);
+    EXPECT_NEAR(static_cast<double>(h.percentile(0.999)), 999.0, 999.0 / 32);
+    EXPECT_EQ(h.percentile(1.0), LatencyHistogram::bucket_floor(LatencyHistogram::bucket_of(1000)));
+
+    LatencyHistogram total;
+    h.add_to(total);
+    h.add_to(total);
+    EXPECT_EQ(total.count(), 2000u);
+    EXPECT_EQ(total.max(), 1000u);
+    EXPECT_EQ(total.percentile(0.5), h.percentile(0.5));
+}
+
+TEST(ProbeTest, TimersRecordIntoPerThreadSets) {
+    ProbeSet* own = thread_probes();
+    ASSERT_NE(own, nullptr);
+    EXPECT_EQ(thread_probes(), own);
+    std::uint64_t before = (*own)[ProbeStage::Match].count();
+    { ProbeTimer timer(ProbeStage::Match); }
+    EXPECT_EQ((*own)[ProbeStage::Match].count(), before + 1);
+
+    // Another thread gets its own set; the scraper sums both
+    ProbeSet* other = nullptr;
+    std::thread t([&] {
+        other = thread_probes();
+        for (int i = 0; i < 10; ++i) ProbeTimer timer(ProbeStage::Match);
+    });
+    t.join();
+    ASSERT_NE(other, nullptr);
+    EXPECT_NE(other, own);
+    EXPECT_EQ((*other)[ProbeStage::Match].count(), 10u);
+
+    ProbeSet total;
+    collect_probes(total);
+    EXPECT_GE(total[ProbeStage::Match].count(), before + 11);
+    EXPECT_GT(tsc_ns_per_tick(), 0.0);
+    EXPECT_STREQ(probe_stage_name(ProbeStage::CancelOrder), "cancel_order");
+}
+
+#ifdef LOB_ENABLE_PROBES
+TEST(ProbeTest, BookStagesAreInstrumented) {
+    ProbeSet& probes = *thread_probes();
+    std::uint64_t adds = probes[ProbeStage::AddOrder].count();
+    std::uint64_t matches = probes[ProbeStage::Match].count();
+    std::uint64_t cancels = probes[ProbeStage::CancelOrder].count();
+    std::uint64_t dispatches = probes[ProbeStage::Dispatch].count();
+
+    OrderBook book(1000);
+    auto resting = book.add_order(Side::Sell, OrderType::Limit, to_price(100.00), 10);
+    book.add_order(Side::Buy, OrderType::Limit, to_price(100.00), 4);
+    book.cancel_order(resting.order_id);
+
+    EXPECT_EQ(probes[ProbeStage::AddOrder].count(), adds + 2);
+    EXPECT_EQ(probes[ProbeStage::Match].count(), matches + 2);
+    EXPECT_EQ(probes[ProbeStage::CancelOrder].count(), cancels + 1);
+    // One trade plus three level updates: rest, fill, cancel
+    EXPECT_EQ(probes[ProbeStage::Dispatch].count(), dispatches + 4);
+}
+#endif
@@ -26,52 +26,51 @@ void test_order_pool() {
     TEST_ASSERT(pool.capacity() == 100, "capacity");
     TEST_ASSERT(pool.size() == 0, "initial size");
 
-    Order* o1 = pool.allocate();
-    TEST_ASSERT(o1 != nullptr, "allocate returns non-null");
+    OrderHandle o1 = pool.allocate();
+    TEST_ASSERT(o1 != NULL_HANDLE, "allocate returns valid handle");
     TEST_ASSERT(pool.size() == 1, "size after alloc");
 
     pool.deallocate(o1);
     TEST_ASSERT(pool.size() == 0, "size after dealloc");
 
     // Reuse
-    Order* o2 = pool.allocate();
+    OrderHandle o2 = pool.allocate();
     TEST_ASSERT(o1 == o2, "memory reuse");
 
     // Exhaust
     OrderPool small(2);
     small.allocate();
     small.allocate();
-    bool threw = false;
-    try { small.allocate(); } catch (...) { threw = true; }
-    TEST_ASSERT(threw, "throws on exhaustion");
+    TEST_ASSERT(small.allocate() == NULL_HANDLE, "null handle on exhaustion");
 }
 
 void test_price_level() {
     std::cout << "  PriceLevel...\n";
-    Order orders[3];
+    OrderPool pool(3);
+    OrderHandle orders[3];
     for (int i = 0; i < 3; ++i) {
-        orders[i].reset();
-        orders[i].id = static_cast<OrderId>(i + 1);
-        orders[i].quantity = 100;
+        orders[i] = pool.allocate();
+        pool[orders[i]].id = static_cast<OrderId>(i + 1);
+        pool[orders[i]].remaining = 100;
     }
 
     PriceLevel level(10000);
     TEST_ASSERT(level.empty(), "empty initially");
 
-    level.add_order(&orders[0]);
+    level.add_order(pool, orders[0]);
     TEST_ASSERT(!level.empty(), "not empty after add");
-    TEST_ASSERT(level.front() == &orders[0], "front is first added");
+    TEST_ASSERT(level.front() == orders[0], "front is first added");
     TEST_ASSERT(level.total_quantity == 100, "quantity tracking");
     TEST_ASSERT(level.order_count == 1, "order count");
 
-    level.add_order(&orders[1]);
-    level.add_order(&orders[2]);
-    TEST_ASSERT(level.front() == &orders[0], "FIFO: front stays");
+    level.add_order(pool, orders[1]);
+    level.add_order(pool, orders[2]);
+    TEST_ASSERT(level.front() == orders[0], "FIFO: front stays");
     TEST_ASSERT(level.total_quantity == 300, "total quantity 3 orders");
 
     // Remove middle
-    level.remove_order(&orders[1]);
-    TEST_ASSERT(level.front()->next == &orders[2], "middle removal links");
+    level.remove_order(pool, orders[1]);
+    TEST_ASSERT(pool[level.front()].next == orders[2], "middle removal links");
     TEST_ASSERT(level.order_count == 2, "count after remove");
     TEST_ASSERT(level.total_quantity == 200, "quantity after remove");
 }
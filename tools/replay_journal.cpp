@@ -0,0 +1,68 @@
+// Rebuild an order book from a journal file and report its state, with
+// the pool, index and level occupancy the run reached (for sizing
+// PoolConfig::capacity and the ladder band).
+// Usage: lob_replay <journal>
+
+#include "lob/journal.hpp"
+
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include <iomanip>
+
+using namespace lob;
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::cerr << "usage: " << argv[0] << " <journal>\n";
+        return 2;
+    }
+
+    try {
+        auto start = std::chrono::steady_clock::now();
+        JournalReader reader(argv[1]);
+        OrderBook book(book_config_from(reader.header()));
+        std::size_t applied = replay_journal(reader, book);
+        auto end = std::chrono::steady_clock::now();
+
+        double seconds = std::chrono::duration<double>(end - start).count();
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "records:       " << applied << "\n"
+                  << "resting:       " << book.total_orders() << " orders, "
+                  << book.bid_levels() << " bid / " << book.ask_levels() << " ask levels\n"
+                  << "best bid/ask:  " << to_double(book.best_bid()) << " / "
+                  << to_double(book.best_ask()) << "\n"
+                  << "trades:        " << book.total_trades() << " (volume "
+                  << book.total_volume() << ")\n"
+                  << "replay time:   " << seconds * 1000.0 << " ms ("
+                  << (seconds > 0 ? static_cast<double>(applied) / seconds / 1e6 : 0.0)
+                  << "M records/sec)\n";
+
+        OccupancyStats occupancy = book.occupancy_stats();
+        BookMemoryStats memory = book.memory_stats();
+        std::cout << "pool:          " << occupancy.pool_high_water << " peak of "
+                  << occupancy.pool_capacity << " slots\n"
+                  << "index:         load " << occupancy.index_load << ", probes mean "
+                  << occupancy.mean_probe << " max " << occupancy.max_probe << "\n"
+                  << "queue depth:   mean " << occupancy.mean_queue_depth << " max "
+                  << occupancy.max_queue_depth << "\n";
+        for (std::size_t b = 0; b < QUEUE_DEPTH_BUCKETS; ++b) {
+            if (occupancy.queue_depth[b] == 0) continue;
+            std::cout << "  " << std::setw(6) << (std::size_t{1} << b) << "+ orders: "
+                      << occupancy.queue_depth[b] << " levels\n";
+        }
+        std::cout << "bid span:      " << to_double(occupancy.bid_low) << " - "
+                  << to_double(occupancy.bid_high) << "\n"
+                  << "ask span:      " << to_double(occupancy.ask_low) << " - "
+                  << to_double(occupancy.ask_high) << "\n"
+                  << "memory:        " << static_cast<double>(memory.total()) / (1 << 20)
+                  << " MiB (pool " << static_cast<double>(memory.pool) / (1 << 20)
+                  << ", index " << static_cast<double>(memory.index) / (1 << 20) << ", levels "
+                  << static_cast<double>(memory.bid_levels + memory.ask_levels) / (1 << 20)
+                  << ")\n";
+    } catch (const std::exception& e) {
+        std::cerr << "replay failed: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}